@@ -1110,6 +1110,7 @@ if (NOT onnxruntime_ENABLE_TRAINING_TORCH_INTEROP)
       ${BENCHMARK_DIR}/batchnorm.cc
       ${BENCHMARK_DIR}/batchnorm2.cc
       ${BENCHMARK_DIR}/tptest.cc
+      ${BENCHMARK_DIR}/arena.cc
       ${BENCHMARK_DIR}/eigen.cc
       ${BENCHMARK_DIR}/copy.cc
       ${BENCHMARK_DIR}/gelu.cc
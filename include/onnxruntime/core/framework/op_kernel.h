@@ -129,6 +129,32 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to allow the pre-packed weights of the input to be stored in the persistent
+  // pre-packed weights cache of the session (see kOrtSessionOptionsEnablePrepackedWeightsCache), and
+  // UseCachedPrePackedBuffers() to use them on later loads of the model instead of calling PrePack().
+  // Only return true if the buffers produced by PrePack() for the input depend on nothing but the tensor, the
+  // attributes and input types of the node, and the features of the CPU.
+  virtual bool IsPrePackCacheable(int /*input_idx*/) const {
+    return false;
+  }
+
+  // Override this function to use pre-packed weights loaded from the persistent pre-packed weights cache.
+  // It is called instead of PrePack() for inputs IsPrePackCacheable() returns true for, and must leave the
+  // kernel in the same state as PrePack() would, using the provided buffers instead of packing the tensor.
+  // @param tensor: The constant initialized tensor the buffers were produced from
+  // @param prepacked_buffers: The buffers, in the order PrePack() stored them in PrePackedWeights. As with
+  //                           UseSharedPrePackedBuffers(), the deleter of each BufferUniquePtr is NULL.
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param used_cached_buffers: Boolean flag set by the kernel implementation indicating
+  // that the provided weight has been used by the kernel.
+  virtual Status UseCachedPrePackedBuffers(const Tensor& /*tensor*/,
+                                           std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                           int /*input_idx*/,
+                                           /*out*/ bool& used_cached_buffers) {
+    used_cached_buffers = false;
+    return Status::OK();
+  }
+
   const OrtDevice GetDevice(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
@@ -4,6 +4,7 @@
 #pragma once
 #include <unordered_set>
 #include <filesystem>
+#include <mutex>
 
 #include "core/graph/graph.h"
 #include "core/framework/session_options.h"
@@ -206,6 +207,11 @@ class GraphViewer {
 #if !defined(ORT_MINIMAL_BUILD)
   // The NodeIndex values of the graph nodes sorted in topological order with priority.
   std::vector<NodeIndex> nodes_in_topological_order_with_priority_;
+
+  // The NodeIndex values of the graph nodes sorted in a topological order reducing the peak size of the
+  // live tensors. Computed on first use as most GraphViewer instances never need it.
+  mutable std::vector<NodeIndex> nodes_in_memory_aware_topological_order_;
+  mutable std::once_flag nodes_in_memory_aware_topological_order_flag_;
 #endif
 
 #ifdef ENABLE_TRAINING
@@ -39,7 +39,9 @@
 #pragma warning(disable : 4127)
 #pragma warning(disable : 4805)
 #endif
+#include <algorithm>
 #include <memory>
+#include <vector>
 #include "unsupported/Eigen/CXX11/ThreadPool"
 
 #if defined(__GNUC__)
@@ -790,6 +792,8 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       ComputeCoprimes(i, &all_coprimes_.back());
     }
 
+    InitializeNumaNodes(thread_options.numa_nodes);
+
     // Eigen::MaxSizeVector has neither essential exception safety features
     // such as swap, nor it is movable. So we have to join threads right here
     // on exception
@@ -819,6 +823,11 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   void Schedule(std::function<void()> fn) override {
     PerThread* pt = GetPerThread();
     int q_idx = Rand(&pt->rand) % num_threads_;
+    if (IsNumaAware() && pt->pool == this) {
+      // Keep work spawned from a worker on that worker's NUMA node.
+      const auto& node_workers = numa_node_workers_[worker_numa_node_[pt->thread_id]];
+      q_idx = node_workers[Rand(&pt->rand) % node_workers.size()];
+    }
     WorkerData& td = worker_data_[q_idx];
     Queue& q = td.queue;
     fn = q.PushBack(std::move(fn));
@@ -1324,6 +1333,23 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return -1;
   }
 
+  // Return the number of NUMA nodes spanned by the workers, or 1 if
+  // the pool is not NUMA-aware.
+  int NumNumaNodes() const {
+    return IsNumaAware() ? static_cast<int>(numa_node_workers_.size()) : 1;
+  }
+
+  // Return the (dense) NUMA node of the current thread if it is a
+  // worker in this pool.  Threads outside the pool are attributed to
+  // node 0.
+  int CurrentNumaNode() const {
+    int thread_id = CurrentThreadId();
+    if (!IsNumaAware() || thread_id < 0) {
+      return 0;
+    }
+    return static_cast<int>(worker_numa_node_[thread_id]);
+  }
+
   void EnableSpinning() {
     spin_loop_status_ = SpinLoopStatus::kBusy;
   }
@@ -1349,6 +1375,38 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     }
   }
 
+  // Group the workers by NUMA node.  numa_nodes holds the node of
+  // each worker thread; it is either empty or has num_threads_
+  // entries.  Node ids are remapped to the dense range
+  // [0,NumNumaNodes()) in order of first appearance.  If the workers
+  // span a single node then the pool is not NUMA-aware.
+  void InitializeNumaNodes(const std::vector<int>& numa_nodes) {
+    if (numa_nodes.empty()) {
+      return;
+    }
+    ORT_ENFORCE(numa_nodes.size() == num_threads_, "Expected one NUMA node per worker thread");
+    std::vector<int> seen_nodes;
+    worker_numa_node_.reserve(num_threads_);
+    for (int node : numa_nodes) {
+      auto it = std::find(seen_nodes.begin(), seen_nodes.end(), node);
+      unsigned dense_node = static_cast<unsigned>(it - seen_nodes.begin());
+      if (it == seen_nodes.end()) {
+        seen_nodes.push_back(node);
+        numa_node_workers_.emplace_back();
+      }
+      numa_node_workers_[dense_node].push_back(static_cast<unsigned>(worker_numa_node_.size()));
+      worker_numa_node_.push_back(dense_node);
+    }
+    if (numa_node_workers_.size() <= 1) {
+      worker_numa_node_.clear();
+      numa_node_workers_.clear();
+    }
+  }
+
+  bool IsNumaAware() const {
+    return !numa_node_workers_.empty();
+  }
+
   typedef typename Environment::EnvThread Thread;
   struct WorkerData;
 
@@ -1498,6 +1556,12 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   std::atomic<unsigned> blocked_;  // Count of blocked workers, used as a termination condition
   std::atomic<bool> done_;
 
+  // NUMA grouping of the workers, empty unless the pool is NUMA-aware.
+  // worker_numa_node_ maps a worker index to its (dense) node index, and
+  // numa_node_workers_ lists the workers on each node.
+  std::vector<unsigned> worker_numa_node_;
+  std::vector<std::vector<unsigned>> numa_node_workers_;
+
   // SpinLoopStatus indicates whether the main worker spinning (inner) loop should exit immediately when there is
   // no work available (kIdle) or whether it should follow the configured spin-then-block policy (kBusy).
   // This lets the ORT session layer hint to the thread pool that it should stop spinning in between
@@ -1645,8 +1709,20 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   // "snatching" work from a thread which is just about to notice the
   // work itself.
 
+  //
+  // In a NUMA-aware pool, a worker first attempts to steal from the
+  // other workers on its own node, so that the stolen task's data is
+  // likely to be in node-local memory and in the shared last-level
+  // cache.  Only a TRY_ALL attempt then falls back to remote nodes.
+
   Task Steal(StealAttemptKind steal_kind) {
     PerThread* pt = GetPerThread();
+    if (IsNumaAware() && pt->pool == this) {
+      Task t = StealFromNode(worker_numa_node_[pt->thread_id], steal_kind);
+      if (t || steal_kind == StealAttemptKind::TRY_ONE) {
+        return t;
+      }
+    }
     unsigned size = num_threads_;
     unsigned num_attempts = (steal_kind == StealAttemptKind::TRY_ALL) ? size : 1;
     unsigned r = Rand(&pt->rand);
@@ -1670,6 +1746,33 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return Task();
   }
 
+  Task StealFromNode(unsigned node, StealAttemptKind steal_kind) {
+    PerThread* pt = GetPerThread();
+    const auto& node_workers = numa_node_workers_[node];
+    unsigned size = static_cast<unsigned>(node_workers.size());
+    unsigned num_attempts = (steal_kind == StealAttemptKind::TRY_ALL) ? size : 1;
+    unsigned r = Rand(&pt->rand);
+    unsigned inc = all_coprimes_[size - 1][r % all_coprimes_[size - 1].size()];
+    unsigned victim = r % size;
+
+    for (unsigned i = 0; i < num_attempts; i++) {
+      assert(victim < size);
+      WorkerData& td = worker_data_[node_workers[victim]];
+      if (td.GetStatus() == WorkerData::ThreadStatus::Active) {
+        Task t = td.queue.PopBack();
+        if (t) {
+          return t;
+        }
+      }
+      victim += inc;
+      if (victim >= size) {
+        victim -= size;
+      }
+    }
+
+    return Task();
+  }
+
   int NonEmptyQueueIndex() {
     PerThread* pt = GetPerThread();
     const unsigned size = static_cast<unsigned>(worker_data_.size());
@@ -377,6 +377,14 @@ class ThreadPool {
   // thread in the pool. Returns -1 otherwise.
   int CurrentThreadId() const;
 
+  // Returns the number of NUMA nodes the pool's threads are grouped into.  This
+  // is 1 unless ThreadOptions::numa_nodes places the threads on several nodes.
+  int NumNumaNodes() const;
+
+  // Returns the NUMA node index in [0, NumNumaNodes()) of the current thread.
+  // Threads outside the pool (including the thread entering a loop) belong to node 0.
+  int CurrentNumaNode() const;
+
   // Run fn with up to n degree-of-parallelism enlisting the thread pool for
   // help.  The degree-of-parallelism includes the caller, and so if n==1
   // then the function will run directly in the caller.  The fork-join
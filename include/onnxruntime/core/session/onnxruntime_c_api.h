@@ -2804,6 +2804,9 @@ struct OrtApi {
    *  Use -1 to allow ORT to choose the default 1GB for max_power_of_two_extend_bytes.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "front_cache_max_bytes": Largest allocation size served by a lock-free cache of recently freed small chunks
+   *  in front of the arena, so that most small allocations and frees don't take the arena lock.
+   *  Capped at 64KB. Chunks parked in the cache are reported as in use. Use 0 or -1 (the default) to disable it.
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -20,6 +20,17 @@
 // If the config value is set to "1" then the prepacking is disabled, otherwise prepacking is enabled (default value)
 static const char* const kOrtSessionOptionsConfigDisablePrepacking = "session.disable_prepacking";
 
+// Key for enabling the persistent cache of pre-packed weights.
+// If the config value is set to "1", the weights pre-packed by CPU kernels supporting it are saved to the file
+// "<model path>.prepacked" next to the model, and later sessions of the model use the saved weights instead of
+// pre-packing them again. The file is memory mapped, so processes using the same model share the pre-packed weights.
+// It is rewritten if it was created by another version of onnxruntime or on a CPU with other features.
+// It is not used if the model is not loaded from a file, or for initializers shared between sessions.
+// Option values:
+// - "0": pre-pack weights on every load of the model. [DEFAULT]
+// - "1": use the persistent cache of pre-packed weights.
+static const char* const kOrtSessionOptionsEnablePrepackedWeightsCache = "session.enable_prepacked_weights_cache";
+
 // A value of "1" means allocators registered in the env will be used. "0" means the allocators created in the session
 // will be used. Use this to override the usage of env allocators on a per session level.
 static const char* const kOrtSessionOptionsConfigUseEnvAllocators = "session.use_env_allocators";
@@ -111,6 +122,16 @@ static const char* const kOrtSessionOptionsDisableSpecifiedOptimizers = "optimiz
 // Using device allocators means the memory allocation is made using malloc/new.
 static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "session.use_device_allocator_for_initializers";
 
+// Initializers on CPU with data in an external file point directly to the memory mapped file, which saves the copy at
+// load time, and lets processes loading the same model share the pages of the file.
+// Data whose offset in the file is not a multiple of its element size is always copied, as the tensor would be
+// misaligned otherwise.
+// Option values:
+// - "1": map external data of initializers on CPU into memory where possible. [DEFAULT]
+// - "0": copy external data of initializers on CPU into buffers of the allocator,
+//        e.g. if the model is on a file system where page faults are slow.
+static const char* const kOrtSessionOptionsMmapExternalInitializers = "session.mmap_external_initializers";
+
 // Configure whether to allow the inter_op/intra_op threads spinning a number of times before blocking
 // "0": thread will block if found no job to run
 // "1": default, thread will spin a number of times before blocking
@@ -214,6 +235,42 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 //    Hence 64-65 is an invalid configuration, because a windows thread cannot be attached to processors across group boundary.
 static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
 
+// This option makes the intra op thread pool NUMA-aware on multi-socket machines.
+// Threads are grouped by the NUMA node of the logical processors they are attached to. Idle threads then prefer
+// stealing work from threads on the same node, and parallel loops give each node a contiguous share of the iterations.
+// Threads must be attached to processors for the grouping to be known: the affinities given by
+// session.intra_op_thread_affinities are used, otherwise each thread is attached to one physical core.
+// If the node of a thread cannot be determined, or all threads are on one node, the option has no effect.
+// Option values:
+// - "0": NUMA-aware intra op thread pool is disabled. [DEFAULT]
+// - "1": NUMA-aware intra op thread pool is enabled.
+static const char* const kOrtSessionOptionsConfigIntraOpNumaAware = "session.intra_op.numa_aware";
+
+// Memory patterns (see SessionOptions enable_mem_pattern) are cached per set of input shapes. For models with
+// dynamic input dims, e.g. a variable sequence length, most runs then miss the cache.
+// This option rounds every input dim up to a power of 2 when looking up the cache, so that one memory pattern is
+// shared by all the input shapes of a bucket. Tensors may then be placed in a larger block than they need, and the
+// pattern of a bucket grows when a run in the bucket needs larger blocks than the ones it has.
+// Option values:
+// - "0": memory patterns are cached per exact input shapes. [DEFAULT]
+// - "1": memory patterns are cached per bucket of input shapes.
+static const char* const kOrtSessionOptionsConfigMemoryPatternShapeBucketing = "session.memory_pattern_shape_bucketing";
+
+// Maximum number of memory patterns cached by a session (and by each of its subgraphs).
+// When the limit is reached, the least recently used memory pattern is evicted.
+// The default is "0", which means no limit.
+static const char* const kOrtSessionOptionsConfigMemoryPatternMaxCacheSize = "session.memory_pattern_max_cache_size";
+
+// Use the thread pools of the session to deserialize the initializers, create the kernels and pre-pack the weights
+// of the CPU execution provider in parallel during session initialization. The inter op thread pool is used if the
+// session has one, otherwise the intra op thread pool.
+// The result is the same as with serial initialization, but the constructors and PrePack() methods of the CPU kernels,
+// including the ones of custom ops, must be safe to call concurrently for different nodes.
+// Option values:
+// - "0": initialize the session serially. [DEFAULT]
+// - "1": initialize the session in parallel.
+static const char* const kOrtSessionOptionsConfigParallelInitialization = "session.parallel_initialization";
+
 // This option will dump out the model to assist debugging any issues with layout transformation,
 // and is primarily intended for developer usage. It is only relevant if an execution provider that requests
 // NHWC layout is enabled such as NNAPI, XNNPACK or QNN.
@@ -279,3 +336,58 @@ static const char* const kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 = "mlas
 // Refer to MatMulNBits op schema for more details.
 // If not provided, default is 4.
 static const char* const kOrtSessionOptionsQDQMatMulNBitsAccuracyLevel = "session.qdq_matmulnbits_accuracy_level";
+
+// Number of rows the CPU TreeEnsembleRegressor and TreeEnsembleClassifier evaluate against a tree before moving
+// to the next tree when the rows are split across threads. The nodes of a tree stay in cache for the block.
+// Default is 8, "1" evaluates every row against all the trees before the next row. Ensembles evaluated with
+// QuickScorer (a single comparison mode, no missing value tracks and at most 64 leaves per tree) go through all the
+// trees for one row at a time, the block only sets the number of rows sharing a buffer of leaf bitvectors.
+static const char* const kOrtSessionOptionsTreeEnsembleRowBlockSize = "session.tree_ensemble_row_block_size";
+
+// Runs the nodes in a topological order reducing the peak size of the intermediate tensors alive at the same time,
+// which the allocation planner and the memory pattern then follow. Equivalent to ExecutionOrder::MEMORY_AWARE.
+// Option values:
+// - "0": Use the execution order of the session options. [DEFAULT]
+// - "1": Use the memory aware execution order.
+static const char* const kOrtSessionOptionsConfigMemoryAwareExecutionOrder = "session.memory_aware_execution_order";
+
+// Budget in bytes for the estimated peak size of the intermediate tensors alive at the same time during inference.
+// When exceeded, values produced by cheap operators are recomputed right before their late consumers instead of
+// staying alive across the peak. The sizes are estimated from the shapes once the graph is optimized.
+// The default execution order is replaced by the priority based one, which schedules the recomputation late.
+// Default is "0", which disables the recomputation.
+static const char* const kOrtSessionOptionsConfigActivationMemoryBudget = "session.activation_memory_budget";
+
+// Adds the cycles, instructions and last level cache misses of the thread running each kernel to the kernel events of
+// the profiler, read from the Linux perf_event interface. The counters unavailable on the platform are omitted.
+// The kernel events always carry the estimated number of operations ("flops") and its ratio to the bytes of the
+// inputs and outputs ("arithmetic_intensity") for the operators the estimation handles.
+// Option values:
+// - "0": Disable the hardware counters. [DEFAULT]
+// - "1": Enable the hardware counters.
+static const char* const kOrtSessionOptionsConfigProfileHardwareCounters = "session.profile_hardware_counters";
+
+// Captures the kernel calls of a CPU only session once its memory pattern is traced, and replays them on the next runs
+// with the same input names, shapes and types without going through the executor, like a CUDA graph.
+// The session must have all its nodes on the CPU execution provider and no control flow nodes, and the outputs of
+// its kernels must only depend on the shapes of the inputs. Graphs with sequence or map values are not captured.
+// Runs with other shapes go through the executor. The option is ignored in builds without exceptions.
+// Option values:
+// - "0": Disable the CPU graph capture. [DEFAULT]
+// - "1": Enable the CPU graph capture.
+static const char* const kOrtSessionOptionsConfigEnableCpuGraphCapture = "session.enable_cpu_graph_capture";
+
+// Maximum number of runs submitted with InferenceSession::SubmitRun the session executes at the same time. The other
+// submitted runs wait in a queue instead of occupying a thread each.
+// Default is "0", which uses the number of threads of the thread pool executing the submitted runs.
+static const char* const kOrtSessionOptionsConfigMaxConcurrentAsyncRuns = "session.max_concurrent_async_runs";
+
+// Loop and Scan nodes on the CPU execution provider run the iterations of their body concurrently when no value
+// flows from one iteration to the next. The loop carried values must pass through the body unchanged, and the Loop
+// condition must stay true. The iterations run on the inter-op thread pool, or on the intra-op one in sequential
+// execution mode. Bodies that draw random numbers always run one iteration at a time.
+// Option values:
+// - "0": Run independent iterations concurrently. [DEFAULT]
+// - "1": Run the iterations one at a time.
+static const char* const kOrtSessionOptionsConfigDisableConcurrentSubgraphIterations =
+    "session.disable_concurrent_subgraph_iterations";
@@ -121,6 +121,10 @@ struct GroupQueryAttentionParameters {
   AttentionQkvFormat past_kv_format;
   int zeros_count;
   int* zero_ptr;
+  bool is_paged_kv_cache;       // past and present kv are caches of blocks given by a block table
+  int kv_cache_block_size;      // number of tokens in a block of the paged kv cache
+  int num_kv_cache_blocks;      // number of blocks in the paged kv cache
+  int max_blocks_per_sequence;  // number of blocks in each row of the block table
 };
 
 // Parameters for sparse attention.
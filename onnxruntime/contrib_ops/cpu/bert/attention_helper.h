@@ -3,10 +3,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <limits>
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/common/safeint.h"
+#include "core/framework/allocator.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/mlas/inc/mlas.h"
@@ -202,5 +204,83 @@ T* ConcatStateChunkGQA(const T* past,
   return start;
 }
 
+// Runs the MLAS flash attention with the shapes and inputs set in args. The block sizes are chosen from the L2 cache
+// size and the scratch buffer of the threads is allocated here.
+inline void RunFlashAttention(MlasFlashAttentionThreadedArgs& args, int l2_cache_size, AllocatorPtr allocator,
+                              ThreadPool* tp) {
+  /*
+    q_block_size, kv_block_size correspond to Br, Bc in the FlashAttention paper.
+    Let M = l2_cache_size / sizeof(float)
+    In the FlashAttention kernel, there are 5 big matrices that we need to keep in L2 cache:
+      slice of Q -- [Br, qk_head_size]
+      slice of K -- [Bc, qk_head_size]
+      slice of V -- [Bc, v_head_size]
+      result of QK -- [Br, Bc]
+      temporary output (same shape as QKV) -- [Br, v_head_size]
+    The total size of these matrices is (Br + Bc) * (qk_head_size + v_head_size) + Br * Bc
+    By taking Bc = M / (4 * (qk_head_size + v_head_size)), and Br = min(Bc, qk_head_size + v_head_size), we have
+      (Br + Bc) * (qk_head_size + v_head_size) + Br * Bc
+      <= 2 * Bc * (qk_head_size + v_head_size) + Br * Bc
+      <= 2 * Bc * (qk_head_size + v_head_size) + M/4
+      <= 2 * M/4 + M/4 = M * (3/4)
+
+    We leave 1/4 of the L2 cache for
+      1. storing small tensors l and m
+      2. instruction (code)
+  */
+  args.kv_block_size = l2_cache_size / (static_cast<int>(sizeof(float)) * 4 * (args.qk_head_size + args.v_head_size));
+  args.kv_block_size = std::max(args.kv_block_size, 1);  // avoid kv_block_size = 0
+  args.q_block_size = std::min(args.kv_block_size, args.qk_head_size + args.v_head_size);
+  // No point to have kv_block_size > kv_sequence_length or q_block_size > q_sequence_length
+  args.kv_block_size = std::min(args.kv_block_size, args.kv_sequence_length);
+  args.q_block_size = std::min(args.q_block_size, args.q_sequence_length);
+
+  args.thread_count = ThreadPool::DegreeOfParallelism(tp);
+  args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
+                                 static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.kv_block_size) +
+                                 static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.v_head_size)) *
+                                sizeof(float);
+  size_t buffer_bytes = args.buffer_size_per_thread * args.thread_count;
+  IAllocatorUniquePtr<void> buffer = IAllocator::MakeUniquePtr<void>(allocator, buffer_bytes);
+  args.buffer = reinterpret_cast<float*>(buffer.get());
+
+  MlasFlashAttention(&args, tp);
+}
+
+// Int8 version of ConcatStateChunkGQA: the input state chunk is quantized with the (symmetric) scale of its head
+// while it is appended to the past state chunk.
+inline int8_t* ConcatQuantizedStateChunkGQA(const int8_t* past,
+                                            const float* chunk,
+                                            int8_t* present,
+                                            size_t present_buff_chunk_length,
+                                            size_t past_buff_chunk_length,
+                                            size_t past_chunk_length,
+                                            size_t new_chunk_length,
+                                            bool is_prompt,
+                                            bool past_present_share_buffer,
+                                            std::ptrdiff_t i,
+                                            float scale) {
+  int8_t* start = present + i * present_buff_chunk_length;
+
+  int8_t* p = start;
+  if (!is_prompt) {
+    if (!past_present_share_buffer) {
+      const int8_t* src_past = past + i * past_buff_chunk_length;
+      memcpy(p, src_past, past_chunk_length);
+    }
+    p += past_chunk_length;
+  }
+
+  MlasQuantizeLinear<int8_t>(chunk, p, new_chunk_length, scale, static_cast<int8_t>(0));
+  return start;
+}
+
+// Dequantize an int8 state chunk of the KV cache into a float buffer so it can be fed to the GEMMs.
+inline void DequantizeStateChunk(const int8_t* src, float* dst, size_t length, float scale) {
+  for (size_t i = 0; i < length; i++) {
+    dst[i] = static_cast<float>(src[i]) * scale;
+  }
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
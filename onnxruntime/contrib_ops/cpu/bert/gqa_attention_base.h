@@ -6,10 +6,15 @@
 #include "contrib_ops/cpu/bert/attention_base.h"
 #include "contrib_ops/cpu/bert/attention_helper.h"
 
+#include <type_traits>
+#include <vector>
+
 #include "core/common/common.h"
 #include "contrib_ops/cpu/bert/attention_common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/env.h"
+#include "core/platform/env_var_utils.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -31,6 +36,9 @@ class GQAAttentionBase {
     rotary_interleaved_ = info.GetAttrOrDefault<int64_t>("rotary_interleaved", 0) == 1;
 
     local_window_size_ = has_local ? static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1)) : -1;
+
+    l2_cache_size_ = Env::Default().GetL2CacheSize();
+    disable_flash_ = ParseEnvironmentVariableWithDefault<bool>(attention::kDisableFlashAttention, false);
   }
 
   int num_heads_;     // number of attention heads of Q
@@ -39,8 +47,12 @@ class GQAAttentionBase {
   bool do_rotary_;    // whether or not to use rotary embeddings
   bool rotary_interleaved_;
   int local_window_size_;
+  int l2_cache_size_;
+  bool disable_flash_;
 
-  template <typename T>
+  // The KV cache (past/present) is either of type T or int8 (TCache = int8_t, T = float). An int8 KV cache is
+  // quantized with the symmetric per KV head scales k_scales/v_scales and dequantized on the fly.
+  template <typename T, typename TCache = T>
   Status ApplyAttention(const T* Q,                                 // Q data with shape BxNxSxH
                         const T* K,                                 // K data with shape BxN_kvxSxH
                         const T* V,                                 // V data with shape BxN_kvxSxH
@@ -52,7 +64,9 @@ class GQAAttentionBase {
                         const Tensor* seqlens_k,                    // past sequence lengths tensor
                         GroupQueryAttentionParameters& parameters,  // attention parameters
                         AllocatorPtr allocator,                     // allocator for temporary tensors
-                        OpKernelContext* context) const {
+                        OpKernelContext* context,
+                        const float* k_scales = nullptr,  // scales of the int8 K cache with size N_kv
+                        const float* v_scales = nullptr) const {  // scales of the int8 V cache with size N_kv
     const int batch_size = parameters.batch_size;
     const int sequence_length = parameters.sequence_length;
     const int head_size = parameters.head_size;
@@ -67,38 +81,291 @@ class GQAAttentionBase {
     }
     int seqlen_present_kv_cache = static_cast<int>(present_key->Shape().GetDims()[2]);
 
+    const TCache* past_key_data = past_key != nullptr ? past_key->Data<TCache>() : nullptr;
+    TCache* present_key_data = present_key != nullptr ? present_key->MutableData<TCache>() : nullptr;
+    const TCache* past_value_data = past_value != nullptr ? past_value->Data<TCache>() : nullptr;
+    TCache* present_value_data = present_value != nullptr ? present_value->MutableData<TCache>() : nullptr;
+
+    bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
+
+    const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
+    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
+
+    // The prompt uses the flash attention, which does not materialize the attention probs of the whole sequence.
+    if constexpr (std::is_same_v<T, float> && std::is_same_v<T, TCache>) {
+      if (!disable_flash_ && l2_cache_size_ > 0 && local_window_size_ <= 0 && sequence_length > 1) {
+        ApplyFlashAttention(Q, k, v, seqlens_k->Data<int32_t>(), output->MutableData<T>(), batch_size,
+                            sequence_length, seqlen_present_kv_cache, head_size, present_key_data, present_value_data,
+                            past_present_share_buffer, packed_qkv, allocator, tp);
+        return Status::OK();
+      }
+    }
+
     // Compute the attention score.
     size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(T);
     auto attention_probs = allocator->Alloc(bytes);
     BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
 
-    const T* past_key_data = past_key != nullptr ? past_key->Data<T>() : nullptr;
-    T* present_key_data = present_key != nullptr ? present_key->MutableData<T>() : nullptr;
-    const T* past_value_data = past_value != nullptr ? past_value->Data<T>() : nullptr;
-    T* present_value_data = present_value != nullptr ? present_value->MutableData<T>() : nullptr;
+    ComputeAttentionProbs<T, TCache>(static_cast<T*>(attention_probs), Q, k, seqlens_k->Data<int32_t>(), batch_size,
+                                     sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size,
+                                     past_key_data, present_key_data, k_scales, past_present_share_buffer, packed_qkv,
+                                     tp);
 
-    bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
+    // Compute the attentionScore * Value: out(B, N, S, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
+    ComputeVxAttentionScore<T, TCache>(output->MutableData<T>(), static_cast<T*>(attention_probs), v,
+                                       seqlens_k->Data<int32_t>(), batch_size, sequence_length, seqlen_past_kv_cache,
+                                       seqlen_present_kv_cache, head_size, hidden_size, past_value_data,
+                                       present_value_data, v_scales, past_present_share_buffer, packed_qkv, tp);
 
-    const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
-    ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, k, seqlens_k->Data<int32_t>(), batch_size,
-                             sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size, past_key_data,
-                             present_key_data, past_present_share_buffer, packed_qkv, tp);
+    return Status::OK();
+  }
 
-    // Compute the attentionScore * Value: out(B, N, S, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
-    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
-    ComputeVxAttentionScore(output->MutableData<T>(), static_cast<T*>(attention_probs), v, seqlens_k->Data<int32_t>(),
-                            batch_size, sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size,
-                            hidden_size, past_value_data, present_value_data, past_present_share_buffer, packed_qkv,
-                            tp);
+  // Attention with a paged KV cache: the keys and values of the tokens of a sequence are stored in fixed size blocks
+  // of the past/present KV cache, the block_table giving the blocks of each sequence in order.
+  // The KV of the new tokens is written to the blocks of present_key/present_value before computing the attention.
+  template <typename T, typename TCache = T>
+  Status ApplyPagedAttention(const T* Q,                                 // Q data with shape BxNxSxH
+                             const T* K,                                 // K data with shape BxN_kvxSxH
+                             const T* V,                                 // V data with shape BxN_kvxSxH
+                             const Tensor* past_key,                     // past K cache with shape Bl x N_kv x Bs x H
+                             const Tensor* past_value,                   // past V cache with shape Bl x N_kv x Bs x H
+                             Tensor* output,                             // output tensor
+                             Tensor* present_key,                        // present K cache, same shape as past_key
+                             Tensor* present_value,                      // present V cache, same shape as past_value
+                             const Tensor* seqlens_k,                    // past sequence lengths tensor
+                             const Tensor* block_table,                  // blocks of each sequence with shape B x M
+                             GroupQueryAttentionParameters& parameters,  // attention parameters
+                             AllocatorPtr allocator,                     // allocator for temporary tensors
+                             OpKernelContext* context,
+                             const float* k_scales = nullptr,  // scales of the int8 K cache with size N_kv
+                             const float* v_scales = nullptr) const {  // scales of the int8 V cache with size N_kv
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int hidden_size = parameters.hidden_size;
+    const int block_size = parameters.kv_cache_block_size;
+    const int max_blocks_per_sequence = parameters.max_blocks_per_sequence;
+    // the attention probs of a sequence are laid out as if its blocks were contiguous
+    const int max_sequence_length = max_blocks_per_sequence * block_size;
+    const bool packed_qkv = parameters.is_packed_qkv;
+    const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+    const int32_t* block_table_data = block_table->Data<int32_t>();
+
+    auto* tp = context->GetOperatorThreadPool();
+
+    constexpr bool quantized_kv_cache = !std::is_same_v<T, TCache>;
+    TCache* present_key_data = present_key->MutableData<TCache>();
+    TCache* present_value_data = present_value->MutableData<TCache>();
+    if (past_key->DataRaw() != present_key->DataRaw()) {
+      memcpy(present_key_data, past_key->Data<TCache>(), past_key->SizeInBytes());
+    }
+    if (past_value->DataRaw() != present_value->DataRaw()) {
+      memcpy(present_value_data, past_value->Data<TCache>(), past_value->SizeInBytes());
+    }
+
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;  // S x H
+    const size_t block_chunk_length = static_cast<size_t>(block_size) * head_size;         // Bs x H
+
+    // Returns the first row of the head in the block holding the token of the sequence
+    auto block_chunk = [&](TCache* cache, int batch_index, int kv_head_index, int token) -> TCache* {
+      const int block = block_table_data[SafeInt<ptrdiff_t>(batch_index) * max_blocks_per_sequence + token / block_size];
+      return cache + (SafeInt<ptrdiff_t>(block) * kv_num_heads_ + kv_head_index) * block_chunk_length;
+    };
+
+    // Write the KV of the new tokens to the cache. For the prompt, the past sequence length is 0
+    // and the padding tokens after seqlens_k + 1 are not written.
+    ThreadPool::TrySimpleParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_, [&](std::ptrdiff_t i) {
+      const int batch_index = static_cast<int>(i / kv_num_heads_);
+      const int kv_head_index = static_cast<int>(i % kv_num_heads_);
+      const int past_seqlen = sequence_length == 1 ? static_cast<int>(seqlens_k_data[batch_index]) : 0;
+      const int new_seqlen = sequence_length == 1 ? 1 : static_cast<int>(seqlens_k_data[batch_index]) + 1;
+
+      const T* k;
+      const T* v;
+      if (packed_qkv) {
+        k = Q + packed_batch_stride * batch_index + kv_input_chunk_length * (num_heads_ + kv_head_index);
+        v = k + kv_input_chunk_length * kv_num_heads_;
+      } else {
+        k = K + kv_input_chunk_length * i;
+        v = V + kv_input_chunk_length * i;
+      }
+
+      for (int seq = 0; seq < new_seqlen; seq++) {
+        const int token = past_seqlen + seq;
+        const ptrdiff_t offset = static_cast<ptrdiff_t>(token % block_size) * head_size;
+        TCache* k_dst = block_chunk(present_key_data, batch_index, kv_head_index, token) + offset;
+        TCache* v_dst = block_chunk(present_value_data, batch_index, kv_head_index, token) + offset;
+        if constexpr (quantized_kv_cache) {
+          MlasQuantizeLinear<int8_t>(k + static_cast<ptrdiff_t>(seq) * head_size, k_dst, head_size,
+                                     k_scales[kv_head_index], static_cast<int8_t>(0));
+          MlasQuantizeLinear<int8_t>(v + static_cast<ptrdiff_t>(seq) * head_size, v_dst, head_size,
+                                     v_scales[kv_head_index], static_cast<int8_t>(0));
+        } else {
+          memcpy(k_dst, k + static_cast<ptrdiff_t>(seq) * head_size, head_size * sizeof(T));
+          memcpy(v_dst, v + static_cast<ptrdiff_t>(seq) * head_size, head_size * sizeof(T));
+        }
+      }
+    });
+
+    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * max_sequence_length * sizeof(T);
+    auto attention_probs = allocator->Alloc(bytes);
+    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+
+    const int kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const size_t q_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;  // S x H
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+
+    TensorOpCost unit_cost;
+    const ptrdiff_t probs_matrix_bytes = SafeInt<ptrdiff_t>(sequence_length) * max_sequence_length * sizeof(T);
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(4) * sequence_length * head_size * max_sequence_length);
+    unit_cost.bytes_loaded = static_cast<double>(sequence_length * head_size * sizeof(T) +
+                                                 2 * max_sequence_length * head_size * sizeof(TCache) +
+                                                 probs_matrix_bytes);
+    unit_cost.bytes_stored = static_cast<double>(sequence_length * head_size * sizeof(T) + probs_matrix_bytes);
+
+    // Each head computes its attention probs and multiplies them with V, block by block.
+    ThreadPool::TryParallelFor(
+        tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          // the blocks of an int8 KV cache are dequantized here before the GEMMs
+          std::vector<T> block_dequant(quantized_kv_cache ? block_chunk_length : 0);
+          auto block_data = [&](TCache* cache, const float* scales, int batch_index, int kv_head_index,
+                                int token, int block_tokens) -> const T* {
+            const TCache* block = block_chunk(cache, batch_index, kv_head_index, token);
+            if constexpr (quantized_kv_cache) {
+              DequantizeStateChunk(block, block_dequant.data(), static_cast<size_t>(block_tokens) * head_size,
+                                   scales[kv_head_index]);
+              return block_dequant.data();
+            } else {
+              ORT_UNUSED_PARAMETER(scales);
+              ORT_UNUSED_PARAMETER(block_tokens);
+              return block;
+            }
+          };
+
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            const int batch_index = static_cast<int>(i / num_heads_);
+            const int head_index = static_cast<int>(i % num_heads_);
+            const int kv_head_index = head_index / kv_num_heads_factor;
+            const int total_seqlen = seqlens_k_data[batch_index] + 1;
+
+            const T* q;
+            if (packed_qkv) {
+              q = Q + packed_batch_stride * batch_index + q_input_chunk_length * head_index;
+            } else {
+              q = Q + q_input_chunk_length * i;
+            }
+
+            T* probs = static_cast<T*>(attention_probs) + SafeInt<ptrdiff_t>(i) * sequence_length * max_sequence_length;
+            for (int token = 0; token < total_seqlen; token += block_size) {
+              const int block_tokens = std::min(block_size, total_seqlen - token);
+              math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, block_tokens, head_size, alpha, q,
+                                          head_size,
+                                          block_data(present_key_data, k_scales, batch_index, kv_head_index, token,
+                                                     block_tokens),
+                                          head_size, 0.0f /*beta*/, probs + token, max_sequence_length, nullptr);
+            }
+
+            ComputeCausalSoftmax(probs, sequence_length, total_seqlen, max_sequence_length);
+
+            T* output_current = output->MutableData<T>() +
+                                (SafeInt<ptrdiff_t>(batch_index) * sequence_length * num_heads_ + head_index) * head_size;
+            for (int token = 0; token < total_seqlen; token += block_size) {
+              const int block_tokens = std::min(block_size, total_seqlen - token);
+              math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, block_tokens,
+                                          1.f /*alpha*/, probs + token, max_sequence_length,
+                                          block_data(present_value_data, v_scales, batch_index, kv_head_index, token,
+                                                     block_tokens),
+                                          head_size,
+                                          token == 0 ? 0.0f : 1.0f /*beta*/, output_current, hidden_size, nullptr);
+            }
+          }
+        });
 
     return Status::OK();
   }
 
  private:
+  // Flash attention for the prompt: the new K and V are written to present, which is the key and value of a causal
+  // attention over the seqlens_k + 1 tokens of each sequence.
+  void ApplyFlashAttention(const float* Q,                      // Q data with shape BxNxSxH
+                           const float* K,                      // K data with shape BxN_kvxSxH
+                           const float* V,                      // V data with shape BxN_kvxSxH
+                           const int32_t* seqlens_k,            // past sequence lengths tensor
+                           float* output,                       // output with shape BxSxNxH
+                           int batch_size,                      // batch size of self-attention
+                           int sequence_length,                 // sequence length of self-attention (S)
+                           int present_buffer_sequence_length,  // sequence length of present state
+                           int head_size,                       // head size of self-attention
+                           float* present_key,                  // present key
+                           float* present_value,                // present value
+                           bool past_present_share_buffer,      // whether present key and value share the same buffer
+                           bool packed_qkv,                     // whether Q, K, V are packed
+                           AllocatorPtr allocator,              // allocator for the scratch buffer
+                           ThreadPool* tp) const {              // thread pool
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;                     // S x H
+    const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
+
+    if (!past_present_share_buffer) {
+      const size_t present_bytes = SafeInt<size_t>(batch_size) * kv_num_heads_ * present_buff_chunk_length *
+                                   sizeof(float);
+      memset(present_key, 0, present_bytes);
+      memset(present_value, 0, present_bytes);
+    }
+
+    ThreadPool::TrySimpleParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_, [&](std::ptrdiff_t i) {
+      const std::ptrdiff_t batch_index = i / kv_num_heads_;
+      const std::ptrdiff_t kv_head_index = i % kv_num_heads_;
+      const float* k;
+      const float* v;
+      if (packed_qkv) {
+        k = K + packed_batch_stride * batch_index + kv_input_chunk_length * kv_head_index;
+        v = V + packed_batch_stride * batch_index + kv_input_chunk_length * kv_head_index;
+      } else {
+        k = K + kv_input_chunk_length * i;
+        v = V + kv_input_chunk_length * i;
+      }
+      ConcatStateChunkGQA<float>(nullptr, k, present_key, present_buff_chunk_length, 0, 0, kv_input_chunk_length,
+                                 true /*is_prompt*/, past_present_share_buffer, i);
+      ConcatStateChunkGQA<float>(nullptr, v, present_value, present_buff_chunk_length, 0, 0, kv_input_chunk_length,
+                                 true /*is_prompt*/, past_present_share_buffer, i);
+    });
+
+    std::vector<int> total_seqlens(batch_size);
+    for (int b = 0; b < batch_size; b++) {
+      total_seqlens[b] = seqlens_k[b] + 1;
+    }
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = batch_size;
+    args.num_heads = num_heads_;
+    args.kv_num_heads = kv_num_heads_;
+    args.q_sequence_length = sequence_length;
+    args.kv_sequence_length = present_buffer_sequence_length;
+    args.kv_sequence_lengths = total_seqlens.data();
+    args.qk_head_size = head_size;
+    args.v_head_size = head_size;
+    args.scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    args.is_causal = true;
+    args.query = Q;
+    args.query_batch_stride = static_cast<size_t>(packed_batch_stride);
+    args.key = present_key;
+    args.value = present_value;
+    args.output = output;
+
+    RunFlashAttention(args, l2_cache_size_, allocator, tp);
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
-  template <typename T>
+  template <typename T, typename TCache>
   void ComputeAttentionProbs(T* attention_probs,                  // output buffer with size BxNxSxT
                              const T* Q,                          // Q data. Its size is BxNxSxH
                              const T* K,                          // k data. Its size is BxNxLxH
@@ -108,8 +375,9 @@ class GQAAttentionBase {
                              int past_buffer_sequence_length,     // sequence length of past state
                              int present_buffer_sequence_length,  // sequence length of present state
                              int head_size,                       // head size of self-attention
-                             const T* past_key,                   // past key only
-                             T* present_key,                      // present key only
+                             const TCache* past_key,              // past key only
+                             TCache* present_key,                 // present key only
+                             const float* k_scales,               // scales of an int8 key cache with size N_kv
                              bool past_present_share_buffer,      // whether present key and value share the same buffer
                              bool packed_qkv,                     // whether Q, K, V are packed
                              ThreadPool* tp) const {              // thread pool
@@ -124,7 +392,7 @@ class GQAAttentionBase {
     const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
 
     if (!past_present_share_buffer) {
-      memset(present_key, 0, batch_size * kv_num_heads_ * present_buffer_sequence_length * head_size * sizeof(T));
+      memset(present_key, 0, batch_size * kv_num_heads_ * present_buffer_sequence_length * head_size * sizeof(TCache));
     }
 
     const int loop_len = batch_size * num_heads_;
@@ -143,12 +411,14 @@ class GQAAttentionBase {
     unit_cost.bytes_stored += static_cast<double>(probs_matrix_bytes);
 
     if (present_key) {
-      double bytes_to_copy_key = static_cast<double>(sizeof(T) * present_buff_chunk_length);
+      double bytes_to_copy_key = static_cast<double>(sizeof(TCache) * present_buff_chunk_length);
       unit_cost.bytes_loaded += bytes_to_copy_key;
       unit_cost.bytes_stored += bytes_to_copy_key;
     }
 
     ThreadPool::TryParallelFor(tp, loop_len, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      // the int8 key cache of the head is dequantized here before the GEMM
+      std::vector<T> k_dequant(std::is_same_v<T, TCache> ? 0 : present_buff_chunk_length);
       for (std::ptrdiff_t i = begin; i != end; ++i) {
         const int batch_index = static_cast<int>(i) / num_heads_;
         const int head_index = static_cast<int>(i) % num_heads_;
@@ -167,9 +437,19 @@ class GQAAttentionBase {
           k = K + kv_input_chunk_length * (i / kv_num_heads_factor);
         }
         if (nullptr != present_key) {
-          k = ConcatStateChunkGQA(past_key, k, present_key, present_buff_chunk_length, past_buff_chunk_length,
-                                  past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
-                                  i / kv_num_heads_factor);
+          if constexpr (std::is_same_v<T, TCache>) {
+            ORT_UNUSED_PARAMETER(k_scales);
+            k = ConcatStateChunkGQA(past_key, k, present_key, present_buff_chunk_length, past_buff_chunk_length,
+                                    past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
+                                    i / kv_num_heads_factor);
+          } else {
+            const float k_scale = k_scales[(i / kv_num_heads_factor) % kv_num_heads_];
+            const TCache* k_cache = ConcatQuantizedStateChunkGQA(
+                past_key, k, present_key, present_buff_chunk_length, past_buff_chunk_length, past_chunk_length,
+                kv_input_chunk_length, is_prompt, past_present_share_buffer, i / kv_num_heads_factor, k_scale);
+            DequantizeStateChunk(k_cache, k_dequant.data(), static_cast<size_t>(total_seqlen) * head_size, k_scale);
+            k = k_dequant.data();
+          }
         }
 
         // Compute Q*K' + AttentionMask
@@ -187,32 +467,40 @@ class GQAAttentionBase {
                                     head_size, k, head_size, 0.0f /*bata*/, output, present_buffer_sequence_length,
                                     nullptr);
 
-        // compute Softmax
-        T* output_softmax = output;
-        for (int seq = 0; seq < sequence_length; seq++) {
-          int seq_causal_length = sequence_length == 1 ? total_seqlen : seq + 1;
-          if (local_window_size_ > 0 && seq_causal_length > local_window_size_ + 1) {
-            for (int total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
-              output_softmax[total_seq_id] = 0.f;
-            }
-            ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
-                                           local_window_size_ + 1, nullptr);
-          } else {
-            ComputeAttentionSoftmaxInplace(output_softmax, 1, seq_causal_length, nullptr);
-          }
-
-          // set causal [seq_causal_length, total_seqlen) to 0.f
-          for (int total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
-            output_softmax[total_seq_id] = 0.f;
-          }
-
-          output_softmax += present_buffer_sequence_length;
-        }
+        ComputeCausalSoftmax(output, sequence_length, total_seqlen, present_buffer_sequence_length);
       }
     });
   }
 
+  // Softmax of the attention probs of one head with size SxT, with causal and local window masking
   template <typename T>
+  void ComputeCausalSoftmax(T* attention_probs,   // attention probs of the head, its row stride is T
+                            int sequence_length,  // sequence length of self-attention (S)
+                            int total_seqlen,     // number of valid columns (past + new)
+                            int row_stride) const {
+    T* output_softmax = attention_probs;
+    for (int seq = 0; seq < sequence_length; seq++) {
+      int seq_causal_length = sequence_length == 1 ? total_seqlen : seq + 1;
+      if (local_window_size_ > 0 && seq_causal_length > local_window_size_ + 1) {
+        for (int total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
+          output_softmax[total_seq_id] = 0.f;
+        }
+        ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
+                                       local_window_size_ + 1, nullptr);
+      } else {
+        ComputeAttentionSoftmaxInplace(output_softmax, 1, seq_causal_length, nullptr);
+      }
+
+      // set causal [seq_causal_length, total_seqlen) to 0.f
+      for (int total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
+        output_softmax[total_seq_id] = 0.f;
+      }
+
+      output_softmax += row_stride;
+    }
+  }
+
+  template <typename T, typename TCache>
   void ComputeVxAttentionScore(T* output,                           // buffer for the result with size BxSxNxH
                                const T* attention_probs,            // Attention probs with size BxNxSxT
                                const T* V,                          // V value with size BxN_kvxSxH
@@ -223,8 +511,9 @@ class GQAAttentionBase {
                                int present_buffer_sequence_length,  // sequence length in past state
                                int head_size,                       // head size of Q, K, V
                                int hidden_size,                     // hidden size of Output
-                               const T* past_value,                 // past value only
-                               T* present_value,                    // present value only
+                               const TCache* past_value,            // past value only
+                               TCache* present_value,               // present value only
+                               const float* v_scales,               // scales of an int8 value cache with size N_kv
                                bool past_present_share_buffer,      // whether present key and value share the same buffer
                                bool packed_qkv,                     // whether Q, K, V are packed
                                ThreadPool* tp) const {
@@ -238,7 +527,8 @@ class GQAAttentionBase {
     const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
 
     if (!past_present_share_buffer) {
-      memset(present_value, 0, batch_size * kv_num_heads_ * present_buffer_sequence_length * head_size * sizeof(T));
+      memset(present_value, 0,
+             batch_size * kv_num_heads_ * present_buffer_sequence_length * head_size * sizeof(TCache));
     }
 
     // The cost of Gemm
@@ -250,7 +540,7 @@ class GQAAttentionBase {
     unit_cost.bytes_stored = static_cast<double>(sequence_length * head_size * sizeof(T));
 
     if (present_value) {
-      double bytes_to_copy_value = static_cast<double>(present_buff_chunk_length * sizeof(T));
+      double bytes_to_copy_value = static_cast<double>(present_buff_chunk_length * sizeof(TCache));
       unit_cost.bytes_loaded += bytes_to_copy_value;
       unit_cost.bytes_stored += bytes_to_copy_value;
     }
@@ -262,6 +552,8 @@ class GQAAttentionBase {
 
     ThreadPool::TryParallelFor(
         tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          // the int8 value cache of the head is dequantized here before the GEMM
+          std::vector<T> v_dequant(std::is_same_v<T, TCache> ? 0 : present_buff_chunk_length);
           for (std::ptrdiff_t i = begin; i != end; ++i) {
             const int batch_index = static_cast<int>(i / num_heads_);
             const int head_index = static_cast<int>(i % num_heads_);
@@ -277,9 +569,21 @@ class GQAAttentionBase {
               v = V + kv_input_chunk_length * (i / kv_num_heads_factor);
             }
             if (nullptr != present_value) {
-              v = ConcatStateChunkGQA(past_value, v, present_value, present_buff_chunk_length, past_buff_chunk_length,
-                                      past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
-                                      i / kv_num_heads_factor);
+              if constexpr (std::is_same_v<T, TCache>) {
+                ORT_UNUSED_PARAMETER(v_scales);
+                v = ConcatStateChunkGQA(past_value, v, present_value, present_buff_chunk_length,
+                                        past_buff_chunk_length, past_chunk_length, kv_input_chunk_length, is_prompt,
+                                        past_present_share_buffer, i / kv_num_heads_factor);
+              } else {
+                const float v_scale = v_scales[(i / kv_num_heads_factor) % kv_num_heads_];
+                const TCache* v_cache = ConcatQuantizedStateChunkGQA(
+                    past_value, v, present_value, present_buff_chunk_length, past_buff_chunk_length,
+                    past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
+                    i / kv_num_heads_factor, v_scale);
+                DequantizeStateChunk(v_cache, v_dequant.data(), static_cast<size_t>(total_seqlen) * head_size,
+                                     v_scale);
+                v = v_dequant.data();
+              }
             }
 
             T* output_current = output + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
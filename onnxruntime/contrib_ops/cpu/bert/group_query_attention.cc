@@ -30,6 +30,7 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
     kCpuExecutionProvider,
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T_CACHE", {DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<int8_t>()})
         .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),
     GroupQueryAttention<float>);
 
@@ -48,14 +49,19 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   const Tensor* total_seqlen = context->Input<Tensor>(6);
   const Tensor* cos_cache = context->Input<Tensor>(7);
   const Tensor* sin_cache = context->Input<Tensor>(8);
+  const Tensor* block_table = context->Input<Tensor>(9);
+  const Tensor* k_scale = context->Input<Tensor>(10);
+  const Tensor* v_scale = context->Input<Tensor>(11);
+  const bool paged_kv_cache = block_table != nullptr;
 
   GroupQueryAttentionParameters parameters = {};
   constexpr float scale = 1.0f;
+  // the past KV of a paged KV cache is checked separately
   ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckInputs(query,
                                                                 key,
                                                                 value,
-                                                                past_key,
-                                                                past_value,
+                                                                paged_kv_cache ? nullptr : past_key,
+                                                                paged_kv_cache ? nullptr : past_value,
                                                                 cos_cache,
                                                                 sin_cache,
                                                                 &parameters,
@@ -64,6 +70,10 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
                                                                 seqlens_k,
                                                                 total_seqlen,
                                                                 scale));
+  if (paged_kv_cache) {
+    ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckPagedKVCache(past_key, past_value, block_table, seqlens_k,
+                                                                        parameters));
+  }
 
   const int batch_size = parameters.batch_size;
   const int sequence_length = parameters.sequence_length;
@@ -80,8 +90,28 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
 
   std::vector<int64_t> present_k_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
   std::vector<int64_t> present_v_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
+  if (paged_kv_cache) {
+    // the present KV cache has the blocks of the past KV cache
+    const auto past_kv_dims = past_key->Shape().GetDims();
+    present_k_shape.assign(past_kv_dims.begin(), past_kv_dims.end());
+    present_v_shape.assign(past_kv_dims.begin(), past_kv_dims.end());
+  }
   Tensor* present_k = context->Output(1, present_k_shape);
   Tensor* present_v = context->Output(2, present_v_shape);
+  if (paged_kv_cache) {
+    ORT_RETURN_IF(present_k == nullptr || present_v == nullptr,
+                  "Output 'present_key' and 'present_value' are required with 'block_table'.");
+  }
+
+  // The KV cache is int8 when past_key is int8, or present_key without past.
+  const bool quantized_kv_cache = past_key != nullptr ? past_key->IsDataType<int8_t>()
+                                                      : present_k != nullptr && present_k->IsDataType<int8_t>();
+  std::vector<float> k_scales;
+  std::vector<float> v_scales;
+  if (quantized_kv_cache) {
+    ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckQuantizedKVCache(present_k, present_v, k_scale, v_scale,
+                                                                            kv_num_heads_, k_scales, v_scales));
+  }
 
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
@@ -177,9 +207,26 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
 
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
   // Compute the attention score and apply the score to V
-  return ApplyAttention(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
-                        packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value, output, present_k, present_v,
-                        seqlens_k, parameters, allocator, context);
+  const T* q_data = Q.Get<Tensor>().Data<T>();
+  const T* k_data = packed_qkv ? nullptr : K.Get<Tensor>().Data<T>();
+  const T* v_data = packed_qkv ? nullptr : V.Get<Tensor>().Data<T>();
+  if (quantized_kv_cache) {
+    if (paged_kv_cache) {
+      return ApplyPagedAttention<T, int8_t>(q_data, k_data, v_data, past_key, past_value, output, present_k, present_v,
+                                            seqlens_k, block_table, parameters, allocator, context, k_scales.data(),
+                                            v_scales.data());
+    }
+    return ApplyAttention<T, int8_t>(q_data, k_data, v_data, past_key, past_value, output, present_k, present_v,
+                                     seqlens_k, parameters, allocator, context, k_scales.data(), v_scales.data());
+  }
+
+  if (paged_kv_cache) {
+    return ApplyPagedAttention(q_data, k_data, v_data, past_key, past_value, output, present_k, present_v, seqlens_k,
+                               block_table, parameters, allocator, context);
+  }
+
+  return ApplyAttention(q_data, k_data, v_data, past_key, past_value, output, present_k, present_v, seqlens_k,
+                        parameters, allocator, context);
 }
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "core/common/common.h"
 #include "core/providers/common.h"
 #include "contrib_ops/cpu/bert/attention_common.h"
@@ -243,6 +245,139 @@ Status CheckInputs(const Tensor* query,
   return Status::OK();
 }
 
+// Checks the paged KV cache inputs and updates the parameters that CheckInputs() returned without past KV.
+//     past_key                   : (num_blocks, N_k, block_size, H)
+//     past_value                 : (num_blocks, N_k, block_size, H)
+//     block_table                : (B, max_blocks_per_sequence)
+Status CheckPagedKVCache(const Tensor* past_key,
+                         const Tensor* past_value,
+                         const Tensor* block_table,
+                         const Tensor* seqlens_k,
+                         GroupQueryAttentionParameters& parameters) {
+  if (past_key == nullptr || past_value == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'past_key' and 'past_value' are required with 'block_table'.");
+  }
+
+  const auto& past_key_dims = past_key->Shape().GetDims();
+  if (past_key_dims.size() != 4) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'past_key' is expected to have 4 dimensions with 'block_table', got ",
+                           past_key_dims.size());
+  }
+  if (past_value->Shape() != past_key->Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'past_key' and 'past_value' shall have the same shape with 'block_table'.");
+  }
+  if (past_key_dims[1] != parameters.kv_num_heads) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'past_key' shall have kv_num_heads");
+  }
+  if (past_key_dims[2] <= 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'past_key' dimension 2 (block size) shall be positive, got ", past_key_dims[2]);
+  }
+  if (past_key_dims[3] != parameters.head_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'past_key' dimension 3 should be same as head_size, got ",
+                           past_key_dims[3]);
+  }
+
+  const auto& block_table_dims = block_table->Shape().GetDims();
+  if (block_table_dims.size() != 2 || block_table_dims[0] != parameters.batch_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'block_table' is expected to have shape (batch_size, max_blocks_per_sequence).");
+  }
+
+  const int num_blocks = static_cast<int>(past_key_dims[0]);
+  const int block_size = static_cast<int>(past_key_dims[2]);
+  const int max_blocks_per_sequence = static_cast<int>(block_table_dims[1]);
+
+  // The attention probs of a sequence have a row of max_blocks_per_sequence * block_size columns, and the causal
+  // softmax of a padded prompt reads up to sequence_length columns of it.
+  if (parameters.sequence_length > static_cast<int64_t>(max_blocks_per_sequence) * block_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'block_table' has ", max_blocks_per_sequence, " blocks per sequence of ", block_size,
+                           " tokens, which is less than the sequence length ", parameters.sequence_length);
+  }
+
+  // The blocks of each sequence hold its seqlens_k + 1 tokens.
+  const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+  const int32_t* block_table_data = block_table->Data<int32_t>();
+  for (int b = 0; b < parameters.batch_size; b++) {
+    const int total_seqlen = seqlens_k_data[b] + 1;
+    if (total_seqlen <= 0 || (parameters.sequence_length != 1 && total_seqlen > parameters.sequence_length)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'seqlens_k' has an invalid value for batch ", b, ": ", seqlens_k_data[b]);
+    }
+    const int num_sequence_blocks = (total_seqlen + block_size - 1) / block_size;
+    if (num_sequence_blocks > max_blocks_per_sequence) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'block_table' has ", max_blocks_per_sequence, " blocks per sequence, but batch ",
+                             b, " needs ", num_sequence_blocks);
+    }
+    for (int i = 0; i < num_sequence_blocks; i++) {
+      const int32_t block = block_table_data[static_cast<ptrdiff_t>(b) * max_blocks_per_sequence + i];
+      if (block < 0 || block >= num_blocks) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'block_table' has an invalid block ", block, " for batch ", b);
+      }
+    }
+  }
+
+  parameters.is_paged_kv_cache = true;
+  parameters.kv_cache_block_size = block_size;
+  parameters.num_kv_cache_blocks = num_blocks;
+  parameters.max_blocks_per_sequence = max_blocks_per_sequence;
+  parameters.seqlen_past_kv_cache = max_blocks_per_sequence * block_size;
+  parameters.seqlen_present_kv_cache = max_blocks_per_sequence * block_size;
+
+  return Status::OK();
+}
+
+// Checks the scales of an int8 KV cache and returns them per KV head.
+//     k_scale                    : (N_k) or (1)
+//     v_scale                    : (N_k) or (1)
+Status CheckQuantizedKVCache(const Tensor* present_key,
+                             const Tensor* present_value,
+                             const Tensor* k_scale,
+                             const Tensor* v_scale,
+                             int kv_num_heads,
+                             std::vector<float>& k_scales,
+                             std::vector<float>& v_scales) {
+  if (present_key == nullptr || present_value == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Output 'present_key' and 'present_value' are required with an int8 KV cache.");
+  }
+  if (k_scale == nullptr || v_scale == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'k_scale' and 'v_scale' are required with an int8 KV cache.");
+  }
+
+  auto expand_scales = [kv_num_heads](const Tensor* scale, const char* name, std::vector<float>& scales) -> Status {
+    const auto& dims = scale->Shape().GetDims();
+    const int64_t size = scale->Shape().Size();
+    if (dims.size() > 1 || (size != 1 && size != kv_num_heads)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input '", name, "' is expected to have shape (kv_num_heads) or (1), got ",
+                             scale->Shape());
+    }
+    const float* data = scale->Data<float>();
+    scales.resize(kv_num_heads);
+    for (int i = 0; i < kv_num_heads; i++) {
+      scales[i] = data[size == 1 ? 0 : i];
+      if (!(scales[i] > 0.0f)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input '", name, "' shall be positive, got ", scales[i]);
+      }
+    }
+    return Status::OK();
+  };
+
+  ORT_RETURN_IF_ERROR(expand_scales(k_scale, "k_scale", k_scales));
+  return expand_scales(v_scale, "v_scale", v_scales);
+}
+
 Status CheckInputs(const Tensor* query,
                    const Tensor* key,
                    const Tensor* value,
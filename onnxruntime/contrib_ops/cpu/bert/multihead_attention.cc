@@ -145,67 +145,57 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
   ORT_RETURN_IF_ERROR(MaybeTransposeToBNSHAndAddBias<T>(
       context, allocator, batch_size, num_heads_, kv_sequence_length, v_head_size, value, bias, v_bias_offset, V));
 
+  // The flash attention handles the causal mask of self attention and past KV. The past is concatenated with K and V
+  // into present, which is then used as the key and value of the attention.
+  const bool has_past = past_key != nullptr && past_value != nullptr;
   if (std::is_same_v<T, float> &&
       !disable_flash_ &&
-      !is_unidirectional_ &&
+      (!is_unidirectional_ || kv_sequence_length == q_sequence_length) &&
       key_padding_mask == nullptr &&
       attn_bias == nullptr &&
-      past_key == nullptr &&
-      past_value == nullptr &&
-      present_k == nullptr &&
-      present_v == nullptr &&
+      (past_key == nullptr) == (past_value == nullptr) &&
+      (present_k == nullptr) == (present_v == nullptr) &&
+      (!has_past || present_k != nullptr) &&
       l2_cache_size_ > 0) {
+    auto* tp = context->GetOperatorThreadPool();
+
+    const float* k = K.Get<Tensor>().Data<float>();
+    const float* v = V.Get<Tensor>().Data<float>();
+    if (present_k != nullptr) {
+      const int past_sequence_length = total_kv_sequence_length - kv_sequence_length;
+      const size_t past_k_chunk_length = static_cast<size_t>(past_sequence_length) * qk_head_size;
+      const size_t past_v_chunk_length = static_cast<size_t>(past_sequence_length) * v_head_size;
+      const size_t present_k_chunk_length = static_cast<size_t>(total_kv_sequence_length) * qk_head_size;
+      const size_t present_v_chunk_length = static_cast<size_t>(total_kv_sequence_length) * v_head_size;
+      const float* past_k_data = has_past ? past_key->Data<float>() : nullptr;
+      const float* past_v_data = has_past ? past_value->Data<float>() : nullptr;
+      float* present_k_data = present_k->MutableData<float>();
+      float* present_v_data = present_v->MutableData<float>();
+      ThreadPool::TrySimpleParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, [&](std::ptrdiff_t i) {
+        ConcatStateChunk(past_k_data, k + (present_k_chunk_length - past_k_chunk_length) * i, present_k_data,
+                         past_k_chunk_length, present_k_chunk_length, i);
+        ConcatStateChunk(past_v_data, v + (present_v_chunk_length - past_v_chunk_length) * i, present_v_data,
+                         past_v_chunk_length, present_v_chunk_length, i);
+      });
+      k = present_k_data;
+      v = present_v_data;
+    }
+
     MlasFlashAttentionThreadedArgs args;
     args.batch_size = batch_size;
     args.num_heads = num_heads_;
     args.q_sequence_length = q_sequence_length;
-    args.kv_sequence_length = kv_sequence_length;
+    args.kv_sequence_length = total_kv_sequence_length;
     args.qk_head_size = qk_head_size;
     args.v_head_size = v_head_size;
     args.scale = (scale_ == 0.0f) ? 1.0f / sqrt(static_cast<float>(qk_head_size)) : scale_;
-    /*
-      q_block_size, kv_block_size correspond to Br, Bc in the FlashAttention paper.
-      Let M = l2_cache_size / sizeof(float)
-      In the FlashAttention kernel, there are 5 big matrices that we need to keep in L2 cache:
-        slice of Q -- [Br, qk_head_size]
-        slice of K -- [Bc, qk_head_size]
-        slice of V -- [Bc, v_head_size]
-        result of QK -- [Br, Bc]
-        temporary output (same shape as QKV) -- [Br, v_head_size]
-      The total size of these matrices is (Br + Bc) * (qk_head_size + v_head_size) + Br * Bc
-      By taking Bc = M / (4 * (qk_head_size + v_head_size)), and Br = min(Bc, qk_head_size + v_head_size), we have
-        (Br + Bc) * (qk_head_size + v_head_size) + Br * Bc
-        <= 2 * Bc * (qk_head_size + v_head_size) + Br * Bc
-        <= 2 * Bc * (qk_head_size + v_head_size) + M/4
-        <= 2 * M/4 + M/4 = M * (3/4)
-
-      We leave 1/4 of the L2 cache for
-        1. storing small tensors l and m
-        2. instruction (code)
-    */
-    args.kv_block_size = l2_cache_size_ / (static_cast<int>(sizeof(float)) * 4 * (qk_head_size + v_head_size));
-    args.kv_block_size = std::max(args.kv_block_size, 1);  // avoid kv_block_size = 0
-    args.q_block_size = std::min(args.kv_block_size, qk_head_size + v_head_size);
-    args.kv_block_size = std::min(args.kv_block_size, kv_sequence_length);  // No point to have kv_block_size > kv_sequence_length
-    args.q_block_size = std::min(args.q_block_size, q_sequence_length);     // No point to have q_block_size > q_sequence_length
-
-    auto* tp = context->GetOperatorThreadPool();
-    args.thread_count = concurrency::ThreadPool::DegreeOfParallelism(tp);
-    args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
-                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.kv_block_size) +
-                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.v_head_size)) *
-                                  sizeof(float);
-    size_t buffer_bytes = args.buffer_size_per_thread * args.thread_count;
-    IAllocatorUniquePtr<void> buffer = IAllocator::MakeUniquePtr<void>(allocator, buffer_bytes);
-
-    args.buffer = reinterpret_cast<float*>(buffer.get());
-
+    args.is_causal = is_unidirectional_;
     args.query = Q.Get<Tensor>().Data<float>();
-    args.key = K.Get<Tensor>().Data<float>();
-    args.value = V.Get<Tensor>().Data<float>();
+    args.key = k;
+    args.value = v;
     args.output = output->MutableData<float>();
 
-    MlasFlashAttention(&args, tp);
+    RunFlashAttention(args, l2_cache_size_, allocator, tp);
     return Status::OK();
   }
 
@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/common/inlined_containers.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+namespace {
+
+bool ParseStepOp(const std::string& op_type, FusedElementwise::StepOp& op, bool& is_binary) {
+  using StepOp = FusedElementwise::StepOp;
+  static const InlinedHashMap<std::string, std::pair<StepOp, bool>> step_ops = {
+      {"Add", {StepOp::kAdd, true}},
+      {"Sub", {StepOp::kSub, true}},
+      {"Mul", {StepOp::kMul, true}},
+      {"Div", {StepOp::kDiv, true}},
+      {"Max", {StepOp::kMax, true}},
+      {"Min", {StepOp::kMin, true}},
+      {"Neg", {StepOp::kNeg, false}},
+      {"Abs", {StepOp::kAbs, false}},
+      {"Sqrt", {StepOp::kSqrt, false}},
+      {"Exp", {StepOp::kExp, false}},
+      {"Log", {StepOp::kLog, false}},
+      {"Reciprocal", {StepOp::kReciprocal, false}},
+      {"Relu", {StepOp::kRelu, false}},
+      {"Sigmoid", {StepOp::kSigmoid, false}},
+      {"Tanh", {StepOp::kTanh, false}},
+      {"Erf", {StepOp::kErf, false}},
+  };
+  auto it = step_ops.find(op_type);
+  if (it == step_ops.end()) {
+    return false;
+  }
+  op = it->second.first;
+  is_binary = it->second.second;
+  return true;
+}
+
+void EvaluateStep(FusedElementwise::StepOp op, const float* a, const float* b, float* y, size_t n) {
+  using StepOp = FusedElementwise::StepOp;
+  switch (op) {
+    case StepOp::kAdd:
+      for (size_t i = 0; i < n; ++i) y[i] = a[i] + b[i];
+      break;
+    case StepOp::kSub:
+      for (size_t i = 0; i < n; ++i) y[i] = a[i] - b[i];
+      break;
+    case StepOp::kMul:
+      for (size_t i = 0; i < n; ++i) y[i] = a[i] * b[i];
+      break;
+    case StepOp::kDiv:
+      for (size_t i = 0; i < n; ++i) y[i] = a[i] / b[i];
+      break;
+    case StepOp::kMax:
+      for (size_t i = 0; i < n; ++i) y[i] = std::max(a[i], b[i]);
+      break;
+    case StepOp::kMin:
+      for (size_t i = 0; i < n; ++i) y[i] = std::min(a[i], b[i]);
+      break;
+    case StepOp::kNeg:
+      for (size_t i = 0; i < n; ++i) y[i] = -a[i];
+      break;
+    case StepOp::kAbs:
+      for (size_t i = 0; i < n; ++i) y[i] = std::abs(a[i]);
+      break;
+    case StepOp::kSqrt:
+      for (size_t i = 0; i < n; ++i) y[i] = std::sqrt(a[i]);
+      break;
+    case StepOp::kExp:
+      MlasComputeExp(a, y, n);
+      break;
+    case StepOp::kLog:
+      for (size_t i = 0; i < n; ++i) y[i] = std::log(a[i]);
+      break;
+    case StepOp::kReciprocal:
+      for (size_t i = 0; i < n; ++i) y[i] = 1.0f / a[i];
+      break;
+    case StepOp::kRelu:
+      for (size_t i = 0; i < n; ++i) y[i] = std::max(a[i], 0.0f);
+      break;
+    case StepOp::kSigmoid:
+      MlasComputeLogistic(a, y, n);
+      break;
+    case StepOp::kTanh:
+      MlasComputeTanh(a, y, n);
+      break;
+    case StepOp::kErf:
+      MlasComputeErf(a, y, n);
+      break;
+  }
+}
+
+}  // namespace
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  const auto ops = info.GetAttrsOrDefault<std::string>("ops");
+  const auto operands = info.GetAttrsOrDefault<int64_t>("operands");
+  ORT_ENFORCE(!ops.empty() && operands.size() == 2 * ops.size(),
+              "FusedElementwise expects two operands per step, got ", operands.size(), " for ", ops.size(), " steps.");
+
+  const int num_inputs = static_cast<int>(info.GetInputCount());
+  steps_.reserve(ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) {
+    Step step{};
+    bool is_binary = false;
+    ORT_ENFORCE(ParseStepOp(ops[i], step.op, is_binary), "Unsupported FusedElementwise step: ", ops[i]);
+    step.operand0 = static_cast<int>(operands[2 * i]);
+    step.operand1 = static_cast<int>(operands[2 * i + 1]);
+    // operands are inputs or results of the previous steps
+    const int num_values = num_inputs + static_cast<int>(i);
+    ORT_ENFORCE(step.operand0 >= 0 && step.operand0 < num_values &&
+                    (is_binary ? step.operand1 >= 0 && step.operand1 < num_values : step.operand1 == -1),
+                "Invalid operands for FusedElementwise step ", i, " (", ops[i], ")");
+    steps_.push_back(step);
+  }
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  const int num_inputs = context->InputCount();
+
+  // multidirectional broadcasting of all the inputs
+  size_t rank = 0;
+  for (int k = 0; k < num_inputs; ++k) {
+    rank = std::max(rank, context->Input<Tensor>(k)->Shape().NumDimensions());
+  }
+  TensorShapeVector output_dims(rank, 1);
+  for (int k = 0; k < num_inputs; ++k) {
+    const auto dims = context->Input<Tensor>(k)->Shape().GetDims();
+    for (size_t j = 0; j < dims.size(); ++j) {
+      int64_t& output_dim = output_dims[rank - dims.size() + j];
+      if (dims[j] != output_dim) {
+        ORT_RETURN_IF_NOT(output_dim == 1 || dims[j] == 1, "FusedElementwise: input ", k,
+                          " can't be broadcast to the other inputs.");
+        if (output_dim == 1) {
+          output_dim = dims[j];
+        }
+      }
+    }
+  }
+
+  Tensor* Y = context->Output(0, TensorShape(output_dims));
+  const int64_t output_size = Y->Shape().Size();
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  // Strides of every input over the output dimensions, 0 on the broadcast ones. The dimensions of size 1 are dropped
+  // and the adjacent dimensions every input walks contiguously are merged, so that the innermost dimension is as long
+  // as possible and every input either walks it with stride 1 or repeats a single value along it.
+  InlinedVector<int64_t> dims;
+  InlinedVector<InlinedVector<int64_t>> strides(num_inputs);
+  {
+    InlinedVector<InlinedVector<int64_t>> full_strides(num_inputs, InlinedVector<int64_t>(rank, 0));
+    for (int k = 0; k < num_inputs; ++k) {
+      const auto input_dims = context->Input<Tensor>(k)->Shape().GetDims();
+      int64_t stride = 1;
+      for (size_t j = input_dims.size(); j-- > 0;) {
+        full_strides[k][rank - input_dims.size() + j] = input_dims[j] == 1 ? 0 : stride;
+        stride *= input_dims[j];
+      }
+    }
+    for (size_t j = 0; j < rank; ++j) {
+      if (output_dims[j] == 1) {
+        continue;
+      }
+      bool can_merge = !dims.empty();
+      for (int k = 0; k < num_inputs && can_merge; ++k) {
+        can_merge = strides[k].back() == full_strides[k][j] * output_dims[j];
+      }
+      if (can_merge) {
+        dims.back() *= output_dims[j];
+        for (int k = 0; k < num_inputs; ++k) {
+          strides[k].back() = full_strides[k][j];
+        }
+      } else {
+        dims.push_back(output_dims[j]);
+        for (int k = 0; k < num_inputs; ++k) {
+          strides[k].push_back(full_strides[k][j]);
+        }
+      }
+    }
+    if (dims.empty()) {
+      dims.push_back(1);
+      for (int k = 0; k < num_inputs; ++k) {
+        strides[k].push_back(0);
+      }
+    }
+  }
+
+  const size_t row_size = static_cast<size_t>(dims.back());
+  const size_t num_rows = static_cast<size_t>(output_size) / row_size;
+  const size_t tiles_per_row = (row_size + kTileSize - 1) / kTileSize;
+
+  InlinedVector<const float*> input_data(num_inputs);
+  for (int k = 0; k < num_inputs; ++k) {
+    input_data[k] = context->Input<Tensor>(k)->Data<float>();
+  }
+  float* output_data = Y->MutableData<float>();
+  const size_t num_steps = steps_.size();
+
+  auto evaluate_tiles = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    // one tile per input broadcast along the rows, and per step except the last one, which writes to the output
+    std::vector<float> scratch((num_inputs + num_steps) * kTileSize);
+    InlinedVector<const float*> values(num_inputs + num_steps);
+    InlinedVector<int64_t> input_offsets(num_inputs);
+
+    for (std::ptrdiff_t tile = first; tile < last; ++tile) {
+      const size_t row = static_cast<size_t>(tile) / tiles_per_row;
+      const size_t begin = (static_cast<size_t>(tile) % tiles_per_row) * kTileSize;
+      const size_t count = std::min(kTileSize, row_size - begin);
+
+      std::fill(input_offsets.begin(), input_offsets.end(), 0);
+      size_t remaining = row;
+      for (size_t j = dims.size() - 1; j-- > 0;) {
+        const int64_t index = static_cast<int64_t>(remaining % static_cast<size_t>(dims[j]));
+        remaining /= static_cast<size_t>(dims[j]);
+        for (int k = 0; k < num_inputs; ++k) {
+          input_offsets[k] += index * strides[k][j];
+        }
+      }
+
+      for (int k = 0; k < num_inputs; ++k) {
+        const float* row_data = input_data[k] + input_offsets[k];
+        if (strides[k].back() != 0) {
+          values[k] = row_data + begin;
+        } else {
+          float* broadcast = scratch.data() + k * kTileSize;
+          std::fill_n(broadcast, count, *row_data);
+          values[k] = broadcast;
+        }
+      }
+
+      for (size_t i = 0; i < num_steps; ++i) {
+        const Step& step = steps_[i];
+        float* result = i + 1 == num_steps ? output_data + row * row_size + begin
+                                           : scratch.data() + (num_inputs + i) * kTileSize;
+        EvaluateStep(step.op, values[step.operand0], step.operand1 >= 0 ? values[step.operand1] : nullptr,
+                     result, count);
+        values[num_inputs + i] = result;
+      }
+    }
+  };
+
+  const double tile_elements = static_cast<double>(std::min(kTileSize, row_size));
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_rows * tiles_per_row),
+      TensorOpCost{static_cast<double>(num_inputs * sizeof(float)) * tile_elements,
+                   static_cast<double>(sizeof(float)) * tile_elements,
+                   static_cast<double>(num_steps) * 4.0 * tile_elements},
+      evaluate_tiles);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Evaluates a chain of elementwise operators tile by tile, so the intermediate results stay in cache instead of
+// going through full size tensors. See the FusedElementwise schema for the encoding of the chain.
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+  enum class StepOp : uint8_t {
+    kAdd,
+    kSub,
+    kMul,
+    kDiv,
+    kMax,
+    kMin,
+    kNeg,
+    kAbs,
+    kSqrt,
+    kExp,
+    kLog,
+    kReciprocal,
+    kRelu,
+    kSigmoid,
+    kTanh,
+    kErf,
+  };
+
+  struct Step {
+    StepOp op;
+    int operand0;
+    int operand1;  // -1 for unary operators
+  };
+
+  // Number of elements of every operand evaluated at once.
+  static constexpr size_t kTileSize = 512;
+
+ private:
+  std::vector<Step> steps_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include "contrib_ops/cpu/quantization/matmul_nbits_impl.h"
 
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
 
 #include "core/common/common.h"
@@ -126,7 +127,17 @@ class MatMulNBits final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  bool IsPrePackCacheable(int input_idx) const override;
+
+  Status UseCachedPrePackedBuffers(const Tensor& tensor, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx, /*out*/ bool& used_cached_buffers) override;
+
  private:
+#if !defined(ORT_NEURAL_SPEED)
+  // Whether the PrePack() calls for the scales and zero points update the packed B in place
+  bool IsPackedBUpdatedInPlace() const;
+#endif
+
   const size_t K_;
   const size_t N_;
   const size_t block_size_;
@@ -209,7 +220,6 @@ Status MatMulNBits::PrePack(const Tensor& tensor, int input_idx, /*out*/ Allocat
   }
 
 #else  // defined(ORT_NEURAL_SPEED)
-  ORT_UNUSED_PARAMETER(prepacked_weights);
   const auto compute_type = static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_);
   if (input_idx == InputIndex::B) {
     if (!MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type)) {
@@ -222,6 +232,17 @@ Status MatMulNBits::PrePack(const Tensor& tensor, int input_idx, /*out*/ Allocat
     auto qptr = tensor.DataRaw();
     packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size_, true);
     MlasSQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type, qptr, packed_b_.get(), nullptr, has_zp_input_, nullptr, nullptr);
+    if (prepacked_weights) {
+      if (IsPackedBUpdatedInPlace()) {
+        // The shared buffer must not change, so share a copy and keep packed_b_ private to this kernel.
+        auto shared_packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size_, true);
+        std::memcpy(shared_packed_b.get(), packed_b_.get(), packed_b_size_);
+        prepacked_weights->buffers_.push_back(std::move(shared_packed_b));
+      } else {
+        prepacked_weights->buffers_.push_back(std::move(packed_b_));
+      }
+      prepacked_weights->buffer_sizes_.push_back(packed_b_size_);
+    }
     is_packed = true;
   } else if (compute_type == CompInt8) {
 #ifdef MLAS_TARGET_AMD64_IX86
@@ -265,7 +286,10 @@ Status MatMulNBits::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
 
   if (input_idx == 1) {
     used_shared_buffers = true;
-    packed_b_ = std::move(prepacked_buffers[0]);
+    // a packed B updated in place stays private, see PrePack()
+    if (!IsPackedBUpdatedInPlace()) {
+      packed_b_ = std::move(prepacked_buffers[0]);
+    }
   }
 
 #endif  // defined(ORT_NEURAL_SPEED)
@@ -273,6 +297,43 @@ Status MatMulNBits::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+bool MatMulNBits::IsPrePackCacheable(int input_idx) const {
+#if defined(ORT_NEURAL_SPEED)
+
+  // B is packed together with the scales and zero points
+  ORT_UNUSED_PARAMETER(input_idx);
+  return false;
+
+#else  // defined(ORT_NEURAL_SPEED)
+
+  return input_idx == InputIndex::B && !IsPackedBUpdatedInPlace();
+
+#endif  // defined(ORT_NEURAL_SPEED)
+}
+
+#if !defined(ORT_NEURAL_SPEED)
+bool MatMulNBits::IsPackedBUpdatedInPlace() const {
+#ifdef MLAS_TARGET_AMD64_IX86
+  // the scales and zero points of CompInt8 are packed into B
+  return static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_) == CompInt8;
+#else
+  return false;
+#endif
+}
+#endif  // !defined(ORT_NEURAL_SPEED)
+
+Status MatMulNBits::UseCachedPrePackedBuffers(const Tensor& /*tensor*/, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              int input_idx, /*out*/ bool& used_cached_buffers) {
+  used_cached_buffers = false;
+
+  if (IsPrePackCacheable(input_idx)) {
+    used_cached_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
 Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
   const Tensor* a = ctx->Input<Tensor>(InputIndex::A);
@@ -3,8 +3,12 @@
 
 #pragma once
 #include <algorithm>
+#include <cstring>
+#include <numeric>
 #include <vector>
 
+#include "core/common/inlined_containers.h"
+#include "core/common/narrow.h"
 #include "core/common/span_utils.h"
 #include "contrib_ops/cpu/transformers/greedy_search_impl_base.h"
 
@@ -101,6 +105,23 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
       gsl::span<const int32_t> next_tokens,
       int past_sequence_length);
 
+  // Remove the rows of the sequences that met EOS in the last iteration from the attention mask, the position ids
+  // and the present state, so that the next iterations only run the subgraph on the unfinished sequences.
+  // active_batch_ids maps each remaining row to its batch id.
+  Status EvictFinishedSequences(gsl::span<const bool> eos_meet,
+                                InlinedVector<int32_t>& active_batch_ids,
+                                std::vector<OrtValue>& feeds,
+                                std::vector<OrtValue>& fetches,
+                                gsl::span<int32_t> next_positions,
+                                OrtValue& position_ids);
+
+  // Copy the logits of the active rows into logits for the whole batch. The rows of the finished sequences are zeros.
+  // Their next tokens are replaced by the pad token. Sampling still draws one random number per row whatever its
+  // logits, so the unfinished sequences get the same random numbers as without eviction.
+  void ExpandLogits(const OrtValue& logits,
+                    gsl::span<const int32_t> active_batch_ids,
+                    OrtValue& batch_logits);
+
   const SessionState* init_run_decoder_session_state_ = nullptr;
   GptSubgraph* init_run_gpt_subgraph_ = nullptr;
   GptSubgraph& gpt_subgraph_;
@@ -187,6 +208,103 @@ Status GreedySearchGpt<T, ParametersT>::UpdateFeeds(
                             false);
 }
 
+// Copy the given rows along the batch axis of input into a new tensor.
+inline void GatherBatchRows(const Tensor& input,
+                            size_t batch_axis,
+                            gsl::span<const size_t> rows,
+                            AllocatorPtr allocator,
+                            OrtValue& output) {
+  const TensorShape& input_shape = input.Shape();
+  TensorShapeVector output_dims = input_shape.AsShapeVector();
+  output_dims[batch_axis] = static_cast<int64_t>(rows.size());
+  Tensor::InitOrtValue(input.DataType(), TensorShape(output_dims), std::move(allocator), output);
+
+  const size_t outer_size = narrow<size_t>(input_shape.SizeToDimension(batch_axis));
+  const size_t batch_size = narrow<size_t>(input_shape[batch_axis]);
+  const size_t row_bytes = narrow<size_t>(input_shape.SizeFromDimension(batch_axis + 1)) * input.DataType()->Size();
+  const auto* input_data = static_cast<const uint8_t*>(input.DataRaw());
+  auto* output_data = static_cast<uint8_t*>(output.GetMutable<Tensor>()->MutableDataRaw());
+  for (size_t outer = 0; outer < outer_size; ++outer) {
+    for (size_t i = 0; i < rows.size(); ++i) {
+      memcpy(output_data + (outer * rows.size() + i) * row_bytes,
+             input_data + (outer * batch_size + rows[i]) * row_bytes,
+             row_bytes);
+    }
+  }
+}
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::EvictFinishedSequences(gsl::span<const bool> eos_meet,
+                                                               InlinedVector<int32_t>& active_batch_ids,
+                                                               std::vector<OrtValue>& feeds,
+                                                               std::vector<OrtValue>& fetches,
+                                                               gsl::span<int32_t> next_positions,
+                                                               OrtValue& position_ids) {
+  InlinedVector<size_t> kept_rows;
+  for (size_t row = 0; row < active_batch_ids.size(); ++row) {
+    if (!eos_meet[active_batch_ids[row]]) {
+      kept_rows.push_back(row);
+    }
+  }
+
+  if (kept_rows.size() == active_batch_ids.size()) {
+    return Status::OK();
+  }
+
+  // kept_rows is sorted so the rows can be moved in place.
+  for (size_t i = 0; i < kept_rows.size(); ++i) {
+    active_batch_ids[i] = active_batch_ids[kept_rows[i]];
+    next_positions[i] = next_positions[kept_rows[i]];
+  }
+  active_batch_ids.resize(kept_rows.size());
+
+  int64_t dims[] = {static_cast<int64_t>(kept_rows.size()), 1};
+  TensorShape shape(&dims[0], 2);
+  Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(),
+                       shape,
+                       next_positions.data(),
+                       this->temp_space_allocator_->Info(),
+                       position_ids);
+
+  // attention_mask has shape (batch_size, current_length - 1)
+  OrtValue attention_mask;
+  GatherBatchRows(feeds[2].Get<Tensor>(), 0, kept_rows, this->temp_space_allocator_, attention_mask);
+  feeds[2] = attention_mask;
+
+  // present state has shape (2, batch_size, num_heads, current_length - 1, head_size)
+  for (size_t i = static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex()); i < fetches.size(); ++i) {
+    OrtValue present;
+    GatherBatchRows(fetches[i].Get<Tensor>(), 1, kept_rows, this->temp_space_allocator_, present);
+    fetches[i] = present;
+  }
+
+  return Status::OK();
+}
+
+template <typename T, typename ParametersT>
+void GreedySearchGpt<T, ParametersT>::ExpandLogits(const OrtValue& logits,
+                                                   gsl::span<const int32_t> active_batch_ids,
+                                                   OrtValue& batch_logits) {
+  // logits has shape (active_batch_size, sequence_length, vocab_size)
+  const Tensor& logits_tensor = logits.Get<Tensor>();
+  const TensorShape& logits_shape = logits_tensor.Shape();
+  TensorShapeVector batch_logits_dims = logits_shape.AsShapeVector();
+  batch_logits_dims[0] = this->parameters_->BatchBeamSize();
+  Tensor::InitOrtValue(logits_tensor.DataType(), TensorShape(batch_logits_dims), this->temp_space_allocator_,
+                       batch_logits);
+
+  Tensor* batch_logits_tensor = batch_logits.GetMutable<Tensor>();
+  const size_t row_bytes = narrow<size_t>(logits_shape.SizeFromDimension(1)) * logits_tensor.DataType()->Size();
+  auto* batch_logits_data = static_cast<uint8_t*>(batch_logits_tensor->MutableDataRaw());
+  memset(batch_logits_data, 0, batch_logits_tensor->SizeInBytes());
+  const auto* logits_data = static_cast<const uint8_t*>(logits_tensor.DataRaw());
+  for (size_t row = 0; row < active_batch_ids.size(); ++row) {
+    memcpy(batch_logits_data + static_cast<size_t>(active_batch_ids[row]) * row_bytes,
+           logits_data + row * row_bytes,
+           row_bytes);
+  }
+}
+
 template <typename T, typename ParametersT>
 Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                                                 const FeedsFetchesManager& feeds_fetches_manager) {
@@ -268,6 +386,14 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
                        this->temp_space_allocator_->Info(),
                        position_ids);
 
+  // On CPU, the sequences that met EOS are evicted from the batch between iterations, so the subgraph only runs on
+  // the sequences still being generated. The sequences, logits processing and outputs keep using the whole batch.
+  // This is not done when past and present share a buffer as its batch size is fixed.
+  const bool evict_finished_sequences = !this->IsCuda() && !gpt_subgraph_.past_present_share_buffer_;
+  InlinedVector<int32_t> active_batch_ids(static_cast<size_t>(parameters->BatchBeamSize()));
+  std::iota(active_batch_ids.begin(), active_batch_ids.end(), 0);
+  InlinedVector<int32_t> active_next_tokens;
+
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
@@ -312,7 +438,12 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
 
     ORT_RETURN_IF_ERROR(status);
 
-    const OrtValue& logits = fetches[0];
+    OrtValue batch_logits;
+    if (active_batch_ids.size() < static_cast<size_t>(parameters->BatchBeamSize())) {
+      ExpandLogits(fetches[0], active_batch_ids, batch_logits);
+    }
+
+    const OrtValue& logits = batch_logits.IsAllocated() ? batch_logits : fetches[0];
     gsl::span<int32_t> next_tokens;
 
     ORT_RETURN_IF_ERROR(this->GenerateNextToken(logits,
@@ -361,9 +492,23 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     if (current_length < parameters->max_length) {
       bool increase_position = (iteration_counter > 1);
 
+      gsl::span<const int32_t> active_tokens = next_tokens;
+      if (evict_finished_sequences) {
+        ORT_RETURN_IF_ERROR(EvictFinishedSequences(eos_meet, active_batch_ids, feeds, fetches,
+                                                   greedy_state.next_positions, position_ids));
+
+        if (active_batch_ids.size() < next_tokens.size()) {
+          active_next_tokens.resize(active_batch_ids.size());
+          for (size_t row = 0; row < active_batch_ids.size(); ++row) {
+            active_next_tokens[row] = next_tokens[active_batch_ids[row]];
+          }
+          active_tokens = active_next_tokens;
+        }
+      }
+
       ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
                                       position_ids, increase_position,
-                                      ReinterpretAsSpan<const int32_t>(next_tokens),
+                                      active_tokens,
                                       current_length - 1));
     }
     if (gpt_subgraph_.past_present_share_buffer_) {
@@ -8,6 +8,7 @@
 #include <initializer_list>
 #include <iostream>
 #include <tuple>
+#include <unordered_map>
 
 #include "core/common/profiler_common.h"
 #include "core/common/logging/logging.h"
@@ -80,6 +81,15 @@ class Profiler {
                              const std::initializer_list<std::pair<std::string, std::string>>& event_args = {},
                              bool sync_gpu = false);
 
+  /*
+  Same as above, for arguments only known at runtime.
+  */
+  void EndTimeAndRecordEvent(EventCategory category,
+                             const std::string& event_name,
+                             const TimePoint& start_time,
+                             std::unordered_map<std::string, std::string>&& event_args,
+                             bool sync_gpu = false);
+
   /*
   Write profile data to the given stream in chrome format defined below.
   https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview#
@@ -306,6 +306,19 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
     return idx % _num_shards;
   }
 
+  // NUMA-aware variant: the shards are split into num_nodes contiguous
+  // groups, and a thread picks its home shard from the group belonging
+  // to its node.  Since shards hold contiguous ranges of iterations,
+  // each node works through its own slice of the iteration space
+  // before ClaimIterations moves on to shards of the next node.
+  unsigned GetHomeShard(unsigned idx, unsigned node, unsigned num_nodes) const {
+    if (num_nodes <= 1 || _num_shards < num_nodes) {
+      return GetHomeShard(idx);
+    }
+    unsigned shards_per_node = _num_shards / num_nodes;
+    return (node % num_nodes) * shards_per_node + idx % shards_per_node;
+  }
+
   // Attempt to claim iterations from the sharded counter.  The function either
   // returns true, along with a block of exactly block_size iterations, or it returns false
   // if all of the iterations have been claimed.
@@ -389,6 +402,14 @@ ThreadPool::ThreadPool(Env* env,
       assert(thread_options_.affinities.size() >= size_t(threads_to_create));
     }
 
+    if (!thread_options_.numa_nodes.empty()) {
+      // As with affinities, the first element describes the caller thread
+      ORT_ENFORCE(thread_options_.numa_nodes.size() == static_cast<size_t>(degree_of_parallelism),
+                  "Number of NUMA nodes must equal the degree of parallelism, numa_nodes: ",
+                  thread_options_.numa_nodes.size(), ", degree_of_parallelism: ", degree_of_parallelism);
+      thread_options_.numa_nodes.erase(thread_options_.numa_nodes.begin());
+    }
+
     extended_eigen_threadpool_ =
         std::make_unique<ThreadPoolTempl<Env> >(name,
                                                 threads_to_create,
@@ -425,8 +446,9 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     assert(num_work_items > 0);
 
     LoopCounter lc(total, d_of_p, block_size);
+    const unsigned num_numa_nodes = static_cast<unsigned>(NumNumaNodes());
     std::function<void(unsigned)> run_work = [&](unsigned idx) {
-      unsigned my_home_shard = lc.GetHomeShard(idx);
+      unsigned my_home_shard = lc.GetHomeShard(idx, static_cast<unsigned>(CurrentNumaNode()), num_numa_nodes);
       unsigned my_shard = my_home_shard;
       uint64_t my_iter_start, my_iter_end;
       while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, block_size)) {
@@ -443,9 +465,10 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     std::ptrdiff_t base_block_size = static_cast<std::ptrdiff_t>(std::max(1LL, std::llroundl(static_cast<long double>(total) / num_of_blocks)));
     alignas(CACHE_LINE_BYTES) std::atomic<std::ptrdiff_t> left{total};
     LoopCounter lc(total, d_of_p, base_block_size);
+    const unsigned num_numa_nodes = static_cast<unsigned>(NumNumaNodes());
     std::function<void(unsigned)> run_work = [&](unsigned idx) {
       std::ptrdiff_t b = base_block_size;
-      unsigned my_home_shard = lc.GetHomeShard(idx);
+      unsigned my_home_shard = lc.GetHomeShard(idx, static_cast<unsigned>(CurrentNumaNode()), num_numa_nodes);
       unsigned my_shard = my_home_shard;
       uint64_t my_iter_start, my_iter_end;
       while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, b)) {
@@ -694,6 +717,22 @@ int ThreadPool::CurrentThreadId() const {
   }
 }
 
+int ThreadPool::NumNumaNodes() const {
+  if (extended_eigen_threadpool_) {
+    return extended_eigen_threadpool_->NumNumaNodes();
+  } else {
+    return 1;
+  }
+}
+
+int ThreadPool::CurrentNumaNode() const {
+  if (extended_eigen_threadpool_) {
+    return extended_eigen_threadpool_->CurrentNumaNode();
+  } else {
+    return 0;
+  }
+}
+
 void ThreadPool::TryParallelFor(concurrency::ThreadPool* tp, std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
                                 const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
   if (tp == nullptr) {
@@ -22,6 +22,8 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t num_front_cache_hits;    // Number of allocations served by the lock-free front cache of an arena.
+  int64_t num_front_cache_misses;  // Number of front cache lookups that fell back to the arena bins.
 
   AllocatorStats() { Clear(); }
 
@@ -35,6 +37,8 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_front_cache_hits = 0;
+    this->num_front_cache_misses = 0;
   }
 
   std::string DebugString() const {
@@ -47,7 +51,9 @@ struct AllocatorStats {
        << "NumReserves:              " << this->num_reserves << "\n"
        << "NumArenaExtensions:       " << this->num_arena_extensions << "\n"
        << "NumArenaShrinkages:       " << this->num_arena_shrinkages << "\n"
-       << "MaxAllocSize:             " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:             " << this->max_alloc_size << "\n"
+       << "NumFrontCacheHits:        " << this->num_front_cache_hits << "\n"
+       << "NumFrontCacheMisses:      " << this->num_front_cache_misses << "\n";
     return ss.str();
   }
 };
@@ -3,6 +3,7 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include <thread>
 #include <type_traits>
 
 namespace onnxruntime {
@@ -12,7 +13,8 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
                    int initial_growth_chunk_size_bytes,
-                   int64_t max_power_of_two_extend_bytes)
+                   int64_t max_power_of_two_extend_bytes,
+                   int64_t front_cache_max_bytes)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -32,7 +34,8 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " max_power_of_two_extend_bytes: " << max_power_of_two_extend_bytes_
                      << " memory limit: " << total_memory
-                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
+                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy)
+                     << " front_cache_max_bytes: " << front_cache_max_bytes;
 
   // static_cast<std::underlying_type_t<ArenaExtendStrategy>>(arena_extend_strategy); doesn't work on this compiler
 
@@ -75,6 +78,16 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (front_cache_max_bytes > 0) {
+    // Bound the number of size classes, and with it the memory used by the cache itself.
+    constexpr size_t kMaxFrontCacheBytes = 64 * 1024;
+    size_t max_bytes = std::min(static_cast<size_t>(front_cache_max_bytes), kMaxFrontCacheBytes);
+    max_bytes = (max_bytes / kMinAllocationSize) * kMinAllocationSize;
+    if (max_bytes > 0) {
+      front_cache_ = std::make_unique<FrontCache>(max_bytes);
+    }
+  }
 }
 
 BFCArena::~BFCArena() {
@@ -268,7 +281,131 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
   return rounded_bytes;
 }
 
+BFCArena::FrontCache::FrontCache(size_t max_bytes)
+    : max_bytes_(max_bytes),
+      num_classes_(max_bytes / kMinAllocationSize),
+      slots_(std::make_unique<std::atomic<void*>[]>(num_classes_ * kSlotsPerClass)),
+      table_keys_(std::make_unique<std::atomic<void*>[]>(kTableCapacity)),
+      table_classes_(std::make_unique<size_t[]>(kTableCapacity)) {
+  static_assert((kTableCapacity & (kTableCapacity - 1)) == 0, "kTableCapacity must be a power of 2");
+  for (size_t i = 0; i < num_classes_ * kSlotsPerClass; ++i) {
+    slots_[i].store(nullptr, std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < kTableCapacity; ++i) {
+    table_keys_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+// Special keys in the table of the front cache.  Chunk addresses are aligned, so can never take these values.
+static void* const kFrontCacheTombstone = reinterpret_cast<void*>(uintptr_t{1});
+static void* const kFrontCacheBusy = reinterpret_cast<void*>(uintptr_t{2});
+
+size_t BFCArena::FrontCache::TableIndex(const void* p) const {
+  // Drop the low bits, which are mostly zero for aligned chunk addresses, before mixing.
+  uint64_t v = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p) >> 6);
+  return static_cast<size_t>((v * 0x9E3779B97F4A7C15ULL) >> 32) & (kTableCapacity - 1);
+}
+
+unsigned BFCArena::FrontCache::FirstSlot() const {
+  // Spread threads over the slots of a class to reduce contention on the same cache lines.
+  static thread_local const unsigned first_slot =
+      static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  return first_slot % kSlotsPerClass;
+}
+
+std::atomic<void*>* BFCArena::FrontCache::FindEntry(const void* p, size_t* size_class) {
+  size_t idx = TableIndex(p);
+  for (size_t probe = 0; probe < kMaxProbes; ++probe) {
+    void* key = table_keys_[idx].load(std::memory_order_acquire);
+    if (key == nullptr) {
+      break;
+    }
+    if (key == p) {
+      *size_class = table_classes_[idx];
+      return &table_keys_[idx];
+    }
+    idx = (idx + 1) & (kTableCapacity - 1);
+  }
+  return nullptr;
+}
+
+void* BFCArena::FrontCache::Pop(size_t rounded_bytes) {
+  std::atomic<void*>* class_slots = &slots_[SizeClass(rounded_bytes) * kSlotsPerClass];
+  unsigned first = FirstSlot();
+  for (unsigned i = 0; i < kSlotsPerClass; ++i) {
+    std::atomic<void*>& slot = class_slots[(first + i) % kSlotsPerClass];
+    if (slot.load(std::memory_order_relaxed) != nullptr) {
+      void* p = slot.exchange(nullptr, std::memory_order_acquire);
+      if (p != nullptr) {
+        num_hits_.fetch_add(1, std::memory_order_relaxed);
+        return p;
+      }
+    }
+  }
+  num_misses_.fetch_add(1, std::memory_order_relaxed);
+  return nullptr;
+}
+
+bool BFCArena::FrontCache::Register(void* p, size_t rounded_bytes) {
+  size_t idx = TableIndex(p);
+  for (size_t probe = 0; probe < kMaxProbes; ++probe) {
+    void* key = table_keys_[idx].load(std::memory_order_relaxed);
+    if ((key == nullptr || key == kFrontCacheTombstone) &&
+        table_keys_[idx].compare_exchange_strong(key, kFrontCacheBusy, std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) {
+      // The entry is ours.  Only the thread that frees p looks it up, and that
+      // happens after p has been handed out, so publishing the key last is enough.
+      table_classes_[idx] = SizeClass(rounded_bytes);
+      table_keys_[idx].store(p, std::memory_order_release);
+      return true;
+    }
+    idx = (idx + 1) & (kTableCapacity - 1);
+  }
+  return false;
+}
+
+void BFCArena::FrontCache::Unregister(void* p) {
+  size_t size_class = 0;
+  std::atomic<void*>* entry = FindEntry(p, &size_class);
+  if (entry != nullptr) {
+    entry->store(kFrontCacheTombstone, std::memory_order_release);
+  }
+}
+
+bool BFCArena::FrontCache::Push(void* p) {
+  size_t size_class = 0;
+  std::atomic<void*>* entry = FindEntry(p, &size_class);
+  if (entry == nullptr) {
+    return false;
+  }
+  std::atomic<void*>* class_slots = &slots_[size_class * kSlotsPerClass];
+  unsigned first = FirstSlot();
+  for (unsigned i = 0; i < kSlotsPerClass; ++i) {
+    std::atomic<void*>& slot = class_slots[(first + i) % kSlotsPerClass];
+    void* expected = nullptr;
+    if (slot.load(std::memory_order_relaxed) == nullptr &&
+        slot.compare_exchange_strong(expected, p, std::memory_order_release, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  // The size class is full, hand the chunk back to the bins.
+  entry->store(kFrontCacheTombstone, std::memory_order_release);
+  return false;
+}
+
 void* BFCArena::Alloc(size_t size) {
+  if (front_cache_ && size != 0 && size <= front_cache_->max_bytes()) {
+    // Allocate whole size classes so that any parked chunk of the class fits the request.
+    size_t rounded_bytes = RoundedBytes(size);
+    void* p = front_cache_->Pop(rounded_bytes);
+    if (p == nullptr) {
+      p = AllocateRawInternal(rounded_bytes, false, nullptr, false, nullptr);
+      if (p != nullptr) {
+        front_cache_->Register(p, rounded_bytes);
+      }
+    }
+    return p;
+  }
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
@@ -379,6 +516,10 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+  if (front_cache_) {
+    stats->num_front_cache_hits = front_cache_->num_hits();
+    stats->num_front_cache_misses = front_cache_->num_misses();
+  }
 }
 
 BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* free_chunks,
@@ -496,6 +637,9 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+  if (front_cache_ && front_cache_->Push(p)) {
+    return;
+  }
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -510,6 +654,10 @@ void BFCArena::Free(void* p) {
 
 Status BFCArena::Shrink() {
   std::lock_guard<OrtMutex> lock(lock_);
+  if (front_cache_) {
+    // Parked chunks are in use from the point of view of the bins and would keep their regions alive.
+    front_cache_->Drain([this](void* p) { DeallocateRawInternal(p); });
+  }
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
   std::vector<size_t> region_sizes;
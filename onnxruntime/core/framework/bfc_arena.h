@@ -16,6 +16,7 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -61,6 +62,7 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const int64_t DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES = 1024 * 1024 * 1024;  // 1GB
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  static const int64_t DEFAULT_FRONT_CACHE_MAX_BYTES = 0;  // front cache disabled
 
   enum ArenaType {
     BaseArena,
@@ -73,7 +75,8 @@ class BFCArena : public IAllocator {
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
            int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+           int64_t front_cache_max_bytes = DEFAULT_FRONT_CACHE_MAX_BYTES);
 
   ~BFCArena() override;
 
@@ -86,6 +89,7 @@ class BFCArena : public IAllocator {
   void Free(void* p) override;
 
   // Frees all allocation regions in which no chunk is in use.
+  // Chunks parked in the front cache are returned to the bins first.
   // Does not free any reserved chunks.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
@@ -223,6 +227,81 @@ class BFCArena : public IAllocator {
   static const size_t kMinAllocationBits = 8;
   static const size_t kMinAllocationSize = 1 << kMinAllocationBits;
 
+  // FrontCache is a lock-free cache of small chunks that sits in front of
+  // the bins.  Alloc() and Free() of sizes up to the cache limit first try
+  // the cache, and only take lock_ for the best-fit bin search on a miss.
+  //
+  // Chunks handed out by the cache are owned by it for their whole life:
+  // from the point of view of the bins they stay in use, and when freed they
+  // are parked in a slot of their size class (sizes in multiples of
+  // kMinAllocationSize) rather than being coalesced.  Free() recognizes such
+  // chunks through a fixed-capacity open-addressing table of owned pointers.
+  // A chunk goes back to the bins if its size class has no free slot, if the
+  // table is full when it is allocated, or when the cache is drained.
+  //
+  // This class is thread-safe.
+  class FrontCache {
+   public:
+    explicit FrontCache(size_t max_bytes);
+
+    size_t max_bytes() const { return max_bytes_; }
+
+    // Returns a parked chunk for rounded_bytes, or nullptr if none is available.
+    void* Pop(size_t rounded_bytes);
+
+    // Takes ownership of p, a chunk just allocated from the bins for
+    // rounded_bytes.  Returns false if the chunk can not be tracked, in
+    // which case it remains an ordinary chunk of the arena.
+    bool Register(void* p, size_t rounded_bytes);
+
+    // Parks p if it is owned by the cache.  Returns false if p is not owned by
+    // the cache, or if its size class is full (then ownership is released and
+    // the caller must free p to the bins).
+    bool Push(void* p);
+
+    // Releases all parked chunks, calling fn(p) for each of them.
+    template <typename Fn>
+    void Drain(Fn fn) {
+      for (size_t i = 0; i < num_classes_ * kSlotsPerClass; ++i) {
+        void* p = slots_[i].exchange(nullptr, std::memory_order_acquire);
+        if (p != nullptr) {
+          Unregister(p);
+          fn(p);
+        }
+      }
+    }
+
+    int64_t num_hits() const { return num_hits_.load(std::memory_order_relaxed); }
+    int64_t num_misses() const { return num_misses_.load(std::memory_order_relaxed); }
+
+   private:
+    static constexpr size_t kSlotsPerClass = 32;
+    static constexpr size_t kTableCapacity = 4096;  // must be a power of 2
+    static constexpr size_t kMaxProbes = 16;
+
+    size_t SizeClass(size_t rounded_bytes) const { return rounded_bytes / kMinAllocationSize - 1; }
+    size_t TableIndex(const void* p) const;
+    std::atomic<void*>* FindEntry(const void* p, size_t* size_class);
+    void Unregister(void* p);
+    unsigned FirstSlot() const;
+
+    const size_t max_bytes_;
+    const size_t num_classes_;
+
+    // Parked chunks, kSlotsPerClass slots per size class.
+    std::unique_ptr<std::atomic<void*>[]> slots_;
+
+    // Owned pointers and their size class.  An entry is claimed by setting its
+    // key to a busy marker, then the class and finally the pointer are stored.
+    // Released entries are replaced by a tombstone so that probing continues
+    // past them.
+    std::unique_ptr<std::atomic<void*>[]> table_keys_;
+    std::unique_ptr<size_t[]> table_classes_;
+
+    std::atomic<int64_t> num_hits_{0};
+    std::atomic<int64_t> num_misses_{0};
+  };
+
   // AllocationRegion maps pointers to ChunkHandles for a single
   // contiguous memory region.
   //
@@ -509,6 +588,9 @@ class BFCArena : public IAllocator {
   const int initial_growth_chunk_size_bytes_;
   const int64_t max_power_of_two_extend_bytes_;
 
+  // Lock-free front cache for small allocations, or nullptr if disabled.
+  std::unique_ptr<FrontCache> front_cache_;
+
   // This flag is only relevant if Shrink() is invoked.
   // This is a boolean flag that controls whether the first allocation region
   // is to be considered for shrinkage or not.
@@ -0,0 +1,207 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/captured_cpu_graph.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include "core/framework/sequential_execution_plan.h"
+
+namespace onnxruntime {
+
+namespace {
+
+void CopyTensorData(const Tensor& src, Tensor& dst) {
+  if (src.IsDataTypeString()) {
+    auto src_span = src.DataAsSpan<std::string>();
+    std::copy(src_span.begin(), src_span.end(), dst.MutableData<std::string>());
+  } else if (src.DataRaw() != dst.DataRaw()) {
+    std::memcpy(dst.MutableDataRaw(), src.DataRaw(), src.SizeInBytes());
+  }
+}
+
+bool IsCpuTensor(const OrtValue& value) {
+  return value.IsTensor() && value.Get<Tensor>().Location().device.Type() == OrtDevice::CPU;
+}
+
+}  // namespace
+
+bool CapturedCpuGraph::IsSupported(const SessionState& session_state) {
+  const auto* execution_plan = session_state.GetExecutionPlan();
+  // a replay does not record kernel events
+  if (execution_plan == nullptr || session_state.Profiler().IsEnabled()) {
+    return false;
+  }
+
+  const SequentialExecutionPlan::LogicStream* stream = nullptr;
+  for (const auto& logic_stream : execution_plan->execution_plan) {
+    if (logic_stream && !logic_stream->steps_.empty()) {
+      if (stream != nullptr) {
+        return false;
+      }
+      stream = logic_stream.get();
+    }
+  }
+
+  // A single stream has no barrier or notification steps, so it launches every node once.
+  const auto& graph_viewer = session_state.GetGraphViewer();
+  if (stream == nullptr || stream->steps_.size() != static_cast<size_t>(graph_viewer.NumberOfNodes())) {
+    return false;
+  }
+
+  InlinedHashSet<NodeIndex> launched_nodes;
+  launched_nodes.reserve(stream->steps_.size());
+  for (const auto& step : stream->steps_) {
+    const NodeIndex node_index = step->GetNodeIndex();
+    const Node* node = graph_viewer.GetNode(node_index);
+    const OpKernel* kernel = session_state.GetKernel(node_index);
+    if (node == nullptr || kernel == nullptr || !launched_nodes.insert(node_index).second ||
+        node->ContainsSubgraph() || node->GetExecutionProviderType() != kCpuExecutionProvider ||
+        kernel->IsAsync() || kernel->KernelDef().OpName() == "YieldOp") {
+      return false;
+    }
+
+    // The frame only verifies the shapes of tensors. A sequence output is handed back to its kernel holding the
+    // elements of the previous replay, which e.g. SequenceInsert would append to.
+    for (const auto* output_def : node->OutputDefs()) {
+      if (output_def->Exists() &&
+          (output_def->TypeAsProto() == nullptr || !output_def->TypeAsProto()->has_tensor_type())) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+Status CapturedCpuGraph::Capture(const SessionState& session_state,
+                                 gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
+                                 gsl::span<const int> fetch_mlvalue_idxs, std::vector<OrtValue>& fetches,
+                                 const logging::Logger& logger, const bool& terminate_flag,
+                                 std::unique_ptr<CapturedCpuGraph>& captured_graph) {
+  ORT_RETURN_IF_NOT(IsSupported(session_state), "The execution plan of the session can't be captured.");
+  ORT_RETURN_IF_NOT(feeds.size() == feed_mlvalue_idxs.size(), "Expected ", feed_mlvalue_idxs.size(),
+                    " feeds, got ", feeds.size());
+
+  std::unique_ptr<CapturedCpuGraph> graph(new CapturedCpuGraph(session_state));
+  graph->feed_mlvalue_idxs_.assign(feed_mlvalue_idxs.begin(), feed_mlvalue_idxs.end());
+  graph->fetch_mlvalue_idxs_.assign(fetch_mlvalue_idxs.begin(), fetch_mlvalue_idxs.end());
+
+  graph->feeds_.resize(feeds.size());
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    ORT_RETURN_IF_NOT(IsCpuTensor(feeds[i]), "Graph capture requires the feeds to be CPU tensors.");
+    const Tensor& feed = feeds[i].Get<Tensor>();
+    Tensor::InitOrtValue(feed.DataType(), feed.Shape(), session_state.GetAllocator(feed.Location()),
+                         graph->feeds_[i]);
+  }
+
+  // Without pre-allocated fetches, the frame allocates the outputs as well and keeps them.
+  const std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+  graph->frame_ = std::make_unique<ExecutionFrame>(graph->feed_mlvalue_idxs_, graph->feeds_,
+                                                   graph->fetch_mlvalue_idxs_, gsl::span<const OrtValue>{},
+                                                   fetch_allocators,
+#ifdef ORT_ENABLE_STREAM
+                                                   nullptr,
+#endif
+                                                   session_state);
+
+  const auto& stream = *std::find_if(session_state.GetExecutionPlan()->execution_plan.begin(),
+                                     session_state.GetExecutionPlan()->execution_plan.end(),
+                                     [](const auto& logic_stream) {
+                                       return logic_stream && !logic_stream->steps_.empty();
+                                     });
+  graph->kernel_calls_.reserve(stream->steps_.size());
+  for (const auto& step : stream->steps_) {
+    const OpKernel* kernel = session_state.GetKernel(step->GetNodeIndex());
+    graph->kernel_calls_.push_back(
+        {kernel, std::make_unique<OpKernelContextInternal>(session_state, *graph->frame_, *kernel, logger,
+                                                           graph->context_terminate_flag_, nullptr)});
+  }
+
+  // The first replay allocates the values of the frame, which the next ones reuse.
+  ORT_RETURN_IF_ERROR(graph->Replay(feeds, fetches, terminate_flag));
+  captured_graph = std::move(graph);
+  return Status::OK();
+}
+
+bool CapturedCpuGraph::Matches(gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
+                               gsl::span<const int> fetch_mlvalue_idxs) const {
+  if (!std::equal(feed_mlvalue_idxs_.begin(), feed_mlvalue_idxs_.end(),
+                  feed_mlvalue_idxs.begin(), feed_mlvalue_idxs.end()) ||
+      !std::equal(fetch_mlvalue_idxs_.begin(), fetch_mlvalue_idxs_.end(),
+                  fetch_mlvalue_idxs.begin(), fetch_mlvalue_idxs.end()) ||
+      feeds.size() != feeds_.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!IsCpuTensor(feeds[i])) {
+      return false;
+    }
+    const Tensor& feed = feeds[i].Get<Tensor>();
+    const Tensor& captured_feed = feeds_[i].Get<Tensor>();
+    if (feed.DataType() != captured_feed.DataType() || feed.Shape() != captured_feed.Shape()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status CapturedCpuGraph::Replay(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                const bool& terminate_flag) {
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    CopyTensorData(feeds[i].Get<Tensor>(), *feeds_[i].GetMutable<Tensor>());
+  }
+
+  for (auto& call : kernel_calls_) {
+    if (terminate_flag) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+    }
+
+    Status status;
+    ORT_TRY {
+      status = call.kernel->Compute(call.context.get());
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+    if (!status.IsOK()) {
+      const auto& node = call.kernel->Node();
+      return Status(status.Category(), status.Code(),
+                    MakeString("Non-zero status code returned while replaying ", node.OpType(), " node. Name:'",
+                               node.Name(), "' Status Message: ", status.ErrorMessage()));
+    }
+  }
+
+  // The outputs are copied out of the frame, the next replay overwrites its buffers.
+  std::vector<OrtValue> outputs;
+  ORT_RETURN_IF_ERROR(frame_->GetOutputs(outputs));
+  ORT_RETURN_IF_NOT(fetches.empty() || fetches.size() == outputs.size(), "Expected ", outputs.size(),
+                    " fetches, got ", fetches.size());
+
+  std::vector<OrtValue> results(outputs.size());
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    ORT_RETURN_IF_NOT(IsCpuTensor(outputs[i]), "Graph capture only supports CPU tensor outputs.");
+    const Tensor& output = outputs[i].Get<Tensor>();
+    if (!fetches.empty() && fetches[i].IsAllocated()) {
+      ORT_RETURN_IF_NOT(IsCpuTensor(fetches[i]) && fetches[i].Get<Tensor>().Shape() == output.Shape() &&
+                            fetches[i].Get<Tensor>().DataType() == output.DataType(),
+                        "The pre-allocated fetch ", i, " does not match the output of the captured graph.");
+      results[i] = fetches[i];
+    } else {
+      Tensor::InitOrtValue(output.DataType(), output.Shape(), session_state_.GetAllocator(output.Location()),
+                           results[i]);
+    }
+    CopyTensorData(output, *results[i].GetMutable<Tensor>());
+  }
+
+  fetches = std::move(results);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/logging/logging.h"
+#include "core/common/status.h"
+#include "core/framework/execution_frame.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/session_state.h"
+
+namespace onnxruntime {
+
+/**
+The CPU counterpart of a CUDA graph: the kernel calls of a run, bound once to their inputs and outputs, replayed by
+later runs with the same input shapes without going through the executor.
+
+Capturing runs the plan once in an execution frame the captured graph keeps. Its values are never released, so
+every kernel output keeps the buffer it got from the memory pattern, and the contexts of the kernel calls are created
+once. A replay copies the feeds into the buffers the captured graph owns, calls the kernels in the order of the plan
+and copies the outputs out, so the values returned by a replay are not overwritten by the next one.
+
+A session can be captured when all its nodes run on the CPU execution provider, it has no control flow nodes, all
+its node outputs are dense tensors and its plan is a single stream of kernel launches. Kernels may not change the shapes of their outputs between calls
+with the same input shapes: a replay where they do fails on the shape verification of the frame.
+*/
+class CapturedCpuGraph {
+ public:
+  /** Returns true if the plan of the session can be captured. */
+  static bool IsSupported(const SessionState& session_state);
+
+  /**
+  Captures the graph by running it with the feeds, and returns the fetches of the run.
+  The feeds must be CPU tensors.
+  */
+  static Status Capture(const SessionState& session_state,
+                        gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
+                        gsl::span<const int> fetch_mlvalue_idxs, std::vector<OrtValue>& fetches,
+                        const logging::Logger& logger, const bool& terminate_flag,
+                        std::unique_ptr<CapturedCpuGraph>& captured_graph);
+
+  /** Returns true if the run has the feeds, the fetches and the input shapes and types of the captured one. */
+  bool Matches(gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
+               gsl::span<const int> fetch_mlvalue_idxs) const;
+
+  /** Replays the kernel calls with the feeds. The caller checks that the run matches the captured one. */
+  Status Replay(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches, const bool& terminate_flag);
+
+  size_t NumKernelCalls() const { return kernel_calls_.size(); }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CapturedCpuGraph);
+
+  explicit CapturedCpuGraph(const SessionState& session_state) : session_state_(session_state) {}
+
+  struct KernelCall {
+    const OpKernel* kernel;
+    std::unique_ptr<OpKernelContextInternal> context;
+  };
+
+  const SessionState& session_state_;
+
+  InlinedVector<int> feed_mlvalue_idxs_;
+  InlinedVector<int> fetch_mlvalue_idxs_;
+
+  // Copies of the feeds of the captured run, bound to the frame. Replays copy their feeds into them.
+  std::vector<OrtValue> feeds_;
+  std::unique_ptr<ExecutionFrame> frame_;
+
+  // The contexts hold a reference to the terminate flag. The flag of the run is checked between the kernel calls.
+  bool context_terminate_flag_ = false;
+  std::vector<KernelCall> kernel_calls_;
+};
+
+}  // namespace onnxruntime
@@ -356,8 +356,7 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 #ifdef ORT_ENABLE_STREAM
       device_streams_(device_streams),
 #endif
-      session_state_(session_state),
-      mem_patterns_(nullptr) {
+      session_state_(session_state) {
   Init(
       feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(),
 #if !defined(DISABLE_SPARSE_TENSORS)
@@ -406,11 +405,14 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 
     // if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_);
-      // if no existing patterns, generate one in this execution frame
-      if (!mem_patterns_) {
+      bool update_patterns = false;
+      mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feed_mlvalue_idxs, inferred_shapes_,
+                                                          update_patterns);
+      // if no existing patterns, or the patterns of the shape bucket are too small, generate one in this execution frame
+      if (!mem_patterns_ || update_patterns) {
         planner_.emplace(*session_state.GetExecutionPlan());
-      } else {
+      }
+      if (mem_patterns_) {
         // pre-allocate the big chunk requested in memory pattern.
         // all the internal kernel's input/output tensors will be allocated on these buffer.
         buffers_.reserve(mem_patterns_->locations.size());
@@ -548,14 +550,21 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       if (block) {
         auto it = buffers_.find(location);
         if (it != buffers_.end()) {
-          // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
+          // if the block is not correct, log message then fall back to default behavior.
+          // the pattern of a shape bucket is traced from the largest sizes seen, so any block that is large enough will do.
+          if (block->size_ == size || (block->size_ > size && session_state_.GetMemoryPatternShapeBucketing())) {
             void* buffer = it->second.get();
             auto status = AllocateTensorWithPreAllocateBufferHelper(
                 ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
                 shape);
+            if (status.IsOK() && !utils::IsDataTypeString(element_type)) {
+              TraceAllocate(ort_value_index, size);
+            }
             return status;
           } else {
+            if (block->size_ < size && session_state_.GetMemoryPatternShapeBucketing()) {
+              mem_patterns_too_small_.store(true, std::memory_order_relaxed);
+            }
             // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
             // fed in, so use VERBOSE as the log level as it's expected.
             // TODO: Should we reuse the block if the size is large enough? Would probably need to allow it
@@ -892,6 +901,14 @@ void ExecutionFrame::TraceAllocate(int ort_value_idx, size_t size) {
         allocation_plan.alloc_kind == AllocKind::kAllocatedExternally) {
       return;
     }
+    if (mem_patterns_) {
+      // growing the pattern of a shape bucket, keep the blocks at least as large as they were.
+      const auto* pattern = mem_patterns_->GetPatterns(allocation_plan.location);
+      const auto* block = pattern ? pattern->GetBlock(ort_value_idx) : nullptr;
+      if (block) {
+        size = std::max(size, block->size_);
+      }
+    }
     auto status = planner_->TraceAllocation(ort_value_idx, size);
     if (!status.IsOK()) {
       LOGS(session_state_.Logger(), WARNING) << "TraceAllocation for ort_value_idx=" << ort_value_idx
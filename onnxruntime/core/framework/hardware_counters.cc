@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/hardware_counters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+namespace onnxruntime {
+
+#if defined(__linux__)
+namespace {
+
+int OpenCounter(uint64_t config) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // pid 0 and cpu -1 count the calling thread on any cpu
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+}  // namespace
+
+HardwareCounters::HardwareCounters() {
+  fds_[kCycles] = OpenCounter(PERF_COUNT_HW_CPU_CYCLES);
+  fds_[kInstructions] = OpenCounter(PERF_COUNT_HW_INSTRUCTIONS);
+  fds_[kLastLevelCacheMisses] = OpenCounter(PERF_COUNT_HW_CACHE_MISSES);
+}
+
+HardwareCounters::~HardwareCounters() {
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+uint64_t HardwareCounters::Read(Counter counter) const {
+  uint64_t value = 0;
+  if (fds_[counter] < 0 || read(fds_[counter], &value, sizeof(value)) != sizeof(value)) {
+    return 0;
+  }
+  return value;
+}
+#else
+HardwareCounters::HardwareCounters() {
+  for (int& fd : fds_) {
+    fd = -1;
+  }
+}
+
+HardwareCounters::~HardwareCounters() = default;
+
+uint64_t HardwareCounters::Read(Counter /*counter*/) const {
+  return 0;
+}
+#endif
+
+HardwareCounters& HardwareCounters::ForCurrentThread() {
+  thread_local HardwareCounters counters;
+  return counters;
+}
+
+const char* HardwareCounters::Name(Counter counter) {
+  switch (counter) {
+    case kCycles:
+      return "cycles";
+    case kInstructions:
+      return "instructions";
+    case kLastLevelCacheMisses:
+      return "llc_misses";
+    default:
+      return "unknown";
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+
+/**
+Hardware performance counters of the calling thread, read from the Linux perf_event interface.
+Only the thread running the kernel is counted, not the threads of the intra op thread pool it schedules work on.
+A counter is unavailable on other platforms, on hardware or virtual machines not exposing it, or when
+/proc/sys/kernel/perf_event_paranoid does not allow user processes to read it.
+*/
+class HardwareCounters {
+ public:
+  enum Counter {
+    kCycles = 0,
+    kInstructions,
+    kLastLevelCacheMisses,
+    kNumCounters,
+  };
+
+  /** The counters of the calling thread, opened on the first call from that thread. */
+  static HardwareCounters& ForCurrentThread();
+
+  ~HardwareCounters();
+
+  bool IsAvailable(Counter counter) const { return fds_[counter] >= 0; }
+
+  /** Value of the counter since it was opened, 0 if it is unavailable. */
+  uint64_t Read(Counter counter) const;
+
+  static const char* Name(Counter counter);
+
+ private:
+  HardwareCounters();
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(HardwareCounters);
+
+  int fds_[kNumCounters];
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_cost_estimator.h"
+
+#include <string_view>
+
+#include "core/common/inlined_containers.h"
+
+namespace onnxruntime {
+
+namespace {
+
+enum class OpCostKind {
+  MatMul,         // 2 * output elements * K, A is the first input
+  Gemm,           // 2 * M * N * K, A is the first input
+  Conv,           // 2 * output elements * weight elements / output channels
+  ConvTranspose,  // 2 * input elements * weight elements / input channels
+  Elementwise,    // 1 per output element
+  Reduction,      // 1 per input element
+  Normalization,  // 5 per input element
+};
+
+struct OpCost {
+  OpCostKind kind;
+  int weight_index;  // input holding the weights of a convolution
+};
+
+const InlinedHashMap<std::string_view, OpCost>& OpCosts() {
+  static const InlinedHashMap<std::string_view, OpCost> op_costs = [] {
+    InlinedHashMap<std::string_view, OpCost> costs;
+    for (std::string_view op : {"MatMul", "MatMulInteger", "QLinearMatMul", "FusedMatMul",
+                                "MatMulIntegerToFloat", "DynamicQuantizeMatMul"}) {
+      costs[op] = {OpCostKind::MatMul, 0};
+    }
+    for (std::string_view op : {"Gemm", "FusedGemm", "QGemm"}) {
+      costs[op] = {OpCostKind::Gemm, 0};
+    }
+    for (std::string_view op : {"Conv", "ConvInteger", "FusedConv"}) {
+      costs[op] = {OpCostKind::Conv, 1};
+    }
+    costs["QLinearConv"] = {OpCostKind::Conv, 3};
+    costs["ConvTranspose"] = {OpCostKind::ConvTranspose, 1};
+    for (std::string_view op : {"Add", "Sub", "Mul", "Div", "Pow", "Max", "Min", "Mean", "Sum", "Abs", "Neg",
+                                "Exp", "Log", "Sqrt", "Reciprocal", "Relu", "LeakyRelu", "Sigmoid", "Tanh", "Erf",
+                                "Gelu", "FastGelu", "QuickGelu", "BiasGelu", "Clip", "HardSigmoid", "Elu", "Selu",
+                                "Softplus", "Where", "Equal", "Less", "Greater", "LessOrEqual", "GreaterOrEqual",
+                                "Not", "And", "Or", "Cast", "QuantizeLinear", "DequantizeLinear"}) {
+      costs[op] = {OpCostKind::Elementwise, 0};
+    }
+    for (std::string_view op : {"ReduceSum", "ReduceMean", "ReduceMax", "ReduceMin", "ReduceProd", "ReduceL1",
+                                "ReduceL2", "ReduceSumSquare", "GlobalAveragePool", "GlobalMaxPool"}) {
+      costs[op] = {OpCostKind::Reduction, 0};
+    }
+    for (std::string_view op : {"Softmax", "LogSoftmax", "LayerNormalization", "SimplifiedLayerNormalization",
+                                "SkipLayerNormalization", "SkipSimplifiedLayerNormalization",
+                                "BatchNormalization", "InstanceNormalization", "GroupNorm"}) {
+      costs[op] = {OpCostKind::Normalization, 0};
+    }
+    return costs;
+  }();
+  return op_costs;
+}
+
+const TensorShape* GetShape(gsl::span<const TensorShape* const> shapes, size_t index) {
+  return index < shapes.size() ? shapes[index] : nullptr;
+}
+
+}  // namespace
+
+int64_t EstimateOpFlops(const std::string& op_type,
+                        gsl::span<const TensorShape* const> input_shapes,
+                        gsl::span<const TensorShape* const> output_shapes) {
+  const auto& op_costs = OpCosts();
+  const auto it = op_costs.find(op_type);
+  if (it == op_costs.end()) {
+    return -1;
+  }
+
+  const TensorShape* input = GetShape(input_shapes, 0);
+  const TensorShape* output = GetShape(output_shapes, 0);
+  switch (it->second.kind) {
+    case OpCostKind::MatMul:
+      if (input == nullptr || output == nullptr || input->NumDimensions() == 0) {
+        return -1;
+      }
+      return 2 * output->Size() * input->GetDims().back();
+    case OpCostKind::Gemm:
+      if (input == nullptr || output == nullptr || output->NumDimensions() != 2 || (*output)[0] == 0) {
+        return -1;
+      }
+      // A is MxK or KxM when transposed
+      return 2 * output->Size() * (input->Size() / (*output)[0]);
+    case OpCostKind::Conv:
+    case OpCostKind::ConvTranspose: {
+      const TensorShape* weight = GetShape(input_shapes, it->second.weight_index);
+      const TensorShape* counted = it->second.kind == OpCostKind::Conv ? output : input;
+      if (weight == nullptr || counted == nullptr || weight->NumDimensions() == 0 || (*weight)[0] == 0) {
+        return -1;
+      }
+      // every element of the output of a convolution (input of a transposed one) is a dot product over
+      // C / group * kernel size weights
+      return 2 * counted->Size() * (weight->Size() / (*weight)[0]);
+    }
+    case OpCostKind::Elementwise:
+      return output != nullptr ? output->Size() : -1;
+    case OpCostKind::Reduction:
+      return input != nullptr ? input->Size() : -1;
+    case OpCostKind::Normalization:
+      return input != nullptr ? 5 * input->Size() : -1;
+  }
+  return -1;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include <gsl/gsl>
+
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+
+/**
+Estimates the number of arithmetic operations run by a kernel from the shapes of its inputs and outputs, a multiply
+and an add counting as two. Matrix multiplications and convolutions are exact, elementwise operators count one
+operation per output element and normalizations a few per input element.
+The profiler divides it by the bytes read and written to place the kernel on a roofline.
+
+@param op_type The operator type of the node.
+@param input_shapes The shapes of the inputs, nullptr for a missing input or one that is not a tensor.
+@param output_shapes The shapes of the outputs, nullptr for a missing output or one that is not a tensor.
+@returns The estimated number of operations, or -1 if the operator or the shapes are not handled.
+*/
+int64_t EstimateOpFlops(const std::string& op_type,
+                        gsl::span<const TensorShape* const> input_shapes,
+                        gsl::span<const TensorShape* const> output_shapes);
+
+}  // namespace onnxruntime
@@ -0,0 +1,289 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_file_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include "core/common/cpuid_info.h"
+#include "core/common/narrow.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph.h"
+#include "core/mlas/inc/mlas.h"
+#include "onnxruntime_config.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// File layout, all integers are uint64_t in the byte order of the host:
+//   magic, length and content of the CPU signature, number of entries,
+//   for each entry: length and content of the key, number of buffers, offset and size of each buffer,
+//   the content of the buffers, each at an offset aligned to kBufferAlignment.
+constexpr char kMagic[8] = {'O', 'R', 'T', 'P', 'A', 'C', 'K', '1'};
+
+// The mapping of the file is page aligned, so this makes the buffers as aligned as the ones of the allocators.
+constexpr uint64_t kBufferAlignment = 64;
+
+// Identifies the layout of the pre-packed weights, which depends on the kernels of this version of onnxruntime and
+// on the instruction sets MLAS uses on this CPU.
+std::string GetCpuSignature() {
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  std::ostringstream ss;
+  ss << ORT_VERSION << ";" << MlasGetPreferredBufferAlignment() << ";"
+     << cpuid_info.HasSSE3() << cpuid_info.HasSSE4_1() << cpuid_info.HasAVX() << cpuid_info.HasAVX2()
+     << cpuid_info.HasAVX512f() << cpuid_info.HasAVX512Skylake() << cpuid_info.HasAVX512_BF16()
+     << cpuid_info.HasAMX_BF16() << cpuid_info.HasF16C() << cpuid_info.HasFp16VectorAcceleration()
+     << cpuid_info.HasArmNeonDot() << cpuid_info.HasArmNeon_I8MM() << cpuid_info.HasArmSVE_I8MM()
+     << cpuid_info.HasArmNeon_BF16();
+  return ss.str();
+}
+
+// 128-bit MurmurHash3 of data of any size, chained into hash
+void HashBytes(const void* data, size_t len, uint32_t (&hash)[4]) {
+  constexpr size_t kMaxChunkSize = size_t{1} << 30;
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  do {
+    const size_t chunk_size = std::min(len, kMaxChunkSize);
+    MurmurHash3::x86_128(bytes, static_cast<int>(chunk_size), hash[0], &hash);
+    bytes += chunk_size;
+    len -= chunk_size;
+  } while (len > 0);
+}
+
+std::string HashToString(const uint32_t (&hash)[4]) {
+  std::ostringstream ss;
+  ss << std::hex << std::setfill('0');
+  for (uint32_t h : hash) {
+    ss << std::setw(8) << h;
+  }
+  return ss.str();
+}
+
+uint64_t AlignOffset(uint64_t offset) {
+  return (offset + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+}
+
+// Reads the content of the mapped cache file, failing on any read past its end
+class CacheFileReader {
+ public:
+  CacheFileReader(const char* data, uint64_t size) : data_(data), size_(size) {}
+
+  Status Read(void* out, uint64_t len) {
+    ORT_RETURN_IF(len > size_ - offset_, "Unexpected end of the pre-packed weights cache file.");
+    memcpy(out, data_ + offset_, narrow<size_t>(len));
+    offset_ += len;
+    return Status::OK();
+  }
+
+  Status Read(uint64_t& value) {
+    return Read(&value, sizeof(value));
+  }
+
+  Status Read(std::string& str) {
+    uint64_t len = 0;
+    ORT_RETURN_IF_ERROR(Read(len));
+    ORT_RETURN_IF(len > size_ - offset_, "Unexpected end of the pre-packed weights cache file.");
+    str.assign(data_ + offset_, narrow<size_t>(len));
+    offset_ += len;
+    return Status::OK();
+  }
+
+ private:
+  const char* const data_;
+  const uint64_t size_;
+  uint64_t offset_ = 0;
+};
+
+void Write(std::ostream& out, uint64_t value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void Write(std::ostream& out, const std::string& str) {
+  Write(out, static_cast<uint64_t>(str.size()));
+  out.write(str.data(), str.size());
+}
+
+}  // namespace
+
+Status PrepackedWeightsFileCache::Load() {
+  prepacked_weights_map_.clear();
+  mapped_file_.reset();
+  has_new_weights_ = false;
+
+  std::error_code error_code;
+  const uint64_t file_size = std::filesystem::file_size(file_path_, error_code);
+  if (error_code) {
+    // nothing cached yet
+    return Status::OK();
+  }
+
+  Env::MappedMemoryPtr mapped_file;
+  if (file_size > 0) {
+    ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(file_path_.c_str(), 0, narrow<size_t>(file_size),
+                                                         mapped_file));
+  }
+
+  CacheFileReader reader(mapped_file.get(), file_size);
+  char magic[sizeof(kMagic)];
+  ORT_RETURN_IF_ERROR(reader.Read(magic, sizeof(magic)));
+  ORT_RETURN_IF(memcmp(magic, kMagic, sizeof(kMagic)) != 0, "Not a pre-packed weights cache file.");
+
+  std::string cpu_signature;
+  ORT_RETURN_IF_ERROR(reader.Read(cpu_signature));
+  ORT_RETURN_IF(cpu_signature != GetCpuSignature(),
+                "The pre-packed weights cache file was written by another version of onnxruntime or on another CPU.");
+
+  uint64_t num_entries = 0;
+  ORT_RETURN_IF_ERROR(reader.Read(num_entries));
+
+  std::unordered_map<std::string, PrePackedWeights> prepacked_weights_map;
+  for (uint64_t entry = 0; entry < num_entries; ++entry) {
+    std::string key;
+    uint64_t num_buffers = 0;
+    ORT_RETURN_IF_ERROR(reader.Read(key));
+    ORT_RETURN_IF_ERROR(reader.Read(num_buffers));
+
+    PrePackedWeights weights;
+    for (uint64_t buffer = 0; buffer < num_buffers; ++buffer) {
+      uint64_t offset = 0;
+      uint64_t size = 0;
+      ORT_RETURN_IF_ERROR(reader.Read(offset));
+      ORT_RETURN_IF_ERROR(reader.Read(size));
+      ORT_RETURN_IF(offset > file_size || size > file_size - offset,
+                    "Pre-packed weight ", key, " is out of bounds of the cache file.");
+
+      // the buffers point into the mapped file, which is released after them
+      void* data = size > 0 ? mapped_file.get() + offset : nullptr;
+      weights.buffers_.push_back(IAllocatorUniquePtr<void>(data, [](void*) {}));
+      weights.buffer_sizes_.push_back(narrow<size_t>(size));
+    }
+
+    prepacked_weights_map.insert_or_assign(std::move(key), std::move(weights));
+  }
+
+  mapped_file_ = std::move(mapped_file);
+  prepacked_weights_map_ = std::move(prepacked_weights_map);
+  return Status::OK();
+}
+
+Status PrepackedWeightsFileCache::Save() const {
+  if (!has_new_weights_) {
+    return Status::OK();
+  }
+
+  // write the entries in a stable order
+  std::map<std::string_view, const PrePackedWeights*> entries;
+  for (const auto& [key, weights] : prepacked_weights_map_) {
+    entries.emplace(key, &weights);
+  }
+
+  const std::string cpu_signature = GetCpuSignature();
+
+  uint64_t header_size = sizeof(kMagic) + sizeof(uint64_t) + cpu_signature.size() + sizeof(uint64_t);
+  for (const auto& [key, weights] : entries) {
+    header_size += sizeof(uint64_t) + key.size() + sizeof(uint64_t) + weights->buffers_.size() * 2 * sizeof(uint64_t);
+  }
+
+  // write into a file of this instance, then replace the cache file with it
+  std::filesystem::path temp_file_path = file_path_;
+  temp_file_path += "." + std::to_string(Env::Default().GetSelfPid()) + "." +
+                    std::to_string(reinterpret_cast<uintptr_t>(this)) + ".tmp";
+  {
+    std::ofstream out(temp_file_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF(!out, "Failed to create the pre-packed weights cache file ", temp_file_path.string());
+
+    out.write(kMagic, sizeof(kMagic));
+    Write(out, cpu_signature);
+    Write(out, static_cast<uint64_t>(entries.size()));
+
+    uint64_t offset = AlignOffset(header_size);
+    for (const auto& [key, weights] : entries) {
+      Write(out, std::string(key));
+      Write(out, static_cast<uint64_t>(weights->buffers_.size()));
+      for (size_t i = 0; i < weights->buffers_.size(); ++i) {
+        const uint64_t size = weights->buffers_[i] != nullptr ? weights->buffer_sizes_[i] : 0;
+        Write(out, size > 0 ? offset : 0);
+        Write(out, size);
+        offset = AlignOffset(offset + size);
+      }
+    }
+
+    uint64_t written = header_size;
+    const char padding[kBufferAlignment] = {};
+    for (const auto& [key, weights] : entries) {
+      for (size_t i = 0; i < weights->buffers_.size(); ++i) {
+        const uint64_t size = weights->buffers_[i] != nullptr ? weights->buffer_sizes_[i] : 0;
+        if (size == 0) {
+          continue;
+        }
+        out.write(padding, narrow<std::streamsize>(AlignOffset(written) - written));
+        out.write(static_cast<const char*>(weights->buffers_[i].get()), narrow<std::streamsize>(size));
+        written = AlignOffset(written) + size;
+      }
+    }
+
+    out.flush();
+    ORT_RETURN_IF(!out, "Failed to write the pre-packed weights cache file ", temp_file_path.string());
+  }
+
+  std::error_code error_code;
+  std::filesystem::rename(temp_file_path, file_path_, error_code);
+  if (error_code) {
+    std::filesystem::remove(temp_file_path, error_code);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to replace the pre-packed weights cache file ",
+                           std::filesystem::path(file_path_).string());
+  }
+
+  return Status::OK();
+}
+
+std::string PrepackedWeightsFileCache::GenerateKey(const Node& node, int input_idx, const Tensor& tensor) {
+  // the pre-packed weights may depend on the attributes and on the types of the other inputs of the node
+  uint32_t node_hash[4] = {0, 0, 0, 0};
+  for (const auto* input_def : node.InputDefs()) {
+    const std::string* type = input_def->Exists() ? input_def->Type() : nullptr;
+    const std::string type_str = type != nullptr ? *type : std::string();
+    HashBytes(type_str.data(), type_str.size() + 1, node_hash);
+  }
+
+  const auto& attributes = node.GetAttributes();
+  std::map<std::string_view, const ONNX_NAMESPACE::AttributeProto*> sorted_attributes;
+  for (const auto& [name, attribute] : attributes) {
+    sorted_attributes.emplace(name, &attribute);
+  }
+  for (const auto& [name, attribute] : sorted_attributes) {
+    const std::string serialized = attribute->SerializeAsString();
+    HashBytes(name.data(), name.size(), node_hash);
+    HashBytes(serialized.data(), serialized.size(), node_hash);
+  }
+
+  uint32_t tensor_hash[4] = {0, 0, 0, 0};
+  HashBytes(tensor.DataRaw(), tensor.SizeInBytes(), tensor_hash);
+
+  std::ostringstream ss;
+  ss << node.Domain() << ":" << node.OpType() << ":" << node.SinceVersion() << ":"
+     << node.GetExecutionProviderType() << "+" << input_idx << "+" << HashToString(node_hash) << "+"
+     << DataTypeImpl::ToString(tensor.DataType()) << tensor.Shape().ToString() << "+" << HashToString(tensor_hash);
+  return ss.str();
+}
+
+const PrePackedWeights* PrepackedWeightsFileCache::GetWeight(const std::string& key) const {
+  auto iter = prepacked_weights_map_.find(key);
+  return iter != prepacked_weights_map_.end() ? &iter->second : nullptr;
+}
+
+const PrePackedWeights& PrepackedWeightsFileCache::WriteWeight(const std::string& key,
+                                                               PrePackedWeights&& packed_weight) {
+  has_new_weights_ = true;
+  return prepacked_weights_map_.insert_or_assign(key, std::move(packed_weight)).first->second;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/platform/env.h"
+#include "core/platform/path_lib.h"
+
+namespace onnxruntime {
+
+class Node;
+class Tensor;
+
+// Persistent cache of pre-packed weights, stored in a file next to the model so that kernels of later sessions
+// of the model, in this or another process, can use the pre-packed weights instead of calling PrePack() again.
+// The file is memory mapped, so the pre-packed weights read from it are shared by all the processes using them.
+// The entries are keyed by the node, the input index and the content of the constant initializer (see GenerateKey()).
+// The whole file is ignored if it was written by another version of onnxruntime or on a CPU with other features,
+// as the layout of the pre-packed weights may differ.
+class PrepackedWeightsFileCache final {
+ public:
+  explicit PrepackedWeightsFileCache(std::basic_string<PATH_CHAR_TYPE> file_path)
+      : file_path_(std::move(file_path)) {}
+
+  // Reads the entries of the cache file if it exists.
+  // If the file can not be used, the cache is left empty and an error is returned for logging.
+  // The file is then replaced by the next call to Save().
+  Status Load();
+
+  // Writes all the entries to the cache file if any were added since Load().
+  // The file is replaced atomically, so processes concurrently reading it are not affected.
+  Status Save() const;
+
+  // Returns the key of the pre-packed weights for the input of the node, given the constant initializer for it.
+  static std::string GenerateKey(const Node& node, int input_idx, const Tensor& tensor);
+
+  // Returns the pre-packed weights for the key or nullptr if the cache has none.
+  const PrePackedWeights* GetWeight(const std::string& key) const;
+
+  // Adds the pre-packed weights for the key and returns the cached instance.
+  const PrePackedWeights& WriteWeight(const std::string& key, PrePackedWeights&& packed_weight);
+
+  // Returns the number of elements in the cache
+  size_t GetNumberOfElements() const {
+    return prepacked_weights_map_.size();
+  }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsFileCache);
+
+ private:
+  const std::basic_string<PATH_CHAR_TYPE> file_path_;
+
+  // Mapping of the cache file, the buffers of the entries read from it point into it.
+  // Declared ahead of the map so it is released after the entries pointing into it.
+  Env::MappedMemoryPtr mapped_file_;
+
+  std::unordered_map<std::string, PrePackedWeights> prepacked_weights_map_;
+
+  // true if entries were added since the cache file was read
+  bool has_new_weights_ = false;
+};
+
+}  // namespace onnxruntime
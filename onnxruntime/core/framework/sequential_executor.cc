@@ -11,10 +11,13 @@
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/hardware_counters.h"
+#include "core/framework/op_cost_estimator.h"
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 #if defined DEBUG_NODE_INPUTS_OUTPUTS
 #include "core/framework/debug_node_inputs_outputs_utils.h"
@@ -178,6 +181,8 @@ class SessionScope {
   {
     if (session_state_.Profiler().IsEnabled()) {
       session_start_ = session_state.Profiler().Start();
+      profile_hardware_counters_ = session_state_.GetSessionOptions().config_options.GetConfigOrDefault(
+                                       kOrtSessionOptionsConfigProfileHardwareCounters, "0") == "1";
     }
 
     auto& logger = session_state_.Logger();
@@ -250,6 +255,7 @@ class SessionScope {
  private:
   const SessionState& session_state_;
   TimePoint session_start_;
+  bool profile_hardware_counters_{false};
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   const ExecutionFrame& frame_;
   // Whether memory profiler need create events and flush to file.
@@ -351,6 +357,12 @@ class KernelScope {
       CalculateTotalInputSizes(&kernel_context, &kernel_,
                                input_activation_sizes_, input_parameter_sizes_,
                                node_name_, input_type_shape_);
+      if (session_scope_.profile_hardware_counters_) {
+        const auto& counters = HardwareCounters::ForCurrentThread();
+        for (int i = 0; i < HardwareCounters::kNumCounters; ++i) {
+          counters_begin_[i] = counters.Read(static_cast<HardwareCounters::Counter>(i));
+        }
+      }
     }
   }
 
@@ -363,24 +375,44 @@ class KernelScope {
 
     if (session_state_.Profiler().IsEnabled()) {
       auto& profiler = session_state_.Profiler();
+      // Log additional operation args / info.
+      std::unordered_map<std::string, std::string> event_args;
+      if (session_scope_.profile_hardware_counters_) {
+        const auto& counters = HardwareCounters::ForCurrentThread();
+        for (int i = 0; i < HardwareCounters::kNumCounters; ++i) {
+          const auto counter = static_cast<HardwareCounters::Counter>(i);
+          if (counters.IsAvailable(counter)) {
+            event_args[HardwareCounters::Name(counter)] = std::to_string(counters.Read(counter) - counters_begin_[i]);
+          }
+        }
+      }
+
       std::string output_type_shape_;
       CalculateTotalOutputSizes(&kernel_context_, total_output_sizes_, node_name_, output_type_shape_);
+      const int64_t flops = EstimateFlops();
+      if (flops >= 0) {
+        const size_t total_bytes = input_activation_sizes_ + input_parameter_sizes_ + total_output_sizes_;
+        event_args["flops"] = std::to_string(flops);
+        event_args["arithmetic_intensity"] =
+            std::to_string(total_bytes > 0 ? static_cast<double>(flops) / static_cast<double>(total_bytes) : 0.0);
+      }
+
+      event_args.insert({
+          {"op_name", kernel_.KernelDef().OpName()},
+          {"provider", kernel_.KernelDef().Provider()},
+          {"node_index", std::to_string(kernel_.Node().Index())},
+          {"activation_size", std::to_string(input_activation_sizes_)},
+          {"parameter_size", std::to_string(input_parameter_sizes_)},
+          {"output_size", std::to_string(total_output_sizes_)},
+          {"input_type_shape", input_type_shape_},
+          {"output_type_shape", output_type_shape_},
+          {"thread_scheduling_stats",
+           concurrency::ThreadPool::StopProfiling(session_state_.GetThreadPool())},
+      });
       profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                      node_name_ + "_kernel_time",
                                      kernel_begin_time_,
-                                     // Log additional operation args / info.
-                                     {
-                                         {"op_name", kernel_.KernelDef().OpName()},
-                                         {"provider", kernel_.KernelDef().Provider()},
-                                         {"node_index", std::to_string(kernel_.Node().Index())},
-                                         {"activation_size", std::to_string(input_activation_sizes_)},
-                                         {"parameter_size", std::to_string(input_parameter_sizes_)},
-                                         {"output_size", std::to_string(total_output_sizes_)},
-                                         {"input_type_shape", input_type_shape_},
-                                         {"output_type_shape", output_type_shape_},
-                                         {"thread_scheduling_stats",
-                                          concurrency::ThreadPool::StopProfiling(session_state_.GetThreadPool())},
-                                     });
+                                     std::move(event_args));
       auto sync_time_begin = profiler.Start();
       profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                      node_name_ + "_fence_after",
@@ -408,6 +440,21 @@ class KernelScope {
   }  //~KernelScope
 
  private:
+  int64_t EstimateFlops() const {
+    auto shape_of = [](const OrtValue* value) {
+      return value != nullptr && value->IsTensor() ? &value->Get<Tensor>().Shape() : nullptr;
+    };
+    InlinedVector<const TensorShape*> input_shapes;
+    for (int i = 0; i < kernel_context_.InputCount(); ++i) {
+      input_shapes.push_back(shape_of(kernel_context_.GetInputMLValue(i)));
+    }
+    InlinedVector<const TensorShape*> output_shapes;
+    for (int i = 0; i < kernel_context_.OutputCount(); ++i) {
+      output_shapes.push_back(shape_of(kernel_context_.GetOutputMLValue(i)));
+    }
+    return EstimateOpFlops(kernel_.Node().OpType(), input_shapes, output_shapes);
+  }
+
   TimePoint kernel_begin_time_;
   SessionScope& session_scope_;
   const SessionState& session_state_;
@@ -419,6 +466,7 @@ class KernelScope {
   size_t input_parameter_sizes_{};
   size_t total_output_sizes_{};
   std::string input_type_shape_;
+  uint64_t counters_begin_[HardwareCounters::kNumCounters]{};
 
 #ifdef CONCURRENCY_VISUALIZER
   diagnostic::span span_;
@@ -608,6 +656,9 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
       ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GeneratePatterns(mem_patterns));
       ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
     }
+  } else if (ctx.GetExecutionFrame().MemoryPatternsTooSmall()) {
+    // let the next run with input shapes of the same bucket trace larger patterns.
+    session_state.MarkMemoryPatternGroupForUpdate(feeds);
   }
 
   return Status::OK();
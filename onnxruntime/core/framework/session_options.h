@@ -26,6 +26,7 @@ enum class ExecutionOrder {
   DEFAULT = 0,           // default topological sort
   PRIORITY_BASED = 1,    // priority-based topological sort
   MEMORY_EFFICIENT = 2,  // memory-efficient topological sort for training purposes.
+  MEMORY_AWARE = 3,      // topological sort reducing the peak size of the live tensors.
 };
 
 inline std::ostream& operator<<(std::ostream& os, const ExecutionOrder& order) {
@@ -39,6 +40,9 @@ inline std::ostream& operator<<(std::ostream& os, const ExecutionOrder& order) {
     case ExecutionOrder::MEMORY_EFFICIENT:
       os << "MEMORY_EFFICIENT";
       break;
+    case ExecutionOrder::MEMORY_AWARE:
+      os << "MEMORY_AWARE";
+      break;
     default:
       os << "UNKNOWN";
       break;
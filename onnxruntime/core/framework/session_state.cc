@@ -6,7 +6,9 @@
 #include <sstream>
 
 #include "core/platform/ort_mutex.h"
+#include "core/common/hash_combine.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
@@ -15,6 +17,7 @@
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/session_state_utils.h"
 #include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 
@@ -87,6 +90,10 @@ SessionState::SessionState(Graph& graph,
 {
   enable_mem_pattern_ = sess_options_.enable_mem_pattern &&
                         sess_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL;
+  mem_pattern_shape_bucketing_ =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternShapeBucketing, "0") == "1";
+  mem_pattern_cache_capacity_ = ParseStringWithClassicLocale<size_t>(
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternMaxCacheSize, "0"));
   if (parent_allocators) {
     allocators_ = parent_allocators;
   } else {
@@ -213,6 +220,14 @@ const KernelCreateInfo& SessionState::GetNodeKernelCreateInfo(NodeIndex node_ind
   return *entry->second;
 }
 
+concurrency::ThreadPool* SessionState::GetInitializationThreadPool() const {
+  if (sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigParallelInitialization, "0") != "1") {
+    return nullptr;
+  }
+
+  return inter_op_thread_pool_ != nullptr ? inter_op_thread_pool_ : thread_pool_;
+}
+
 Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_manager) {
   const auto& nodes = graph_viewer_->Nodes();
   if (!nodes.empty()) {
@@ -222,7 +237,8 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1);
-    for (const auto& node : nodes) {
+
+    auto create_kernel = [this, &kernel_registry_manager](const Node& node) -> Status {
       // construct and save the kernels
       const KernelCreateInfo& kci = GetNodeKernelCreateInfo(node.Index());
 
@@ -231,7 +247,45 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
       const IExecutionProvider& exec_provider = *execution_providers_.Get(exec_provider_name);
 
       // assumes vector is already resize()'ed to the number of nodes in the graph
-      ORT_RETURN_IF_ERROR(kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]));
+      return kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]);
+    };
+
+    concurrency::ThreadPool* thread_pool = GetInitializationThreadPool();
+    if (thread_pool == nullptr) {
+      for (const auto& node : nodes) {
+        ORT_RETURN_IF_ERROR(create_kernel(node));
+      }
+    } else {
+      // the kernels of the CPU EP are created in parallel, each into its own slot of session_kernels_.
+      // the other EPs may not support it so their kernels are created serially.
+      InlinedVector<const Node*> cpu_nodes;
+      for (const auto& node : nodes) {
+        if (node.GetExecutionProviderType() == kCpuExecutionProvider) {
+          cpu_nodes.push_back(&node);
+        } else {
+          ORT_RETURN_IF_ERROR(create_kernel(node));
+        }
+      }
+
+      std::vector<Status> statuses(cpu_nodes.size());
+      concurrency::ThreadPool::TrySimpleParallelFor(
+          thread_pool, static_cast<std::ptrdiff_t>(cpu_nodes.size()),
+          [&](std::ptrdiff_t i) {
+            ORT_TRY {
+              statuses[i] = create_kernel(*cpu_nodes[i]);
+            }
+            ORT_CATCH(const std::exception& ex) {
+              ORT_HANDLE_EXCEPTION([&]() {
+                statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create the kernel of node ",
+                                              cpu_nodes[i]->Name(), ": ", ex.what());
+              });
+            }
+          });
+
+      // report the error of the first node in the graph order, regardless of the thread pool
+      for (const auto& status : statuses) {
+        ORT_RETURN_IF_ERROR(status);
+      }
     }
   }
   node_index_info_.emplace(*graph_viewer_, ort_value_name_idx_map_);
@@ -384,6 +438,29 @@ static Status KernelUseSharedPrePackedBuffers(OpKernel& kernel, int input_idx,
   return Status::OK();
 }
 
+static Status KernelUseCachedPrePackedBuffers(OpKernel& kernel, const Tensor& tensor, int input_idx,
+                                              const PrePackedWeights& prepacked_weights,
+                                              const std::string& node_name) {
+  std::vector<BufferUniquePtr> cached_prepacked_buffers;
+  cached_prepacked_buffers.reserve(prepacked_weights.buffers_.size());
+
+  for (const auto& prepacked_buffer : prepacked_weights.buffers_) {
+    // BufferDeleter is nullptr because the buffers are owned by the cache
+    cached_prepacked_buffers.emplace_back(prepacked_buffer.get(), BufferDeleter(nullptr));
+  }
+
+  bool used_cached_buffers = false;
+  ORT_RETURN_IF_ERROR(kernel.UseCachedPrePackedBuffers(tensor, cached_prepacked_buffers, input_idx,
+                                                       used_cached_buffers));
+
+  // BUG CHECK: Kernels returning true from IsPrePackCacheable() must be able to use the cached buffers
+  if (!used_cached_buffers)
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The kernel corresponding to the node ", node_name,
+                           " doesn't have an implementation that can consume cached pre-packed weights");
+
+  return Status::OK();
+}
+
 static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
                                                      const PrePackedWeights& pre_packed_weights) {
   std::ostringstream ss_1;
@@ -396,7 +473,13 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
 
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
+  // the persistent cache of pre-packed weights is owned by the session state of the main graph
+  const SessionState* root = this;
+  while (root->parent_ != nullptr) root = root->parent_;
+  PrepackedWeightsFileCache* prepacked_weights_file_cache = root->prepacked_weights_file_cache_.get();
+
+  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map,
+                                     prepacked_weights_file_cache](
                                         bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
     for (auto& node : GetGraphViewer().Nodes()) {
       auto kernel = GetMutableKernel(node.Index());
@@ -476,6 +559,42 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                     }
                   }
 
+                } else if (prepacked_weights_file_cache != nullptr &&
+                           node.GetExecutionProviderType() == kCpuExecutionProvider &&
+                           !const_initialized_tensor.IsDataTypeString() &&
+                           kernel->IsPrePackCacheable(input_idx)) {  // persistent caching of pre-packed weights' turned ON
+                  const std::string prepacked_weights_file_cache_key =
+                      PrepackedWeightsFileCache::GenerateKey(node, input_idx, const_initialized_tensor);
+
+                  if (const PrePackedWeights* cached_weights =
+                          prepacked_weights_file_cache->GetWeight(prepacked_weights_file_cache_key);
+                      cached_weights != nullptr) {
+                    LOGS(logger_, INFO) << "Using persistently cached pre-packed weight for constant initializer: "
+                                        << input_name << " used in the node: " << node.Name();
+
+                    ORT_RETURN_IF_ERROR(KernelUseCachedPrePackedBuffers(*kernel, const_initialized_tensor, input_idx,
+                                                                        *cached_weights, node.Name()));
+                    is_packed = true;
+                    ++used_cached_pre_packed_weights_counter_;
+                  } else {  // cache doesn't contain the pre-packed weight - so pre-pack and write it into the cache
+                    AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+                    PrePackedWeights weights_to_be_cached;
+                    ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
+                                                        session_cpu_alloc,  // the cache keeps the allocator alive
+                                                        is_packed,
+                                                        &weights_to_be_cached));
+
+                    if (is_packed) {
+                      ORT_ENFORCE(weights_to_be_cached.buffers_.size() > 0, "The kernel corresponding to the node ",
+                                  node.Name(), " doesn't have an implementation that can cache computed pre-packed weights");
+
+                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(
+                          *kernel, input_idx,
+                          prepacked_weights_file_cache->WriteWeight(prepacked_weights_file_cache_key,
+                                                                    std::move(weights_to_be_cached)),
+                          node.Name()));
+                    }
+                  }
                 } else {  // caching of pre-packed weights' turned OFF
                   AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
                   ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
@@ -513,6 +632,12 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
 
   bool should_cache_prepacked_weights_for_shared_initializers = (prepacked_weights_container_ != nullptr);
 
+  if (!should_cache_prepacked_weights_for_shared_initializers && prepacked_weights_file_cache == nullptr) {
+    if (concurrency::ThreadPool* thread_pool = GetInitializationThreadPool(); thread_pool != nullptr) {
+      return PrepackConstantInitializedTensorsInParallel(constant_initializers_use_count, thread_pool);
+    }
+  }
+
   if (should_cache_prepacked_weights_for_shared_initializers) {
     // serialize calls to the method that looks up the container, calls UseCachedPrePackedWeight/PrePack
     // and writes pre-packed weights to the container
@@ -523,12 +648,142 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
   }
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
+Status SessionState::PrepackConstantInitializedTensorsInParallel(
+    InlinedHashMap<std::string, size_t>& constant_initializers_use_count, concurrency::ThreadPool* thread_pool) {
+  struct ConstantInput {
+    int input_idx;
+    const std::string* input_name;
+    SessionState* st;  // the session state owning the constant initialized tensor
+    int ort_value_idx;
+    const Tensor* tensor;
+    bool is_packed;
+  };
+
+  struct NodeToPrepack {
+    const Node* node;
+    OpKernel* kernel;
+    InlinedVector<ConstantInput> inputs;
+    Status status;
+  };
+
+  // find the constant initialized tensors of each node the same way as PrepackConstantInitializedTensors()
+  std::vector<NodeToPrepack> nodes_to_prepack;
+  for (auto& node : GetGraphViewer().Nodes()) {
+    NodeToPrepack node_to_prepack{&node, GetMutableKernel(node.Index()), {}, Status::OK()};
+    int input_idx = 0;
+    for (auto& input_def : node.InputDefs()) {
+      if (input_def->Exists()) {
+        const std::string& input_name = input_def->Name();
+        SessionState* st = this;
+        do {
+          int ort_value_idx;
+          if (st->GetOrtValueNameIdxMap().GetIdx(input_name, ort_value_idx).IsOK()) {
+            // resolved here as the pool threads below must not look up the hash map of the tensors concurrently
+            auto tensor_it = st->constant_initialized_tensors_.find(ort_value_idx);
+            if (tensor_it != st->constant_initialized_tensors_.end()) {
+              node_to_prepack.inputs.push_back({input_idx, &input_name, st, ort_value_idx,
+                                                &tensor_it->second.Get<Tensor>(), false});
+            }
+            if (st != this || !st->graph_.IsOuterScopeValue(input_name)) {
+              break;
+            }
+          }
+          st = st->Parent();
+        } while (st);
+      }
+      input_idx++;
+    }
+
+    if (!node_to_prepack.inputs.empty()) {
+      nodes_to_prepack.push_back(std::move(node_to_prepack));
+    }
+  }
+
+  // the inputs of a node are pre-packed in order as a kernel may depend on it.
+  // the constant initialized tensors are only released once all the nodes are pre-packed.
+  auto prepack_node = [this](NodeToPrepack& node_to_prepack) {
+    ORT_TRY {
+      OpKernel& kernel = *node_to_prepack.kernel;
+      AllocatorPtr session_cpu_alloc = GetAllocator(kernel.Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+      for (auto& input : node_to_prepack.inputs) {
+        node_to_prepack.status = kernel.PrePack(*input.tensor, input.input_idx,
+                                                session_cpu_alloc,  // use allocator tied to this session
+                                                input.is_packed,
+                                                nullptr  // no caching required
+        );
+        if (!node_to_prepack.status.IsOK()) {
+          return;
+        }
+      }
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        node_to_prepack.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to pre-pack the weights of node ",
+                                                 node_to_prepack.node->Name(), ": ", ex.what());
+      });
+    }
+  };
+
+  InlinedVector<NodeToPrepack*> cpu_nodes_to_prepack;
+  for (auto& node_to_prepack : nodes_to_prepack) {
+    if (node_to_prepack.node->GetExecutionProviderType() == kCpuExecutionProvider) {
+      cpu_nodes_to_prepack.push_back(&node_to_prepack);
+    } else {
+      prepack_node(node_to_prepack);
+    }
+  }
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(cpu_nodes_to_prepack.size()),
+      [&](std::ptrdiff_t i) { prepack_node(*cpu_nodes_to_prepack[i]); });
+
+  for (auto& node_to_prepack : nodes_to_prepack) {
+    ORT_RETURN_IF_ERROR(node_to_prepack.status);
+
+    for (auto& input : node_to_prepack.inputs) {
+      if (!input.is_packed) {
+        continue;
+      }
+
+      ++number_of_prepacks_counter_;
+
+      const std::string& input_name = *input.input_name;
+      if (constant_initializers_use_count.count(input_name) && --constant_initializers_use_count[input_name] == 0) {
+        // release the constant initialized tensor
+        input.st->initialized_tensors_.erase(input.ort_value_idx);
+        input.st->constant_initialized_tensors_.erase(input.ort_value_idx);
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs, bool shape_bucketing) {
+  if (!shape_bucketing) {
+    int64_t key = 0;
+    for (const auto& input : tensor_inputs) {
+      for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
+    }
+    return key;
+  }
+
+  // Round each dim up to a power of 2. Dims that are fixed in the model are the same for every run,
+  // so only the dynamic ones, e.g. batch size or sequence length, select the bucket.
+  size_t key = 0;
   for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    HashCombine(dims.size(), key);
+    for (auto dim : dims) {
+      int64_t bucket = dim;
+      if (dim > 1) {
+        bucket = 1;
+        while (bucket < dim) bucket <<= 1;
+      }
+      HashCombine(bucket, key);
+    }
   }
-  return key;
+  return static_cast<int64_t>(key);
 }
 
 #ifdef ENABLE_TRAINING
@@ -765,14 +1020,30 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+SessionState::MemoryPatternCacheEntry& SessionState::InsertMemoryPatternCacheEntry(int64_t key) const {
+  if (mem_pattern_cache_capacity_ > 0) {
+    while (mem_patterns_.size() >= mem_pattern_cache_capacity_) {
+      // Frames using the evicted patterns hold their own reference.
+      mem_patterns_.erase(mem_patterns_lru_.back());
+      mem_patterns_lru_.pop_back();
+    }
+  }
+  mem_patterns_lru_.push_front(key);
+  auto& entry = mem_patterns_[key];
+  entry.lru_position = mem_patterns_lru_.begin();
+  return entry;
+}
+
+// MemoryPatternGroup is cached. It is only inserted upon creation and is not updated
+// if already present, unless a run in the same shape bucket marked it as too small.
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
     gsl::span<const int> feed_mlvalue_idxs,
-    const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
+    std::shared_ptr<const InlinedHashMap<int, TensorShape>>& out_inferred_shapes,
+    bool& needs_update) const {
   out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  needs_update = false;
+  int64_t key = CalculateMemoryPatternsKey(tensor_inputs, mem_pattern_shape_bucketing_);
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
   auto it = mem_patterns_.find(key);
   if (it == mem_patterns_.end()) {
@@ -780,11 +1051,14 @@ const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
     MemoryPatternGroup mem_patterns;
     InlinedHashMap<int, TensorShape> inferred_shapes;
     if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
+      auto& entry = InsertMemoryPatternCacheEntry(key);
+      entry.patterns = std::make_shared<const MemoryPatternGroup>(std::move(mem_patterns));
+      // The shapes are only valid for the exact input shapes they were inferred from.
+      if (!mem_pattern_shape_bucketing_) {
+        entry.inferred_shapes = std::make_shared<const InlinedHashMap<int, TensorShape>>(std::move(inferred_shapes));
+        out_inferred_shapes = entry.inferred_shapes;
+      }
+      return entry.patterns;
     }
 #else
     ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
@@ -792,11 +1066,13 @@ const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
     return nullptr;
   }
 
-  auto patt_hit = shape_patterns_.find(key);
-  if (patt_hit != shape_patterns_.cend()) {
-    out_inferred_shapes = &patt_hit->second;
+  auto& entry = it->second;
+  if (entry.lru_position != mem_patterns_lru_.begin()) {
+    mem_patterns_lru_.splice(mem_patterns_lru_.begin(), mem_patterns_lru_, entry.lru_position);
   }
-  return &it->second;
+  out_inferred_shapes = entry.inferred_shapes;
+  needs_update = entry.needs_update;
+  return entry.patterns;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -847,14 +1123,30 @@ void SessionState::ResolveMemoryPatternFlag() {
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  int64_t key = CalculateMemoryPatternsKey(tensor_inputs, mem_pattern_shape_bucketing_);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  auto it = mem_patterns_.find(key);
+  if (it == mem_patterns_.end()) {
+    InsertMemoryPatternCacheEntry(key).patterns = std::make_shared<const MemoryPatternGroup>(std::move(mem_patterns));
+  } else if (it->second.needs_update) {
+    // The new patterns were traced with blocks at least as large as the ones they replace.
+    it->second.patterns = std::make_shared<const MemoryPatternGroup>(std::move(mem_patterns));
+    it->second.needs_update = false;
+  }
   return Status::OK();
 }
 
+void SessionState::MarkMemoryPatternGroupForUpdate(gsl::span<const OrtValue> tensor_inputs) const {
+  int64_t key = CalculateMemoryPatternsKey(tensor_inputs, mem_pattern_shape_bucketing_);
+
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  auto it = mem_patterns_.find(key);
+  if (it != mem_patterns_.end()) {
+    it->second.needs_update = true;
+  }
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
 bool SessionState::GetEnableMemoryReuse() const { return sess_options_.enable_mem_reuse; }
@@ -1184,10 +1476,33 @@ Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE
   ORT_RETURN_IF_ERROR(VerifyEachNodeIsAssignedToAnEp(graph_, logger_, execution_providers_));
   ORT_RETURN_IF_ERROR(PopulateKernelCreateInfo(kernel_registry_manager, saving_ort_format));
 
+  if (sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsEnablePrepackedWeightsCache, "0") == "1") {
+    if (graph_location.empty()) {
+      LOGS(logger_, WARNING) << "The persistent cache of pre-packed weights is only used for models loaded from a file.";
+    } else {
+      prepacked_weights_file_cache_ =
+          std::make_unique<PrepackedWeightsFileCache>(graph_location + ORT_TSTR(".prepacked"));
+      auto status = prepacked_weights_file_cache_->Load();
+      if (!status.IsOK()) {
+        LOGS(logger_, WARNING) << "Ignoring the pre-packed weights cache file. " << status.ErrorMessage();
+      }
+    }
+  }
+
   InlinedHashMap<std::string, size_t> constant_initializers_use_count;
   ComputeConstantInitializerUseCount(graph_, constant_initializers_use_count);
-  return FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, sess_options_,
-                                  remove_initializers, constant_initializers_use_count);
+  ORT_RETURN_IF_ERROR(FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, sess_options_,
+                                               remove_initializers, constant_initializers_use_count));
+
+  if (prepacked_weights_file_cache_) {
+    // the session works without the cache file, the weights are pre-packed again on the next load
+    auto status = prepacked_weights_file_cache_->Save();
+    if (!status.IsOK()) {
+      LOGS(logger_, WARNING) << "Failed to save the pre-packed weights cache file. " << status.ErrorMessage();
+    }
+  }
+
+  return Status::OK();
 }
 
 static Status Index(const OrtValueNameIdxMap& ort_value_name_idx_map,
@@ -1473,6 +1788,11 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   }
 #endif
 
+  TimePoint tp;
+  if (profiler_.IsEnabled()) {
+    tp = profiler_.Start();
+  }
+
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInitializedTensors(
           Env::Default(), graph_location, *graph_viewer_,
@@ -1487,7 +1807,12 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
             return Status::OK();
           },
           logger_, data_transfer_mgr_, *p_seq_exec_plan_, session_options, memory_profile_func,
-          name_to_buffered_tensor_));
+          name_to_buffered_tensor_, GetInitializationThreadPool()));
+
+  if (profiler_.IsEnabled()) {
+    profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "session_state_save_initializers", tp);
+    tp = profiler_.Start();
+  }
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Record Weight allocation info on device
@@ -1503,9 +1828,21 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
 
   ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager));
 
+  if (profiler_.IsEnabled()) {
+    profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "session_state_create_kernels", tp);
+  }
+
   if (!disable_prepacking) {
+    if (profiler_.IsEnabled()) {
+      tp = profiler_.Start();
+    }
+
     ORT_RETURN_IF_ERROR(PrepackConstantInitializedTensors(constant_initializers_use_count,
                                                           session_options.initializers_to_share_map));
+
+    if (profiler_.IsEnabled()) {
+      profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "session_state_prepack", tp);
+    }
   }
 
   ORT_RETURN_IF_ERROR(
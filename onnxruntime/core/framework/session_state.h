@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <list>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -25,6 +26,7 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/prepacked_weights_file_cache.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
@@ -215,25 +217,39 @@ class SessionState {
   /**
   Get cached memory pattern based on input shapes
   Must be called only when all values contain tensors
-  In training scenarios, the cache may be updated so
-  the callers would receive a copy of inferred shapes
-  made under mutex being held. In inference scenarios,
-  it is not mutable, we do not obtain a lock and simply get a pointer
-  w/o copying a hashtable
+  The pattern and the inferred shapes are shared with the cache, so they remain
+  valid for the caller if the cache entry is evicted or replaced in the meantime.
+  If needs_update is true on return, a previous run with input shapes of the same
+  bucket did not fit the pattern, and the caller should trace a new pattern and pass
+  it to UpdateMemoryPatternGroupCache.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
       gsl::span<const int> feed_mlvalue_idxs,
-      const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
+      std::shared_ptr<const InlinedHashMap<int, TensorShape>>& inferred_shapes,
+      bool& needs_update) const;
 
   /**
   Set generated memory pattern with a given input shapes.
   Const as it's an internal cache update only.
   All inputs must represent Tensors
+  An existing pattern is only replaced if it was marked by MarkMemoryPatternGroupForUpdate.
   */
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Mark the cached memory pattern for the given input shapes as too small, so that
+  the next run with input shapes of the same bucket traces a larger one.
+  */
+  void MarkMemoryPatternGroupForUpdate(gsl::span<const OrtValue> tensor_inputs) const;
+
+  /**
+  Get whether memory patterns are cached per bucket of input shapes rather than per exact input shapes.
+  If true, a tensor may be placed in a block of the memory pattern that is larger than needed.
+  */
+  bool GetMemoryPatternShapeBucketing() const { return mem_pattern_shape_bucketing_; }
+
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
   /**
@@ -329,6 +345,10 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetUsedCachedPrePackedWeightCounter() const {
+    return used_cached_pre_packed_weights_counter_;
+  }
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -366,6 +386,10 @@ class SessionState {
   // Populate OrtValueNameIdxMap and create the graph viewer.
   void CreateGraphInfo();
 
+  // Returns the thread pool to initialize the session state with,
+  // or nullptr if kOrtSessionOptionsConfigParallelInitialization is not set.
+  concurrency::ThreadPool* GetInitializationThreadPool() const;
+
   // create kernels using info in kernel_create_info_map_
   Status CreateKernels(const KernelRegistryManager& custom_registry_manager);
 
@@ -380,6 +404,11 @@ class SessionState {
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                            const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
 
+  // Prepack the constant initialized tensors of the CPU kernels using the thread pool, the other kernels serially.
+  // Only used when the pre-packed weights are neither shared nor cached.
+  Status PrepackConstantInitializedTensorsInParallel(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
+                                                     concurrency::ThreadPool* thread_pool);
+
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
   Status CreateSubgraphSessionState();
@@ -413,6 +442,11 @@ class SessionState {
   // fused_funcs_mgr_ must live longer than the session_kernels_, becaues a kernel could be created from this manager
   FuncManager fused_funcs_mgr_;
 
+  // Persistent cache of pre-packed weights, see kOrtSessionOptionsEnablePrepackedWeightsCache.
+  // Only set in the session state of the main graph, subgraphs use the one of their root.
+  // Must live longer than the kernels, which can use buffers owned by it.
+  std::unique_ptr<PrepackedWeightsFileCache> prepacked_weights_file_cache_;
+
   // cache of the constructed kernels to avoid spending construction time per executor
   std::vector<std::unique_ptr<OpKernel>> session_kernels_;
   Graph& graph_;
@@ -489,18 +523,32 @@ class SessionState {
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
+  // round up input dims to a power of 2 when computing the key of the memory pattern cache,
+  // so that one memory pattern is shared by all the input shapes of a bucket.
+  bool mem_pattern_shape_bucketing_{false};
+  // maximum number of cached memory patterns, 0 for no limit.
+  size_t mem_pattern_cache_capacity_{0};
+
+  struct MemoryPatternCacheEntry {
+    std::shared_ptr<const MemoryPatternGroup> patterns;
+    // shapes inferred together with the patterns, training only.
+    std::shared_ptr<const InlinedHashMap<int, TensorShape>> inferred_shapes;
+    // position of the key in mem_patterns_lru_.
+    std::list<int64_t>::iterator lru_position;
+    // set when a run with input shapes of the same bucket did not fit the patterns.
+    bool needs_update{false};
+  };
+
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
   // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#endif
+  mutable InlinedHashMap<int64_t, MemoryPatternCacheEntry> mem_patterns_;
+  // keys of mem_patterns_, most recently used first.
+  mutable std::list<int64_t> mem_patterns_lru_;
+
+  // Adds an entry for key to mem_patterns_, evicting the least recently used ones
+  // if the cache is full. mem_patterns_lock_ must be held.
+  MemoryPatternCacheEntry& InsertMemoryPatternCacheEntry(int64_t key) const;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -553,6 +601,10 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times the pre-packed weight corresponding to a constant initialized weight
+  // was read from the persistent cache of pre-packed weights
+  size_t used_cached_pre_packed_weights_counter_ = 0;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
@@ -13,6 +13,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/framework/session_state_utils.h"
 #include "core/common/common.h"
+#include "core/common/narrow.h"
 #include "core/common/logging/logging.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/data_transfer_manager.h"
@@ -22,8 +23,10 @@
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/tensor_external_data_info.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
 #include "core/framework/bfc_arena.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/framework/mem_buffer.h"
@@ -91,16 +94,43 @@ static inline common::Status ExtDataTensorProtoToTensor(const Env& env,
   return common::Status::OK();
 }
 
+// Returns true if an initializer on CPU with external data can point directly to that data,
+// i.e. to the memory mapped file or to the buffer given by kTensorProtoMemoryAddressTag,
+// rather than to a copy of it in a buffer of the allocator.
+// Data in a file is only mapped if map_external_data is true and its offset in the file is a multiple of
+// the element size, as the tensor would be misaligned otherwise.
+static bool UseExternalDataInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto, bool map_external_data) {
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  if (!utils::HasDataType(tensor_proto) || utils::HasString(tensor_proto) ||
+      !ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info).IsOK()) {
+    // invalid external data, let GetExtDataFromTensorProto report the error
+    return true;
+  }
+
+  if (external_data_info->GetRelPath() == utils::kTensorProtoMemoryAddressTag) {
+    return true;
+  }
+
+  if (!map_external_data) {
+    return false;
+  }
+
+  const auto* element_type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+  return external_data_info->GetOffset() % static_cast<ExternalDataInfo::OFFSET_TYPE>(element_type->Size()) == 0;
+}
+
 // If tensor_proto's external file path is kTensorProtoMemoryAddressTag, and
 // buffered_tensor is not null, buffered_tensor holds the real buffer pointed
 // by tensor_proto. buffered_tensor must be the owner of the buffer and deleter
 // should release the buffer when tensor_proto is released.
+// If use_external_data_in_place is false, external data on CPU is copied into a buffer like internal data.
 static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                              const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer* m,
                                              const AllocatorPtr& alloc, const AllocatorPtr& default_cpu_alloc,
                                              OrtValue& ort_value, const DataTransferManager& data_transfer_mgr,
                                              bool use_device_allocator_for_initializers = false,
-                                             Tensor* buffered_tensor = nullptr) {
+                                             Tensor* buffered_tensor = nullptr,
+                                             bool use_external_data_in_place = true) {
   if (bool(alloc) == (m != nullptr)) {
     return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                   "DeserializeTensorProto() takes either pre-allocated buffer or an allocator!");
@@ -116,7 +146,10 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
 
   auto device_type = (alloc != nullptr) ? alloc->Info().device.Type() : m->GetAllocInfo().device.Type();
 
-  if (utils::HasExternalData(tensor_proto)) {
+  // external data on CPU that can not be used in place is copied like an internal initializer
+  const bool external_data = utils::HasExternalData(tensor_proto) &&
+                             (device_type != OrtDevice::CPU || use_external_data_in_place);
+  if (external_data) {
     if (device_type == OrtDevice::CPU) {
       // for external initializer on CPU we will use mmap for large initializers so don't need to allocate memory in advance
       p_tensor = std::make_unique<Tensor>(type, TensorShape(), alloc);
@@ -266,7 +299,8 @@ common::Status SaveInitializedTensors(
     const ExecutionPlanBase& exec_plan,
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors) {
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
+    concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
@@ -320,12 +354,19 @@ common::Status SaveInitializedTensors(
   // NB1: vector with init allocation order may contain a subset of all tensors (or none at all)
   // NB2: only skip tracing and planning memory when data is external (i.e mmap) and on CPU.
   //    when data is external and on GPU, need to copy first to cpu memory, then to gpu memory.
+  const bool map_external_initializers =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMmapExternalInitializers, "1") == "1";
+  auto use_external_data_in_place = [&](int ort_value_index, const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+    return utils::HasExternalData(tensor_proto) && exec_plan.GetLocation(ort_value_index).Type() == OrtDevice::CPU &&
+           UseExternalDataInPlace(tensor_proto, map_external_initializers);
+  };
+
   auto initialized_tensors_to_allocate = id_to_initialized_tensor;
   for (int ort_value_index : initializer_allocation_order) {
     const auto entry = initialized_tensors_to_allocate.find(ort_value_index);
     ORT_ENFORCE(entry != initialized_tensors_to_allocate.end(),
                 "OrtValue index: ", ort_value_index, " from initializer_allocation_order not found among initialized tensors");
-    if (!(utils::HasExternalData(*entry->second) && exec_plan.GetLocation(ort_value_index).Type() == OrtDevice::CPU)) {
+    if (!use_external_data_in_place(ort_value_index, *entry->second)) {
       // can not trace string tensor
       ORT_ENFORCE(entry->second->data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING, "Can not trace string tensor");
       ORT_RETURN_IF_ERROR(planner.Trace(entry->first, entry->second));
@@ -342,6 +383,10 @@ common::Status SaveInitializedTensors(
       // do not trace string tensor
       continue;
     }
+    if (use_external_data_in_place(entry.first, *entry.second)) {
+      // the tensor will point to the memory mapped data, a buffer would be wasted
+      continue;
+    }
     ORT_RETURN_IF_ERROR(planner.Trace(entry.first, entry.second));
   }
   // 2. allocate weight buffer on different locations
@@ -360,8 +405,26 @@ common::Status SaveInitializedTensors(
   }
 
   OrtCallback deleter{nullptr, nullptr};
+  const bool use_device_allocator_for_initializers =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
 
   // 3. create weight tensors based on weights buffer
+  //    the tensors are deserialized first, those on CPU in parallel if a thread pool is given,
+  //    then they are saved in the order of their indexes so the result doesn't depend on the thread pool
+  struct InitializerToSave {
+    int ort_value_index;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto;
+    bool deserialize;  // false for a user supplied initializer
+    std::optional<MemBuffer> m;
+    AllocatorPtr alloc;
+    Tensor* p_tensor;
+    OrtValue ort_value;
+    Status status;
+  };
+
+  std::vector<InitializerToSave> initializers_to_save;
+  initializers_to_save.reserve(id_to_initialized_tensor.size());
+  InlinedVector<size_t> cpu_initializers_to_deserialize;
   for (const auto& entry : id_to_initialized_tensor) {
     int ort_value_index = entry.first;
     const std::string& name = entry.second->name();
@@ -371,36 +434,77 @@ common::Status SaveInitializedTensors(
       continue;
     }
 
-    OrtValue ort_value;
+    InitializerToSave& initializer = initializers_to_save.emplace_back();
+    initializer.ort_value_index = ort_value_index;
+    initializer.tensor_proto = entry.second;
+    initializer.deserialize = user_supplied_initializer_ids.find(entry.first) == user_supplied_initializer_ids.end();
+    initializer.p_tensor = nullptr;
 
-    if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
-      ort_value = *(session_options.initializers_to_share_map.at(name));
+    if (!initializer.deserialize) {
+      initializer.ort_value = *(session_options.initializers_to_share_map.at(name));
       LOGS(logger, INFO) << "Using user supplied initializer with name (" << name << ").";
-    } else {
-      const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
-
-      std::optional<MemBuffer> m;
-      AllocatorPtr alloc;
-      // TODO: if the tensor need be copied, does it have enough room?
-      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
-      bool use_device_allocator_for_initializers =
-          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
-
-      Tensor* p_tensor = nullptr;
-      if (auto iter = buffered_tensors.find(name);
-          iter != buffered_tensors.end()) {
-        p_tensor = iter->second.release();
-        buffered_tensors.erase(iter);
-      }
+      continue;
+    }
 
-      Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
-                                         default_cpu_alloc, ort_value, data_transfer_mgr,
-                                         use_device_allocator_for_initializers, p_tensor);
-      if (!st.IsOK()) {
-        std::ostringstream oss;
-        oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
-        return Status(st.Category(), st.Code(), oss.str());
-      }
+    // TODO: if the tensor need be copied, does it have enough room?
+    ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, initializer.m, initializer.alloc));
+
+    if (auto iter = buffered_tensors.find(name);
+        iter != buffered_tensors.end()) {
+      initializer.p_tensor = iter->second.release();
+      buffered_tensors.erase(iter);
+    }
+
+    // copies to other devices are left to this thread
+    const bool on_cpu = initializer.alloc ? initializer.alloc->Info().device.Type() == OrtDevice::CPU
+                                          : initializer.m.has_value() &&
+                                                initializer.m->GetAllocInfo().device.Type() == OrtDevice::CPU;
+    if (thread_pool != nullptr && on_cpu) {
+      cpu_initializers_to_deserialize.push_back(initializers_to_save.size() - 1);
+    }
+  }
+
+  auto deserialize_initializer = [&](InitializerToSave& initializer) {
+    const ONNX_NAMESPACE::TensorProto& tensor_proto = *initializer.tensor_proto;
+    ORT_TRY {
+      initializer.status = DeserializeTensorProto(env, graph_loc, tensor_proto,
+                                                  (initializer.m.has_value()) ? &*initializer.m : nullptr,
+                                                  initializer.alloc, default_cpu_alloc, initializer.ort_value,
+                                                  data_transfer_mgr, use_device_allocator_for_initializers,
+                                                  initializer.p_tensor,
+                                                  use_external_data_in_place(initializer.ort_value_index, tensor_proto));
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        initializer.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+      });
+    }
+  };
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(cpu_initializers_to_deserialize.size()),
+      [&](std::ptrdiff_t i) {
+        deserialize_initializer(initializers_to_save[cpu_initializers_to_deserialize[narrow<size_t>(i)]]);
+      });
+
+  for (size_t i = 0, next_cpu_initializer = 0; i < initializers_to_save.size(); ++i) {
+    InitializerToSave& initializer = initializers_to_save[i];
+    if (next_cpu_initializer < cpu_initializers_to_deserialize.size() &&
+        cpu_initializers_to_deserialize[next_cpu_initializer] == i) {
+      ++next_cpu_initializer;
+    } else if (initializer.deserialize) {
+      deserialize_initializer(initializer);
+    }
+  }
+
+  for (auto& initializer : initializers_to_save) {
+    const int ort_value_index = initializer.ort_value_index;
+    const std::string& name = initializer.tensor_proto->name();
+
+    if (!initializer.status.IsOK()) {
+      std::ostringstream oss;
+      oss << "Deserialize tensor " << name << " failed." << initializer.status.ErrorMessage();
+      return Status(initializer.status.Category(), initializer.status.Code(), oss.str());
     }
 
     // 'name' is a reference to a string within the TensorProto that save_tensor_func may free
@@ -412,9 +516,9 @@ common::Status SaveInitializedTensors(
     const bool constant = graph.IsConstantInitializer(name, /* check_outer_scope */ false);
 #if !defined(DISABLE_SPARSE_TENSORS)
     const bool sparse = graph.GetGraph().IsSparseInitializer(name);
-    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, ort_value, deleter, constant, sparse));
+    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, initializer.ort_value, deleter, constant, sparse));
 #else
-    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, ort_value, deleter, constant, false));
+    ORT_RETURN_IF_ERROR(save_tensor_func(name, ort_value_index, initializer.ort_value, deleter, constant, false));
 #endif
   }
 
@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/tensor_shape.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+Key of a ShapePlanCache entry: the input shapes, and the values of any small input the plan depends on
+(scales, sizes, ...), flattened into a single vector.
+*/
+class ShapePlanKey {
+ public:
+  /** Adds the rank and dims of the shape. A missing optional input is passed as nullptr. */
+  ShapePlanKey& AddShape(const TensorShape* shape) {
+    if (shape == nullptr) {
+      values_.push_back(-1);
+    } else {
+      const auto dims = shape->GetDims();
+      values_.push_back(static_cast<int64_t>(dims.size()));
+      values_.insert(values_.end(), dims.begin(), dims.end());
+    }
+    return *this;
+  }
+
+  ShapePlanKey& AddValues(gsl::span<const int64_t> values) {
+    values_.push_back(static_cast<int64_t>(values.size()));
+    values_.insert(values_.end(), values.begin(), values.end());
+    return *this;
+  }
+
+  /** Adds the bit patterns of the values, so that every distinct float gets a distinct key. */
+  ShapePlanKey& AddValues(gsl::span<const float> values) {
+    values_.push_back(static_cast<int64_t>(values.size()));
+    for (float value : values) {
+      uint32_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      values_.push_back(static_cast<int64_t>(bits));
+    }
+    return *this;
+  }
+
+  bool operator==(const ShapePlanKey& other) const { return values_ == other.values_; }
+  bool operator!=(const ShapePlanKey& other) const { return !(*this == other); }
+
+ private:
+  InlinedVector<int64_t, 16> values_;
+};
+
+/**
+Caches the state a kernel derives from the shapes of its inputs, e.g. the output shape, the padding, the MLAS
+parameters or the size of the working buffers, so that it is derived once per distinct set of shapes instead of on
+every Compute call. This is a significant part of the cost of a call for small tensors.
+
+Kernels are shared between the execution frames of concurrent Run calls, so the cache is guarded by a mutex and hands
+out immutable plans. It keeps the most recently used plans, which covers the handful of shapes a model with dynamic
+dimensions usually alternates between.
+*/
+template <typename Plan>
+class ShapePlanCache {
+ public:
+  static constexpr size_t kDefaultCapacity = 8;
+
+  explicit ShapePlanCache(size_t capacity = kDefaultCapacity) : capacity_(capacity) {
+    ORT_ENFORCE(capacity_ > 0, "ShapePlanCache capacity must be positive.");
+  }
+
+  /**
+  Gets the plan cached for the key, or builds it with create_plan, a callable taking a Plan& to fill in and returning
+  a Status, and caches it. A plan is not cached when create_plan fails.
+  */
+  template <typename CreatePlanFn>
+  Status GetOrCreate(ShapePlanKey key, CreatePlanFn&& create_plan, std::shared_ptr<const Plan>& plan) const {
+    {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->first == key) {
+          // most recently used first
+          std::rotate(entries_.begin(), it, it + 1);
+          plan = entries_.front().second;
+          return Status::OK();
+        }
+      }
+    }
+
+    // Built without holding the lock so that concurrent calls with other shapes are not serialized. Two calls
+    // missing on the same key at the same time both build the plan, and the last one is kept.
+    auto new_plan = std::make_shared<Plan>();
+    ORT_RETURN_IF_ERROR(create_plan(*new_plan));
+    plan = new_plan;
+
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (entries_.size() == capacity_) {
+      entries_.pop_back();
+    }
+    entries_.emplace(entries_.begin(), std::move(key), std::move(new_plan));
+    return Status::OK();
+  }
+
+  size_t Size() const {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    return entries_.size();
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ShapePlanCache);
+
+  const size_t capacity_;
+  mutable OrtMutex mutex_;
+  mutable InlinedVector<std::pair<ShapePlanKey, std::shared_ptr<const Plan>>> entries_;
+};
+
+}  // namespace onnxruntime
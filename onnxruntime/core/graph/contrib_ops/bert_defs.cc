@@ -277,11 +277,12 @@ void BaseGroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceConte
   }
 
   if (ctx.getNumOutputs() > 1) {  // has present output
-    // copy the type from query to present key
-    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 1);
-
-    // copy the type from query to present value
-    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 2);
+    // copy the type from past key, or query when there is no past, to present key and value
+    const bool has_past_key = past_key_index >= 0 && ctx.getNumInputs() > static_cast<size_t>(past_key_index) &&
+                              ctx.getInputType(past_key_index) != nullptr;
+    const size_t present_type_index = has_past_key ? static_cast<size_t>(past_key_index) : 0;
+    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, present_type_index, 1);
+    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, present_type_index, 2);
 
     if (past_key_index >= 0 && hasInputShape(ctx, past_key_index)) {
       auto& past_shape = getInputShape(ctx, past_key_index);
@@ -318,7 +319,21 @@ void BaseGroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceConte
 
 void GroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_key_index) {
   // TODO(aciddelgado): propagate output shapes depending if kv-share buffer is on or not
-  constexpr int use_max_past_present_buffer = -1;
+  // With a paged KV cache (block_table), present key and value have the blocks of past key and value.
+  const bool has_block_table = ctx.getNumInputs() > 9 && ctx.getInputType(9) != nullptr;
+  const int use_max_past_present_buffer = has_block_table ? 1 : -1;
+
+  // The KV cache is of the type of query, or int8 when it is quantized. The kernels have no other combination.
+  if (ctx.getNumInputs() > static_cast<size_t>(past_key_index) && ctx.getInputType(past_key_index) != nullptr &&
+      ctx.getInputType(0) != nullptr) {
+    const auto query_type = ctx.getInputType(0)->tensor_type().elem_type();
+    const auto cache_type = ctx.getInputType(past_key_index)->tensor_type().elem_type();
+    if (cache_type != query_type && cache_type != ONNX_NAMESPACE::TensorProto_DataType_INT8) {
+      fail_type_inference("past_key and past_value shall be of the type of query or int8. Got cache type ",
+                          cache_type, " and query type ", query_type);
+    }
+  }
+
   BaseGroupQueryAttentionTypeAndShapeInference(ctx, past_key_index, use_max_past_present_buffer);
 }
 
@@ -1049,6 +1064,14 @@ Supports different number of heads for q and kv for CPU and CUDA.
 Only supports causal and local attention.
 Supports rotary position embedding for CPU and CUDA.
 Supports packed input for CPU and CUDA.
+Supports a paged KV cache for CPU: when block_table is given, past and present key/value are caches of fixed size
+blocks with shape (num_blocks, kv_num_heads, block_size, head_size), and row b of block_table gives the blocks holding
+the tokens of sequence b in order. The cache grows with the tokens of the sequences instead of their maximum length.
+Use the same buffer for past and present key/value (IOBinding) to update the cache in place.
+Supports an int8 KV cache for CPU: when past_key/past_value are int8, the key and value of the new tokens are
+quantized with the symmetric per kv head scales k_scale/v_scale (zero point 0), and the cache is dequantized on the
+fly when computing the attention. past_key and past_value are required for an int8 cache (with past sequence length 0
+for the prompt when not using a shared buffer).
 )DOC";
 
 ONNX_MS_OPERATOR_SET_SCHEMA(
@@ -1091,14 +1114,16 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
         .Input(3,
                "past_key",
                "past state key with support for format BNSH. When past_key uses same tensor as present_key"
-               "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length. "
+               "Of type T, or int8 for a quantized cache.",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(4,
                "past_value",
                "past state value with support for format BNSH. When past_value uses same tensor as present_value"
-               "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length. "
+               "Of the type of past_key.",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(5,
                "seqlens_k",
@@ -1119,6 +1144,25 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "2D tensor with shape (max_sequence_length, head_size / 2).",
                "T",
                OpSchema::Optional)
+        .Input(9,
+               "block_table",
+               "2D tensor with shape (batch_size, max_blocks_per_sequence). When given, past_key and past_value are "
+               "paged KV caches with shape (num_blocks, kv_num_heads, block_size, head_size), and the entries give "
+               "the blocks holding the tokens of each sequence in order.",
+               "M",
+               OpSchema::Optional)
+        .Input(10,
+               "k_scale",
+               "1D tensor with shape (kv_num_heads) or (1). Scales of the int8 key cache, required when past_key is "
+               "int8.",
+               "tensor(float)",
+               OpSchema::Optional)
+        .Input(11,
+               "v_scale",
+               "1D tensor with shape (kv_num_heads) or (1). Scales of the int8 value cache, required when past_value "
+               "is int8.",
+               "tensor(float)",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "3D output tensor with shape (batch_size, sequence_length, hidden_size)",
@@ -1127,15 +1171,17 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                 "present_key",
                 "present state key with support for format BNSH. When past_key uses same tensor as present_key"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
-                "kv_sequence_length.",
-                "T")
+                "kv_sequence_length. Of the type of past_key, or T when there is no past_key.",
+                "T_CACHE")
         .Output(2,
                 "present_value",
                 "present state value with support for format BNSH. When past_value uses same tensor as present_value"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
-                "kv_sequence_length.",
-                "T")
+                "kv_sequence_length. Of the type of present_key.",
+                "T_CACHE")
         .TypeConstraint("T", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)"}, "Constrain input and output to float tensors.")
+        .TypeConstraint("T_CACHE", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)", "tensor(int8)"},
+                        "Constrain KV cache to float tensors of type T, or int8 tensors for a quantized cache.")
         .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask to int tensor.")
         .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
           GroupQueryAttentionTypeAndShapeInference(ctx, 3);
@@ -631,6 +631,37 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           return true;
         }));
 
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+Evaluates a chain of elementwise operators in a single pass over the data, without materializing the intermediate
+results. Step i applies ops[i] to operands[2 * i] and operands[2 * i + 1], where an operand indexes the inputs
+followed by the results of the previous steps, and the second operand of a unary step is -1.
+The inputs are broadcast together with multidirectional (Numpy-style) broadcasting and the output is the result of
+the last step. Binary steps: Add, Sub, Mul, Div, Max, Min. Unary steps: Neg, Abs, Sqrt, Exp, Log, Reciprocal, Relu,
+Sigmoid, Tanh, Erf.)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    FusedElementwise, 1,
+    OpSchema()
+        .SetDoc(FusedElementwise_ver1_doc)
+        .Attr("ops", "Operator type of every step, in evaluation order.", AttributeProto::STRINGS)
+        .Attr("operands", "Two operands per step, indices into the inputs followed by the step results.",
+              AttributeProto::INTS)
+        .Input(0, "inputs", "The inputs of the chain.", "T", OpSchema::Variadic)
+        .Output(0, "Y", "The result of the last step, with the broadcast shape of the inputs.", "T")
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          propagateElemTypeFromInputToOutput(ctx, 0, 0);
+          const size_t num_inputs = ctx.getNumInputs();
+          if (hasNInputShapes(ctx, static_cast<int>(num_inputs))) {
+            std::vector<const ONNX_NAMESPACE::TensorShapeProto*> shapes;
+            for (size_t i = 0; i < num_inputs; ++i) {
+              shapes.push_back(&ctx.getInputType(i)->tensor_type().shape());
+            }
+            multidirectionalBroadcastShapeInference(
+                shapes, *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape());
+          }
+        }));
+
 // Used to be ONNX 1.7 Inverse(12)
 // Comment out docs not to increase the binary size
 //
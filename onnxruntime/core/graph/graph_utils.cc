@@ -903,6 +903,46 @@ NodeArg& CreateNodeArg(Graph& graph, const NodeArg& base_arg) {
   return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(base_arg.Name()), base_arg.TypeAsProto());
 }
 
+static size_t ElementSizeInBytes(int32_t elem_type) {
+  switch (elem_type) {
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT64:
+    case ONNX_NAMESPACE::TensorProto_DataType_COMPLEX64:
+      return 8;
+    case ONNX_NAMESPACE::TensorProto_DataType_COMPLEX128:
+      return 16;
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT16:
+      return 2;
+    case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+      return 1;
+    default:
+      return 4;
+  }
+}
+
+int64_t EstimateTensorSizeInBytes(const NodeArg& node_arg) {
+  constexpr int64_t unknown_dim_value = 64;
+  const auto* type = node_arg.TypeAsProto();
+  if (type == nullptr || type->value_case() != ONNX_NAMESPACE::TypeProto::kTensorType) {
+    return 0;
+  }
+  int64_t size = static_cast<int64_t>(ElementSizeInBytes(type->tensor_type().elem_type()));
+  const auto* shape = node_arg.Shape();
+  if (shape == nullptr) {
+    return size * unknown_dim_value;
+  }
+  for (const auto& dim : shape->dim()) {
+    size *= (dim.has_dim_value() && dim.dim_value() >= 0) ? dim.dim_value() : unknown_dim_value;
+  }
+  return size;
+}
+
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 }  // namespace graph_utils
@@ -396,6 +396,12 @@ bool RemoveNodesWithOneOutputBottomUp(Graph& graph, const Node& node);
  */
 NodeArg& CreateNodeArg(Graph& graph, const NodeArg& base_arg);
 
+/** Estimates the size in bytes of a tensor from the type and shape of its NodeArg.
+ * Unknown or symbolic dimensions count as a fixed value (64), so a tensor with more unknown dimensions is
+ * considered larger. Returns 0 for values that are not tensors.
+ */
+int64_t EstimateTensorSizeInBytes(const NodeArg& node_arg);
+
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 }  // namespace graph_utils
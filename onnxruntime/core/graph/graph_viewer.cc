@@ -2,6 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/graph/graph_viewer.h"
+
+#include <limits>
+#include <set>
+
+#include "core/graph/graph_utils.h"
 #include "core/graph/indexed_sub_graph.h"
 
 namespace onnxruntime {
@@ -43,6 +48,115 @@ struct PriorityNodeCompare {
     return n1->Index() > n2->Index();
   }
 };
+
+namespace {
+
+// Number of ready nodes scored at every step of MemoryAwareTopologicalSort, bounds its cost on wide graphs.
+constexpr size_t kMaxMemoryAwareCandidates = 64;
+
+// Greedy topological sort reducing the peak size of the tensors produced by the nodes and still alive.
+// Among the nodes ready to run with the lowest priority value, it picks the one releasing the most bytes minus
+// the bytes it allocates. Ties are broken by the position in `order`, which also selects the
+// kMaxMemoryAwareCandidates ready nodes scored.
+std::vector<NodeIndex> MemoryAwareTopologicalSort(const GraphViewer& graph_viewer,
+                                                  const std::vector<NodeIndex>& order) {
+  constexpr size_t kNotInGraph = std::numeric_limits<size_t>::max();
+  const size_t num_nodes = order.size();
+  std::vector<size_t> position(static_cast<size_t>(graph_viewer.MaxNodeIndex()), kNotInGraph);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    position[order[i]] = i;
+  }
+
+  InlinedHashSet<const NodeArg*> graph_outputs(graph_viewer.GetOutputs().begin(), graph_viewer.GetOutputs().end());
+  InlinedHashMap<const NodeArg*, int64_t> value_sizes;
+  InlinedHashMap<const NodeArg*, size_t> remaining_consumers;
+  std::vector<InlinedVector<const NodeArg*>> node_inputs(num_nodes);
+  std::vector<int64_t> node_output_sizes(num_nodes, 0);
+  std::vector<size_t> in_degree(num_nodes, 0);
+
+  for (size_t i = 0; i < num_nodes; ++i) {
+    const Node* node = graph_viewer.GetNode(order[i]);
+    for (auto edge = node->InputEdgesBegin(); edge != node->InputEdgesEnd(); ++edge) {
+      if (position[edge->GetNode().Index()] != kNotInGraph) {
+        ++in_degree[i];
+      }
+    }
+    for (const auto* output : node->OutputDefs()) {
+      if (output->Exists()) {
+        int64_t size = graph_utils::EstimateTensorSizeInBytes(*output);
+        value_sizes[output] = size;
+        node_output_sizes[i] += size;
+      }
+    }
+    auto add_input = [&](const NodeArg* input) {
+      if (input->Exists() &&
+          std::find(node_inputs[i].begin(), node_inputs[i].end(), input) == node_inputs[i].end()) {
+        node_inputs[i].push_back(input);
+        ++remaining_consumers[input];
+      }
+    };
+    for (const auto* input : node->InputDefs()) {
+      add_input(input);
+    }
+    for (const auto* input : node->ImplicitInputDefs()) {
+      add_input(input);
+    }
+  }
+
+  std::set<size_t> ready;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    if (in_degree[i] == 0) {
+      ready.insert(i);
+    }
+  }
+
+  std::vector<NodeIndex> memory_aware_order;
+  memory_aware_order.reserve(num_nodes);
+  while (!ready.empty()) {
+    auto best = ready.begin();
+    int best_priority = std::numeric_limits<int>::max();
+    int64_t best_score = std::numeric_limits<int64_t>::lowest();
+    size_t candidates = 0;
+    for (auto it = ready.begin(); it != ready.end() && candidates < kMaxMemoryAwareCandidates; ++it, ++candidates) {
+      const int priority = graph_viewer.GetNode(order[*it])->Priority();
+      if (priority > best_priority) {
+        continue;
+      }
+      int64_t score = -node_output_sizes[*it];
+      for (const auto* input : node_inputs[*it]) {
+        auto size = value_sizes.find(input);
+        if (size != value_sizes.end() && remaining_consumers[input] == 1 && graph_outputs.count(input) == 0) {
+          score += size->second;
+        }
+      }
+      if (priority < best_priority || score > best_score) {
+        best_priority = priority;
+        best_score = score;
+        best = it;
+      }
+    }
+
+    const size_t i = *best;
+    ready.erase(best);
+    memory_aware_order.push_back(order[i]);
+    for (const auto* input : node_inputs[i]) {
+      --remaining_consumers[input];
+    }
+    const Node* node = graph_viewer.GetNode(order[i]);
+    for (auto edge = node->OutputEdgesBegin(); edge != node->OutputEdgesEnd(); ++edge) {
+      const size_t next = position[edge->GetNode().Index()];
+      if (next != kNotInGraph && --in_degree[next] == 0) {
+        ready.insert(next);
+      }
+    }
+  }
+
+  ORT_ENFORCE(memory_aware_order.size() == num_nodes,
+              "Memory aware topological sort failed.", memory_aware_order.size(), "!=", num_nodes);
+  return memory_aware_order;
+}
+
+}  // namespace
 #endif
 
 GraphViewer::GraphViewer(const Graph& graph)
@@ -325,6 +439,16 @@ const std::vector<NodeIndex>& GraphViewer::GetNodesInTopologicalOrder(ExecutionO
       return nodes_in_mem_efficient_topological_order_;
 #else
       ORT_THROW("Memory efficient topological order is not enabled for non-training build.");
+#endif
+    case ExecutionOrder::MEMORY_AWARE:
+#if !defined(ORT_MINIMAL_BUILD)
+      std::call_once(nodes_in_memory_aware_topological_order_flag_, [this]() {
+        nodes_in_memory_aware_topological_order_ =
+            MemoryAwareTopologicalSort(*this, nodes_in_topological_order_with_priority_);
+      });
+      return nodes_in_memory_aware_topological_order_;
+#else
+      ORT_THROW("Memory aware topological order is not enabled for ORT minimal build.");
 #endif
     default:
       ORT_THROW("Invalid ExecutionOrder");
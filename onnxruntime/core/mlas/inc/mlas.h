@@ -1845,6 +1845,16 @@ struct MlasFlashAttentionThreadedArgs {
     const float* key;
     const float* value;
     float* output;
+    // Number of heads of key and value. Query head h uses key/value head h / (num_heads / kv_num_heads).
+    // 0 means num_heads.
+    int kv_num_heads = 0;
+    // Causal masking: query row i attends to key columns j <= i + max(kv_length - q_sequence_length, 0).
+    bool is_causal = false;
+    // Optional valid lengths of key and value per batch (kv_length). key and value keep a row stride of
+    // kv_sequence_length per head, and the columns after kv_length are ignored.
+    const int* kv_sequence_lengths = nullptr;
+    // Optional stride between the batches of query, in elements. 0 means num_heads * q_sequence_length * qk_head_size.
+    size_t query_batch_stride = 0;
 };
 
 /**
@@ -24,6 +24,11 @@ MlasFlashAttentionThreaded(
     const float* key = args->key;
     const float* value = args->value;
     float* output = args->output;
+    ptrdiff_t kv_num_heads = args->kv_num_heads > 0 ? static_cast<ptrdiff_t>(args->kv_num_heads) : num_heads;
+    ptrdiff_t kv_num_heads_factor = num_heads / kv_num_heads;
+    ptrdiff_t query_batch_stride = args->query_batch_stride > 0
+                                       ? static_cast<ptrdiff_t>(args->query_batch_stride)
+                                       : num_heads * q_sequence_length * qk_head_size;
 
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
     auto&& mlas_platform = GetMlasPlatform();
@@ -61,7 +66,20 @@ MlasFlashAttentionThreaded(
         float* temp_output = intermediate + q_block_size * kv_block_size;
         float negmax = 0;
 
-        for (ptrdiff_t ir = 0; ir < kv_sequence_length; ir += kv_block_size) {
+        ptrdiff_t kv_length = kv_sequence_length;
+        if (args->kv_sequence_lengths != nullptr) {
+            kv_length = std::min(kv_sequence_length, static_cast<ptrdiff_t>(args->kv_sequence_lengths[batch_idx]));
+        }
+        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
+
+        // With causal masking, the key blocks after the last column seen by the query block are skipped.
+        ptrdiff_t causal_offset = std::max(kv_length - q_sequence_length, ptrdiff_t{0});
+        ptrdiff_t kv_end = kv_length;
+        if (args->is_causal) {
+            kv_end = std::min(kv_length, q_idx + row_size_q_valid + causal_offset);
+        }
+
+        for (ptrdiff_t ir = 0; ir < kv_end; ir += kv_block_size) {
             /*
                 S = Q[batch_idx, head_idx, q_idx:q_idx+q_block_size, :] * (K[batch_idx, head_idx, ir:ir+kv_block_size, :]).T
                 old_m = m
@@ -71,13 +89,13 @@ MlasFlashAttentionThreaded(
                 l = exp(diff) * l + rowsum(S)
                 O = diag(exp(diff)) * O + S * V[batch_idx, head_idx, ir:ir+kv_block_size, :]
             */
-            ptrdiff_t h = batch_idx * num_heads + head_idx;
-            const float* inputQ = query + (h * q_sequence_length + q_idx) * qk_head_size;
-            const float* inputK = key + (h * kv_sequence_length + ir) * qk_head_size;
-            const float* inputV = value + (h * kv_sequence_length + ir) * v_head_size;
+            ptrdiff_t kv_h = batch_idx * kv_num_heads + head_idx / kv_num_heads_factor;
+            const float* inputQ = query + batch_idx * query_batch_stride + (head_idx * q_sequence_length + q_idx) * qk_head_size;
+            const float* inputK = key + (kv_h * kv_sequence_length + ir) * qk_head_size;
+            const float* inputV = value + (kv_h * kv_sequence_length + ir) * v_head_size;
 
-            size_t row_size_q_capped = static_cast<size_t>(std::min(q_block_size, q_sequence_length - q_idx));
-            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_sequence_length - ir));
+            size_t row_size_q_capped = static_cast<size_t>(row_size_q_valid);
+            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_end - ir));
 
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
                      CBLAS_TRANSPOSE::CblasTrans,
@@ -96,6 +114,14 @@ MlasFlashAttentionThreaded(
             for (ptrdiff_t irow = 0; irow < static_cast<ptrdiff_t>(row_size_q_capped); ++irow) {
                 float* p = intermediate + irow * row_size_kv_capped;
 
+                if (args->is_causal) {
+                    // The first column is always seen, so the row max of the first block is finite.
+                    ptrdiff_t first_masked = std::max(q_idx + irow + causal_offset + 1 - ir, ptrdiff_t{0});
+                    for (ptrdiff_t icol = first_masked; icol < static_cast<ptrdiff_t>(row_size_kv_capped); ++icol) {
+                        p[icol] = std::numeric_limits<float>::lowest();
+                    }
+                }
+
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
                 float rowmax = mlas_platform.ReduceMaximumF32Kernel(p, row_size_kv_capped);
 #else
@@ -141,7 +167,6 @@ MlasFlashAttentionThreaded(
         }
 
         float* output_row = output + ((batch_idx * q_sequence_length + q_idx) * num_heads + head_idx) * v_head_size;
-        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
         // TODO: leverage advanced instruction sets
         for (ptrdiff_t irow = 0; irow < row_size_q_valid; ++irow) {
             for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
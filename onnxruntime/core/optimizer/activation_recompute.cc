@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/activation_recompute.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Operators cheap enough to be run a second time. Their output is a new buffer, operators that may alias their
+// input (Reshape, Squeeze, Identity, ...) would not release anything.
+bool IsCheapToRecompute(const Node& node) {
+  static const InlinedHashSet<std::string_view> cheap_ops = {
+      "Abs", "Add", "Cast", "ConstantOfShape", "Div", "Equal", "Erf", "Expand", "Greater", "Less", "Mul", "Neg",
+      "Not", "Range", "Relu", "Sigmoid", "Sub", "Tanh", "Tile", "Transpose", "Where"};
+  return node.Domain() == kOnnxDomain && node.OutputDefs().size() == 1 && !node.ContainsSubgraph() &&
+         cheap_ops.count(node.OpType()) > 0;
+}
+
+struct ValueLifetime {
+  const Node* producer;
+  int64_t size;
+  size_t start;  // step of the producer
+  size_t end;    // step of the last consumer
+  bool pinned;   // graph output or consumed by a subgraph
+};
+
+}  // namespace
+
+Status ActivationRecompute::ApplyImpl(Graph& graph, bool& modified, int /*graph_level*/,
+                                      const logging::Logger& logger) const {
+  if (memory_budget_in_bytes_ <= 0) {
+    return Status::OK();
+  }
+
+  for (int recomputations = 0;; ++recomputations) {
+    GraphViewer graph_viewer(graph);
+    const auto& order = graph_viewer.GetNodesInTopologicalOrder(execution_order_);
+    const size_t num_steps = order.size();
+    if (num_steps == 0) {
+      break;
+    }
+
+    InlinedHashMap<NodeIndex, size_t> steps;
+    steps.reserve(num_steps);
+    for (size_t i = 0; i < num_steps; ++i) {
+      steps[order[i]] = i;
+    }
+
+    InlinedHashSet<const NodeArg*> graph_outputs(graph_viewer.GetOutputs().begin(), graph_viewer.GetOutputs().end());
+    InlinedHashMap<const NodeArg*, ValueLifetime> values;
+    for (size_t i = 0; i < num_steps; ++i) {
+      const Node* node = graph_viewer.GetNode(order[i]);
+      for (const auto* output : node->OutputDefs()) {
+        if (output->Exists()) {
+          const bool is_graph_output = graph_outputs.count(output) > 0;
+          values[output] = ValueLifetime{node, graph_utils::EstimateTensorSizeInBytes(*output), i,
+                                         is_graph_output ? num_steps - 1 : i, is_graph_output};
+        }
+      }
+    }
+    for (size_t i = 0; i < num_steps; ++i) {
+      const Node* node = graph_viewer.GetNode(order[i]);
+      for (const auto* input : node->InputDefs()) {
+        auto it = values.find(input);
+        if (it != values.end()) {
+          it->second.end = std::max(it->second.end, i);
+        }
+      }
+      for (const auto* input : node->ImplicitInputDefs()) {
+        auto it = values.find(input);
+        if (it != values.end()) {
+          it->second.end = std::max(it->second.end, i);
+          it->second.pinned = true;
+        }
+      }
+    }
+
+    // bytes alive at every step
+    std::vector<int64_t> live_bytes(num_steps + 1, 0);
+    for (const auto& value : values) {
+      live_bytes[value.second.start] += value.second.size;
+      live_bytes[value.second.end + 1] -= value.second.size;
+    }
+    size_t peak_step = 0;
+    int64_t peak_bytes = live_bytes[0];
+    for (size_t i = 1; i < num_steps; ++i) {
+      live_bytes[i] += live_bytes[i - 1];
+      if (live_bytes[i] > peak_bytes) {
+        peak_bytes = live_bytes[i];
+        peak_step = i;
+      }
+    }
+
+    if (peak_bytes <= memory_budget_in_bytes_) {
+      LOGS(logger, INFO) << "Estimated peak activation memory " << peak_bytes << " bytes is within the budget of "
+                         << memory_budget_in_bytes_ << " bytes after " << recomputations << " recomputation(s).";
+      break;
+    }
+    if (recomputations == kMaxRecomputations) {
+      LOGS(logger, WARNING) << "Estimated peak activation memory " << peak_bytes << " bytes exceeds the budget of "
+                            << memory_budget_in_bytes_ << " bytes after " << recomputations << " recomputations.";
+      break;
+    }
+
+    // Picks the largest value alive across the peak, not used by the node running at the peak, produced by a cheap
+    // node whose inputs are still alive when the value is needed again.
+    const NodeArg* best = nullptr;
+    int64_t best_size = 0;
+    for (const auto& value : values) {
+      const ValueLifetime& lifetime = value.second;
+      if (lifetime.pinned || lifetime.start >= peak_step || lifetime.end <= peak_step ||
+          lifetime.size <= best_size || !IsCheapToRecompute(*lifetime.producer) ||
+          lifetime.producer->Priority() >= static_cast<int>(ExecutionPriority::LOCAL_LOW)) {
+        continue;
+      }
+
+      size_t next_use = num_steps;
+      bool used_at_peak = false;
+      for (const auto* consumer : graph.GetConsumerNodes(value.first->Name())) {
+        const size_t step = steps.at(consumer->Index());
+        used_at_peak = used_at_peak || step == peak_step;
+        if (step > peak_step) {
+          next_use = std::min(next_use, step);
+        }
+      }
+      if (used_at_peak) {
+        continue;
+      }
+
+      const bool inputs_alive = std::all_of(
+          lifetime.producer->InputDefs().begin(), lifetime.producer->InputDefs().end(),
+          [&values, next_use](const NodeArg* input) {
+            auto it = values.find(input);
+            return it == values.end() || it->second.end >= next_use;
+          });
+      if (inputs_alive) {
+        best = value.first;
+        best_size = lifetime.size;
+      }
+    }
+
+    if (best == nullptr) {
+      LOGS(logger, WARNING) << "Estimated peak activation memory " << peak_bytes << " bytes exceeds the budget of "
+                            << memory_budget_in_bytes_ << " bytes and no value alive at step " << peak_step
+                            << " can be recomputed.";
+      break;
+    }
+
+    Node& producer = *graph.GetNode(values.at(best).producer->Index());
+    InlinedVector<Node*> late_consumers;
+    bool has_early_consumers = false;
+    for (auto* consumer : graph.GetMutableConsumerNodes(best->Name())) {
+      if (steps.at(consumer->Index()) > peak_step) {
+        late_consumers.push_back(consumer);
+      } else {
+        has_early_consumers = true;
+      }
+    }
+
+    if (!has_early_consumers) {
+      // Only used after the peak: the producer is delayed instead of duplicated.
+      LOGS(logger, VERBOSE) << "Delaying node " << producer.Name() << " producing " << best_size << " bytes.";
+      producer.SetPriority(static_cast<int>(ExecutionPriority::LOCAL_LOW));
+    } else {
+      LOGS(logger, VERBOSE) << "Recomputing node " << producer.Name() << " producing " << best_size << " bytes.";
+      NodeArg& recomputed_arg = graph_utils::CreateNodeArg(graph, *best);
+      std::vector<NodeArg*> input_args = producer.MutableInputDefs();
+      std::vector<NodeArg*> output_args{&recomputed_arg};
+      Node& recompute_node = graph.AddNode(graph.GenerateNodeName(producer.Name() + "_recompute"),
+                                           producer.OpType(),
+                                           "Recompute of " + producer.Name(),
+                                           input_args,
+                                           output_args,
+                                           &producer.GetAttributes(),
+                                           producer.Domain());
+      recompute_node.SetExecutionProviderType(producer.GetExecutionProviderType());
+      recompute_node.SetPriority(static_cast<int>(ExecutionPriority::LOCAL_LOW));
+      for (Node* consumer : late_consumers) {
+        const auto& input_defs = consumer->InputDefs();
+        for (size_t k = 0; k < input_defs.size(); ++k) {
+          if (input_defs[k] == best) {
+            graph_utils::ReplaceNodeInput(*consumer, static_cast<int>(k), recomputed_arg);
+          }
+        }
+      }
+    }
+
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/framework/session_options.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class ActivationRecompute
+
+Transformer keeping the estimated peak size of the intermediate values under a memory budget for inference.
+It simulates the execution order used by the session, finds the step where the most bytes are alive and
+recomputes a large value alive across that step right before its next consumer, if it is produced by a cheap
+operator whose inputs are still alive at that point. The recomputed node gets a low priority so that the
+priority based and memory aware execution orders only run it when its consumer needs it.
+The sizes are estimated from the shapes, symbolic dimensions should be fixed with free dimension overrides to
+make the budget meaningful.
+*/
+class ActivationRecompute : public GraphTransformer {
+ public:
+  ActivationRecompute(int64_t memory_budget_in_bytes, ExecutionOrder execution_order) noexcept
+      : GraphTransformer("ActivationRecompute"),
+        memory_budget_in_bytes_(memory_budget_in_bytes),
+        execution_order_(execution_order) {}
+
+  bool ShouldOnlyApplyOnce() const override { return true; }
+
+  // Maximum number of values recomputed or moved to meet the budget.
+  static constexpr int kMaxRecomputations = 64;
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  const int64_t memory_budget_in_bytes_;
+  const ExecutionOrder execution_order_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,160 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_chain_fusion.h"
+
+#include <algorithm>
+#include <array>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// The operators the FusedElementwise kernel evaluates, with their arity.
+bool IsFusableElementwiseNode(const Node& node, bool& is_binary) {
+  static const std::vector<std::string> supported_data_types{"tensor(float)"};
+  if (node.OutputDefs().size() != 1 || !optimizer_utils::IsSupportedDataType(node, supported_data_types)) {
+    return false;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Max", {8, 12, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Min", {8, 12, 13})) {
+    is_binary = true;
+    return node.InputDefs().size() == 2;
+  }
+
+  is_binary = false;
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Log", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9, 13});
+}
+
+}  // namespace
+
+Status ElementwiseChainFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                         const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedHashMap<NodeIndex, size_t> topological_position;
+  topological_position.reserve(node_topology_list.size());
+  for (size_t i = 0; i < node_topology_list.size(); ++i) {
+    topological_position[node_topology_list[i]] = i;
+  }
+
+  // Visit the nodes from the outputs of the graph, so that every chain starts from its last node.
+  for (auto it = node_topology_list.rbegin(); it != node_topology_list.rend(); ++it) {
+    auto* p_node = graph.GetNode(*it);
+    if (!p_node) continue;  // fused into a chain
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    bool is_binary = false;
+    if (!IsFusableElementwiseNode(node, is_binary) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    InlinedHashSet<NodeIndex> chain{node.Index()};
+    InlinedVector<std::reference_wrapper<Node>> chain_nodes{node};
+    for (size_t i = 0; i < chain_nodes.size() && chain.size() < kMaxChainLength; ++i) {
+      for (auto input_edge = chain_nodes[i].get().InputEdgesBegin(); input_edge != chain_nodes[i].get().InputEdgesEnd();
+           ++input_edge) {
+        Node& producer = *graph.GetNode(input_edge->GetNode().Index());
+        if (chain.count(producer.Index()) || chain.size() >= kMaxChainLength ||
+            !IsFusableElementwiseNode(producer, is_binary) ||
+            producer.GetExecutionProviderType() != node.GetExecutionProviderType() ||
+            graph.NodeProducesGraphOutput(producer)) {
+          continue;
+        }
+
+        // the intermediate result must not be needed outside of the chain
+        bool all_consumers_in_chain = true;
+        for (auto output_edge = producer.OutputEdgesBegin(); output_edge != producer.OutputEdgesEnd(); ++output_edge) {
+          if (!chain.count(output_edge->GetNode().Index())) {
+            all_consumers_in_chain = false;
+            break;
+          }
+        }
+        if (!all_consumers_in_chain) {
+          continue;
+        }
+
+        chain.insert(producer.Index());
+        chain_nodes.push_back(producer);
+      }
+    }
+
+    if (chain_nodes.size() < 2) {
+      continue;
+    }
+
+    // Steps in evaluation order. The operands index the inputs of the fused node first, then the step results.
+    std::sort(chain_nodes.begin(), chain_nodes.end(), [&topological_position](const Node& a, const Node& b) {
+      return topological_position.at(a.Index()) < topological_position.at(b.Index());
+    });
+
+    InlinedVector<NodeArg*> fused_inputs;
+    InlinedHashMap<const NodeArg*, int64_t> step_results;
+    for (size_t i = 0; i < chain_nodes.size(); ++i) {
+      for (const NodeArg* input : chain_nodes[i].get().InputDefs()) {
+        if (!step_results.count(input) &&
+            std::find(fused_inputs.begin(), fused_inputs.end(), input) == fused_inputs.end()) {
+          fused_inputs.push_back(const_cast<NodeArg*>(input));
+        }
+      }
+      step_results[chain_nodes[i].get().OutputDefs()[0]] = static_cast<int64_t>(i);
+    }
+
+    std::vector<std::string> ops;
+    std::vector<int64_t> operands;
+    ops.reserve(chain_nodes.size());
+    operands.reserve(2 * chain_nodes.size());
+    for (const Node& step_node : chain_nodes) {
+      ops.push_back(step_node.OpType());
+      for (size_t j = 0; j < 2; ++j) {
+        if (j >= step_node.InputDefs().size()) {
+          operands.push_back(-1);
+          continue;
+        }
+        const NodeArg* input = step_node.InputDefs()[j];
+        auto step_result = step_results.find(input);
+        if (step_result != step_results.end()) {
+          operands.push_back(static_cast<int64_t>(fused_inputs.size()) + step_result->second);
+        } else {
+          operands.push_back(std::find(fused_inputs.begin(), fused_inputs.end(), input) - fused_inputs.begin());
+        }
+      }
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "/ElementwiseChainFusion/"),
+                                     "FusedElementwise", "Fused chain of elementwise operators", fused_inputs,
+                                     std::array{node.MutableOutputDefs()[0]}, {}, kMSDomain);
+    fused_node.AddAttribute("ops", ops);
+    fused_node.AddAttribute("operands", operands);
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    // the chain ends with node, the edges from the producers of the other inputs are rebuilt when resolving the graph
+    graph_utils::FinalizeNodeFusion(graph, chain_nodes, fused_node);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
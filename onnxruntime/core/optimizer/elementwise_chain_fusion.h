@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Fuse chains of float elementwise operators into a single com.microsoft FusedElementwise node, so that
+ * the intermediate results are never materialized as full size tensors.
+ *
+ * A chain grows from its last node towards the producers of its inputs. A producer joins the chain when it is a
+ * supported elementwise operator assigned to the same execution provider, and all the consumers of its output are
+ * already part of the chain.
+ */
+class ElementwiseChainFusion : public GraphTransformer {
+ public:
+  ElementwiseChainFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseChainFusion", compatible_execution_providers) {}
+
+  // Upper bound on the number of operators fused into one node.
+  static constexpr size_t kMaxChainLength = 32;
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -34,6 +34,7 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_chain_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
@@ -403,6 +404,10 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       // PR #6351 implemented similar fusion-pattern for CUDA only, and can only fuse conv-add-relu,
       // while we can fuse more activation.
       transformers.emplace_back(std::make_unique<ConvAddActivationFusion>(cpu_ep));
+
+      // ElementwiseChainFusion runs last so that it only picks up the elementwise operators which none of the
+      // pattern specific fusions above (Gelu, LayerNorm, Conv activations, ...) consumed.
+      transformers.emplace_back(std::make_unique<ElementwiseChainFusion>(cpu_ep));
 #endif
 
     } break;
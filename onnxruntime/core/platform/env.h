@@ -91,6 +91,13 @@ struct ThreadOptions {
   void* custom_thread_creation_options = nullptr;
   OrtCustomJoinThreadFn custom_join_thread_fn = nullptr;
   int dynamic_block_base_ = 0;
+
+  // NUMA node of each thread, indexed in the same way as affinities (i.e. the first element is the placeholder for
+  // the main thread). If the vector is not empty and spans more than one node, the thread pool groups its workers
+  // per node: work stealing prefers victims on the same node, and parallel loops give each node its own
+  // contiguous slice of the iteration space.
+  // If the vector is empty, the thread pool is not NUMA-aware.
+  std::vector<int> numa_nodes;
 };
 
 std::ostream& operator<<(std::ostream& os, const LogicalProcessors&);
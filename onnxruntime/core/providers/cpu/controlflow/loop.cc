@@ -21,7 +21,9 @@
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/framework/session_options.h"
 #include "core/framework/TensorSeq.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/utils.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 #include <gsl/gsl>
 
@@ -193,6 +195,24 @@ Loop::Info::Info(const onnxruntime::Node& node, const GraphViewer& subgraph_in)
     auto& output = subgraph_outputs[i];
     subgraph_output_names.push_back(output->Name());
   }
+
+  // the buffer of a loop carried var can be handed back to the subgraph for the output of a later iteration if the
+  // subgraph allocates it for that output alone. it must be a tensor produced by a node, and no other output may be
+  // the same value or pass the input of the loop carried var through.
+  reuse_loop_carried_buffers.reserve(num_loop_carried_vars);
+  for (int i = 0; i < num_loop_carried_vars; ++i) {
+    const auto* output = subgraph_outputs[static_cast<size_t>(i) + 1];  // skip cond
+    const auto& input_name = subgraph_input_names[static_cast<size_t>(i) + 2];  // skip iter_num and cond
+    bool reuse = output->TypeAsProto() != nullptr && output->TypeAsProto()->has_tensor_type() &&
+                 subgraph.GetProducerNode(output->Name()) != nullptr;
+    for (int j = 0; reuse && j < num_subgraph_outputs; ++j) {
+      reuse = j == i + 1 ||
+              (subgraph_output_names[j] != output->Name() &&
+               !controlflow::detail::IsPassThroughOutput(subgraph, subgraph_output_names[j], input_name));
+    }
+
+    reuse_loop_carried_buffers.push_back(reuse);
+  }
 }
 
 class LoopImpl {
@@ -200,7 +220,8 @@ class LoopImpl {
   LoopImpl(OpKernelContextInternal& context,
            const SessionState& session_state,
            const Loop::Info& info,
-           const Loop::ConcatOutput& concat_output_func);
+           const Loop::ConcatOutput& concat_output_func,
+           bool concurrent_iterations);
 
   // Initialize by validating all the inputs, and allocating the output tensors
   Status Initialize();
@@ -210,12 +231,23 @@ class LoopImpl {
   Status Execute(const FeedsFetchesManager& cached_ffm);
 
  private:
+  // Execute the iterations of a body that passes its loop carried vars through and keeps the condition true.
+  // The first iteration gives the shapes of the loop outputs, the others run concurrently and write their slice of
+  // the loop outputs directly.
+  Status ExecuteConcurrently(const FeedsFetchesManager& ffm);
+
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
   void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
 
+  // create the fetch allocators that hand the spare buffers of the loop carried vars to the subgraph
+  void CreateLoopCarriedFetchAllocators(std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
 
+  // copy the value of a loop carried var to the Loop output. the value is moved if it is a subgraph output.
+  Status CopyLoopCarriedVarToOutput(OrtValue& value, int output_index, bool is_subgraph_output);
+
   OpKernelContextInternal& context_;
   const SessionState& session_state_;
   const Loop::Info& info_;
@@ -232,7 +264,18 @@ class LoopImpl {
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
 
+  // double buffering of the loop carried vars. the value fed to an iteration is no longer used once it completes,
+  // so if the subgraph allocated it, its buffer is handed back to the subgraph for the output of the next iteration.
+  struct LoopCarriedBuffers {
+    OrtValue spare;                // buffer for the output of the next iteration
+    bool feed_is_owned = false;    // the current feed was allocated by the subgraph for the previous iteration
+    bool output_is_owned = false;  // the output of the current iteration was allocated by the subgraph
+  };
+
+  std::vector<LoopCarriedBuffers> loop_carried_buffers_;
+
   const Loop::ConcatOutput& concat_output_func_;
+  const bool concurrent_iterations_;
 };
 
 static Status ConcatenateCpuOutput(void* /*stream*/,
@@ -276,6 +319,9 @@ void Loop::Init(const OpKernelInfo& info) {
   ORT_IGNORE_RETURN_VALUE(proto);
 
   concat_output_func_ = ConcatenateCpuOutput;
+
+  allow_concurrent_iterations_ = info.GetConfigOptions().GetConfigOrDefault(
+                                     kOrtSessionOptionsConfigDisableConcurrentSubgraphIterations, "0") != "1";
 }
 
 std::unique_ptr<OpKernel> Loop::Create(const OpKernelInfo& info, const ConcatOutput& concat_output_func, void* /*stream*/) {
@@ -361,6 +407,19 @@ common::Status Loop::SetupSubgraphExecutionInfo(const SessionState& session_stat
 
   feeds_fetches_manager_ = std::move(ffm);
 
+  // The iterations are independent if the body passes the condition and the loop carried vars through, as only the
+  // iteration number then differs between them.
+  const auto& subgraph = info_->subgraph;
+  concurrent_iterations_ = allow_concurrent_iterations_ && node.GetExecutionProviderType() == kCpuExecutionProvider &&
+                           controlflow::detail::IsPassThroughOutput(subgraph, info_->subgraph_output_names[0],
+                                                                    info_->subgraph_input_names[1]) &&
+                           controlflow::detail::CanExecuteSubgraphConcurrently(subgraph.GetGraph());
+  for (int i = 0; concurrent_iterations_ && i < info_->num_loop_carried_vars; ++i) {
+    // +1 to skip cond in the outputs, +2 to skip iter_num and cond in the inputs
+    concurrent_iterations_ = controlflow::detail::IsPassThroughOutput(subgraph, info_->subgraph_output_names[i + 1],
+                                                                      info_->subgraph_input_names[i + 2]);
+  }
+
   return Status::OK();
 }
 
@@ -370,7 +429,7 @@ Status Loop::Compute(OpKernelContext* ctx) const {
   ORT_ENFORCE(session_state, "Subgraph SessionState was not found for 'body' attribute.");
   ORT_ENFORCE(feeds_fetches_manager_, "CreateFeedsFetchesManager must be called prior to execution of graph.");
 
-  LoopImpl loop_impl{*ctx_internal, *session_state, *info_, concat_output_func_};
+  LoopImpl loop_impl{*ctx_internal, *session_state, *info_, concat_output_func_, concurrent_iterations_};
 
   auto status = loop_impl.Initialize();
   ORT_RETURN_IF_ERROR(status);
@@ -383,12 +442,14 @@ Status Loop::Compute(OpKernelContext* ctx) const {
 LoopImpl::LoopImpl(OpKernelContextInternal& context,
                    const SessionState& session_state,
                    const Loop::Info& subgraph_info,
-                   const Loop::ConcatOutput& concat_output_func)
+                   const Loop::ConcatOutput& concat_output_func,
+                   bool concurrent_iterations)
     : context_(context),
       session_state_(session_state),
       info_(subgraph_info),
       implicit_inputs_(context_.GetImplicitInputs()),
-      concat_output_func_(concat_output_func) {
+      concat_output_func_(concat_output_func),
+      concurrent_iterations_(concurrent_iterations) {
   auto* max_trip_count_tensor = context.Input<Tensor>(0);
   max_trip_count_ = max_trip_count_tensor ? *max_trip_count_tensor->Data<int64_t>() : INT64_MAX;
 
@@ -460,6 +521,17 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
   // last_output: cond, loop vars..., loop output...
   // next_input: iter_num, cond, loop_vars. iter_num is re-used
 
+  // the loop carried vars fed to the last iteration become spare buffers
+  for (ptrdiff_t i = 0; i < info_.num_loop_carried_vars; ++i) {
+    auto& buffers = loop_carried_buffers_[i];
+    if (buffers.feed_is_owned) {
+      buffers.spare = next_inputs[i + 2];  // skip iter_num and cond
+    }
+
+    buffers.feed_is_owned = buffers.output_is_owned;
+    buffers.output_is_owned = false;
+  }
+
   // simple copy for cond and loop carried vars. start at 1 to skip iter_num in input
   for (ptrdiff_t i = 1; i < info_.num_subgraph_inputs; ++i) {
     next_inputs[i] = last_outputs[i - 1];
@@ -472,6 +544,35 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
   }
 }
 
+void LoopImpl::CreateLoopCarriedFetchAllocators(
+    std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  loop_carried_buffers_.resize(static_cast<size_t>(info_.num_loop_carried_vars));
+
+  for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+    if (!info_.reuse_loop_carried_buffers[i]) {
+      continue;
+    }
+
+    // the output is owned by the loop whether it gets the spare buffer or the execution frame allocates it.
+    auto& buffers = loop_carried_buffers_[i];
+    fetch_allocators[static_cast<size_t>(i) + 1] =  // skip cond
+        [&buffers](const TensorShape& shape, const OrtDevice& location, OrtValue& ort_value, bool& allocated) {
+          buffers.output_is_owned = true;
+
+          if (buffers.spare.IsAllocated()) {
+            const auto& spare = buffers.spare.Get<Tensor>();
+            if (spare.Shape() == shape && spare.Location().device == location) {
+              ort_value = buffers.spare;
+              buffers.spare = OrtValue();
+              allocated = true;
+            }
+          }
+
+          return Status::OK();
+        };
+  }
+}
+
 Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index) {
   const auto& first_output = per_iteration_output.front().Get<Tensor>();
   const auto& per_iteration_dims = first_output.Shape().GetDims();
@@ -492,13 +593,86 @@ Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_outp
   return Status::OK();
 }
 
+// As the loop carried variables may change shape across iterations there's no way to avoid a copy
+// as we need the final shape.
+Status LoopImpl::CopyLoopCarriedVarToOutput(OrtValue& value, int output_index, bool is_subgraph_output) {
+#if !defined(DISABLE_OPTIONAL_TYPE)
+  const TypeProto& tp = *info_.loop_carried_vars_types[output_index];
+  // Only Optional type can be None (i.e.) not have data
+  if (tp.has_optional_type() && !value.IsAllocated()) {
+    // We can't rely on the input OrtValue containing type information
+    // as it could be a main graph input which will be missing the type
+    // in the corresponding OrtValue for the "None" case because
+    // the user doesn't provide any input for the "None" case.
+    ORT_RETURN_IF_ERROR(utils::OutputOptionalWithoutDataHelper(tp,
+                                                               static_cast<OpKernelContext*>(&context_),
+                                                               output_index));
+  } else if (value.IsTensor()) {
+#else
+  if (value.IsTensor()) {
+#endif
+    const auto& input_tensor = value.Get<Tensor>();
+    Tensor* output = context_.Output(output_index, input_tensor.Shape());
+    // Safely use the IDataTransfer abstraction as we only allow using
+    // Loop on CUDA if the copy stream is the same as the compute stream.
+    // So there is no explicit sync required between the compute and copy streams
+    // to avoid data races.
+    auto* data_transer = session_state_.GetDataTransferMgr().GetDataTransfer(input_tensor.Location().device, output->Location().device);
+    if (context_.GetComputeStream())
+      ORT_RETURN_IF_ERROR(data_transer->CopyTensorAsync(input_tensor, *output, *context_.GetComputeStream()));
+    else
+      ORT_RETURN_IF_ERROR(data_transer->CopyTensor(input_tensor, *output));
+  } else if (value.IsTensorSequence()) {
+    TensorSeq* output = context_.Output<TensorSeq>(output_index);
+
+    if (is_subgraph_output) {
+      // We can move the subgraph outputs directly into the Loop's outputs.
+      *output = std::move(*value.GetMutable<TensorSeq>());
+    } else {
+      // We can't move the Loop's inputs directly into the Loop's outputs
+      // as operator inputs are read-only. Hence, we need to make a copy.
+      auto& data = value.Get<TensorSeq>();
+      output->SetType(data.DataType());
+      output->Reserve(data.Size());
+
+      AllocatorPtr alloc;
+      ORT_RETURN_IF_ERROR(context_.GetTempSpaceAllocator(&alloc));
+      for (auto it = data.begin(), end = data.end(); it != end; ++it) {
+        Tensor tmp(it->Get<Tensor>().DataType(), it->Get<Tensor>().Shape(), alloc);
+        // Safely use the IDataTransfer abstraction as we only allow using
+        // Loop on CUDA if the copy stream is the same as the compute stream.
+        // So there is no explicit sync required between the compute and copy streams
+        // to avoid data races.
+        auto* data_transer = session_state_.GetDataTransferMgr().GetDataTransfer(it->Get<Tensor>().Location().device, tmp.Location().device);
+        if (context_.GetComputeStream())
+          ORT_RETURN_IF_ERROR(data_transer->CopyTensorAsync(it->Get<Tensor>(), tmp, *context_.GetComputeStream()));
+        else
+          ORT_RETURN_IF_ERROR(data_transer->CopyTensor(it->Get<Tensor>(), tmp));
+
+        output->Add(std::move(tmp));
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
 Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
+  // the trip count is known if the condition stays true. the device streams of the Loop are not shared.
+  if (concurrent_iterations_ && context_.Input<Tensor>(0) != nullptr && condition_ && max_trip_count_ > 1 &&
+      context_.GetComputeStream() == nullptr) {
+    return ExecuteConcurrently(ffm);
+  }
+
   auto status = Status::OK();
 
   std::vector<OrtValue> feeds;
   std::vector<OrtValue> fetches;
 
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+
   CreateInitialFeeds(feeds);
+  CreateLoopCarriedFetchAllocators(fetch_allocators);
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
@@ -508,7 +682,7 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       fetches.clear();
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
                                     ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger(),
                                     context_.GetComputeStream(),
                                     // because the fetch[0] is the loop condition which we need to access on CPU,
@@ -521,76 +695,11 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
     ++iter_num_value;
   }
 
-  // As the loop carried variables may change shape across iterations there's no way to avoid a copy
-  // as we need the final shape.
-  auto copy_mlvalue_to_output = [this](OrtValue& input, int output_idx,
-                                       int64_t iter_num_value, const TypeProto& tp) {
-#if !defined(DISABLE_OPTIONAL_TYPE)
-    // Only Optional type can be None (i.e.) not have data
-    if (tp.has_optional_type() && !input.IsAllocated()) {
-      // We can't rely on the input OrtValue containing type information
-      // as it could be a main graph input which will be missing the type
-      // in the corresponding OrtValue for the "None" case because
-      // the user doesn't provide any input for the "None" case.
-      ORT_RETURN_IF_ERROR(utils::OutputOptionalWithoutDataHelper(tp,
-                                                                 static_cast<OpKernelContext*>(&context_),
-                                                                 output_idx));
-    } else if (input.IsTensor()) {
-#else
-    ORT_UNUSED_PARAMETER(tp);
-    if (input.IsTensor()) {
-#endif
-      const auto& input_tensor = input.Get<Tensor>();
-      Tensor* output = context_.Output(output_idx, input_tensor.Shape());
-      // Safely use the IDataTransfer abstraction as we only allow using
-      // Loop on CUDA if the copy stream is the same as the compute stream.
-      // So there is no explicit sync required between the compute and copy streams
-      // to avoid data races.
-      auto* data_transer = session_state_.GetDataTransferMgr().GetDataTransfer(input_tensor.Location().device, output->Location().device);
-      if (context_.GetComputeStream())
-        ORT_RETURN_IF_ERROR(data_transer->CopyTensorAsync(input_tensor, *output, *context_.GetComputeStream()));
-      else
-        ORT_RETURN_IF_ERROR(data_transer->CopyTensor(input_tensor, *output));
-    } else if (input.IsTensorSequence()) {
-      TensorSeq* output = context_.Output<TensorSeq>(output_idx);
-
-      if (iter_num_value != 0) {
-        // We can move the subgraph outputs directly into the Loop's outputs.
-        *output = std::move(*input.GetMutable<TensorSeq>());
-      } else {
-        // We can't move the Loop's inputs directly into the Loop's outputs
-        // as operator inputs are read-only. Hence, we need to make a copy.
-        auto& data = input.Get<TensorSeq>();
-        output->SetType(data.DataType());
-        output->Reserve(data.Size());
-
-        AllocatorPtr alloc;
-        ORT_RETURN_IF_ERROR(context_.GetTempSpaceAllocator(&alloc));
-        for (auto it = data.begin(), end = data.end(); it != end; ++it) {
-          Tensor tmp(it->Get<Tensor>().DataType(), it->Get<Tensor>().Shape(), alloc);
-          // Safely use the IDataTransfer abstraction as we only allow using
-          // Loop on CUDA if the copy stream is the same as the compute stream.
-          // So there is no explicit sync required between the compute and copy streams
-          // to avoid data races.
-          auto* data_transer = session_state_.GetDataTransferMgr().GetDataTransfer(it->Get<Tensor>().Location().device, tmp.Location().device);
-          if (context_.GetComputeStream())
-            ORT_RETURN_IF_ERROR(data_transer->CopyTensorAsync(it->Get<Tensor>(), tmp, *context_.GetComputeStream()));
-          else
-            ORT_RETURN_IF_ERROR(data_transer->CopyTensor(it->Get<Tensor>(), tmp));
-
-          output->Add(std::move(tmp));
-        }
-      }
-    }
-
-    return Status::OK();
-  };
-
   // copy to Loop output
   if (iter_num_value != 0) {
     for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
       // need to allocate Loop output and copy OrtValue from fetches
-      ORT_RETURN_IF_ERROR(copy_mlvalue_to_output(fetches[static_cast<ptrdiff_t>(i) + 1], i, iter_num_value, *info_.loop_carried_vars_types[static_cast<ptrdiff_t>(i)]));  // skip cond
+      ORT_RETURN_IF_ERROR(CopyLoopCarriedVarToOutput(fetches[static_cast<ptrdiff_t>(i) + 1], i, true));  // skip cond
     }
 
     for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
@@ -604,7 +713,7 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
     // no iterations.
     // copy input loop carried vars to output.
     for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
-      ORT_RETURN_IF_ERROR(copy_mlvalue_to_output(feeds[static_cast<ptrdiff_t>(i) + 2], i, iter_num_value, *info_.loop_carried_vars_types[i]));  // skip iter# and cond
+      ORT_RETURN_IF_ERROR(CopyLoopCarriedVarToOutput(feeds[static_cast<ptrdiff_t>(i) + 2], i, false));  // skip iter# and cond
     }
 
     // create empty outputs for loop outputs using the subgraph output shapes for the rank
@@ -639,4 +748,112 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
   }
   return status;
 }
+
+Status LoopImpl::ExecuteConcurrently(const FeedsFetchesManager& ffm) {
+  std::vector<OrtValue> feeds;
+  std::vector<OrtValue> first_fetches;
+
+  CreateInitialFeeds(feeds);
+
+  // the first iteration tells us the shapes of the loop outputs
+  ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(session_state_, ffm, feeds, first_fetches, {},
+                                             ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(),
+                                             context_.Logger(), nullptr));
+
+  const auto& data_transfer_mgr = session_state_.GetDataTransferMgr();
+  const int num_loop_outputs = info_.num_outputs - info_.num_loop_carried_vars;
+  std::vector<Tensor*> loop_outputs;
+  loop_outputs.reserve(static_cast<size_t>(num_loop_outputs));
+
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    const auto& first_output = first_fetches[static_cast<ptrdiff_t>(i) + 1];  // skip cond
+    ORT_RETURN_IF_NOT(first_output.IsTensor(), "All scan outputs MUST be tensors");
+    const auto& first_tensor = first_output.Get<Tensor>();
+    const auto& per_iteration_dims = first_tensor.Shape().GetDims();
+
+    TensorShapeVector dims;
+    dims.reserve(1 + per_iteration_dims.size());
+    dims.push_back(max_trip_count_);  // first dimension is number of iterations
+    dims.insert(dims.end(), per_iteration_dims.begin(), per_iteration_dims.end());
+
+    Tensor* output = context_.Output(i, TensorShape(dims));
+
+    OrtValue first_slice;
+    Tensor::InitOrtValue(first_tensor.DataType(), first_tensor.Shape(), output->MutableDataRaw(),
+                         output->Location(), first_slice);
+    ORT_RETURN_IF_ERROR(data_transfer_mgr.CopyTensor(first_tensor, *first_slice.GetMutable<Tensor>()));
+
+    loop_outputs.push_back(output);
+  }
+
+  // iter_num is the only feed that differs between the iterations, so each one gets its own copy of it.
+  // the loop outputs of an iteration are written directly to its slice of the Loop outputs.
+  auto cpu_allocator = session_state_.GetAllocator(session_state_.GetExecutionProviders()
+                                                       .Get(onnxruntime::kCpuExecutionProvider)
+                                                       ->GetOrtDeviceByMemType(OrtMemTypeDefault));
+  const bool iter_num_is_1d = iter_num_mlvalue_.Get<Tensor>().Shape().NumDimensions() != 0;
+  const std::ptrdiff_t num_iterations = gsl::narrow<std::ptrdiff_t>(max_trip_count_ - 1);
+  std::vector<Status> statuses(static_cast<size_t>(num_iterations));
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      controlflow::detail::GetIterationThreadPool(session_state_), num_iterations,
+      [&](std::ptrdiff_t idx) {
+        const int64_t iter_num = static_cast<int64_t>(idx) + 1;  // the first iteration has already run
+
+        std::vector<OrtValue> iteration_feeds(feeds);
+        iteration_feeds[0] = MakeScalarMLValue<int64_t>(cpu_allocator, iter_num, iter_num_is_1d);
+
+        // cond and the loop carried vars are left for the subgraph to allocate
+        std::vector<OrtValue> fetches(static_cast<size_t>(info_.num_subgraph_outputs));
+        for (int j = 0; j < num_loop_outputs; ++j) {
+          Tensor& output = *loop_outputs[j];
+          const size_t bytes_per_iteration = output.SizeInBytes() / static_cast<size_t>(max_trip_count_);
+          const size_t offset = static_cast<size_t>(iter_num) * bytes_per_iteration;
+          Tensor::InitOrtValue(output.DataType(), output.Shape().Slice(1),
+                               static_cast<uint8_t*>(output.MutableDataRaw()) + offset, output.Location(),
+                               fetches[static_cast<size_t>(info_.num_loop_carried_vars) + 1 + j]);
+        }
+
+        auto& status = statuses[static_cast<size_t>(idx)];
+        status = utils::ExecuteSubgraph(session_state_, ffm, iteration_feeds, fetches, {},
+                                        ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(),
+                                        context_.Logger(), nullptr);
+
+        // a loop output that is a feed of the subgraph, e.g. iter_num or an outer scope value, replaces its slice
+        for (int j = 0; status.IsOK() && j < num_loop_outputs; ++j) {
+          Tensor& output = *loop_outputs[j];
+          const size_t bytes_per_iteration = output.SizeInBytes() / static_cast<size_t>(max_trip_count_);
+          const size_t offset = static_cast<size_t>(iter_num) * bytes_per_iteration;
+          void* slice = static_cast<uint8_t*>(output.MutableDataRaw()) + offset;
+          const auto& fetch = fetches[static_cast<size_t>(info_.num_loop_carried_vars) + 1 + j].Get<Tensor>();
+          if (fetch.DataRaw() == slice) {
+            continue;
+          }
+
+          if (fetch.Shape() != output.Shape().Slice(1)) {
+            status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Inconsistent shape in loop output for output. ",
+                                     " Expected:", output.Shape().Slice(1), " Got:", fetch.Shape());
+            break;
+          }
+
+          OrtValue slice_value;
+          Tensor::InitOrtValue(output.DataType(), output.Shape().Slice(1), slice, output.Location(), slice_value);
+          status = data_transfer_mgr.CopyTensor(fetch, *slice_value.GetMutable<Tensor>());
+        }
+      });
+
+  // report the error of the earliest failing iteration, as the sequential execution would
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  // the loop carried vars are passed through so the Loop outputs are the Loop inputs
+  for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+    // skip iter# and cond
+    ORT_RETURN_IF_ERROR(CopyLoopCarriedVarToOutput(feeds[static_cast<ptrdiff_t>(i) + 2], i, false));
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -38,6 +38,9 @@ class Loop : public controlflow::IControlFlowKernel {
     std::vector<std::string> subgraph_output_names;
 
     std::vector<const ONNX_NAMESPACE::TypeProto*> loop_carried_vars_types;
+
+    // whether the buffer of each loop carried var can be re-used for its output in a later iteration
+    std::vector<bool> reuse_loop_carried_buffers;
   };
 
   // function to concatenate the OrtValue instances from each Loop iteration into a single output buffer.
@@ -57,5 +60,10 @@ class Loop : public controlflow::IControlFlowKernel {
   std::unique_ptr<Info> info_;
   std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
   ConcatOutput concat_output_func_;
+
+  // false if disabled by the session options
+  bool allow_concurrent_iterations_ = true;
+  // set by SetupSubgraphExecutionInfo if no value flows from one iteration of the body to the next
+  bool concurrent_iterations_ = false;
 };
 }  // namespace onnxruntime
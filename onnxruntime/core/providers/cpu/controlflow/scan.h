@@ -99,5 +99,10 @@ class Scan : public controlflow::IControlFlowKernel {
   std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
 
   scan::detail::DeviceHelpers device_helpers_;
+
+  // Scan 9 only. false if disabled by the session options
+  bool allow_concurrent_iterations_ = true;
+  // set by SetupSubgraphExecutionInfo if the body passes the loop state variables through unchanged
+  bool concurrent_iterations_ = false;
 };
 }  // namespace onnxruntime
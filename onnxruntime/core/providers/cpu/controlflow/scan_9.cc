@@ -20,6 +20,7 @@
 #include "core/providers/common.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/providers/cpu/tensor/transpose.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 #include <gsl/gsl>
 
@@ -106,7 +107,8 @@ class ScanImpl {
            const gsl::span<const int64_t>& output_directions,
            const gsl::span<const int64_t>& input_axes,
            const gsl::span<const int64_t>& output_axes,
-           const scan::detail::DeviceHelpers& device_helpers);
+           const scan::detail::DeviceHelpers& device_helpers,
+           bool concurrent_iterations);
 
   // Initialize by validating all the inputs, and allocating the output tensors
   Status Initialize();
@@ -126,7 +128,7 @@ class ScanImpl {
   Status SetupInputs();
 
   Status AllocateOutputTensors();
-  Status CreateLoopStateVariables(std::vector<LoopStateVariable>& loop_state_variables);
+  Status CreateLoopStateVariables(std::vector<LoopStateVariable>& loop_state_variables, int64_t sequence_len);
   Status TransposeOutput();
 
   using ConstTensorSlicerIterators = std::vector<OrtValueTensorSlicer<const OrtValue>::Iterator>;
@@ -150,6 +152,7 @@ class ScanImpl {
   const std::vector<const OrtValue*>& implicit_inputs_;
 
   const scan::detail::DeviceHelpers& device_helpers_;
+  const bool concurrent_iterations_;
 };
 
 template <>
@@ -194,6 +197,9 @@ void Scan<9>::Init(const OpKernelInfo& info) {
     memset(data, 0, size_in_bytes);
     return Status::OK();
   };
+
+  allow_concurrent_iterations_ = info.GetConfigOptions().GetConfigOrDefault(
+                                     kOrtSessionOptionsConfigDisableConcurrentSubgraphIterations, "0") != "1";
 }
 
 template <>
@@ -209,6 +215,16 @@ Status Scan<9>::SetupSubgraphExecutionInfo(const SessionState& session_state,
 
   auto status = scan::detail::CreateFeedsFetchesManager(node, *info_, session_state, subgraph_session_state,
                                                         /* is_v8 */ false, feeds_fetches_manager_);
+  ORT_RETURN_IF_ERROR(status);
+
+  // The iterations are independent if the body passes the loop state variables through, as only the scan input
+  // slices then differ between them.
+  concurrent_iterations_ = allow_concurrent_iterations_ && node.GetExecutionProviderType() == kCpuExecutionProvider &&
+                           controlflow::detail::CanExecuteSubgraphConcurrently(info_->subgraph.GetGraph());
+  for (int i = 0; concurrent_iterations_ && i < info_->num_loop_state_variables; ++i) {
+    concurrent_iterations_ = controlflow::detail::IsPassThroughOutput(info_->subgraph, info_->subgraph_output_names[i],
+                                                                      info_->subgraph_input_names[i]);
+  }
 
   return status;
 }
@@ -223,7 +239,7 @@ Status Scan<9>::Compute(OpKernelContext* ctx) const {
   ORT_ENFORCE(session_state, "Subgraph SessionState was not found for 'body' attribute.");
 
   ScanImpl scan_impl{*ctx_internal, *session_state, *info_, input_directions_, output_directions_,
-                     input_axes_, output_axes_, device_helpers_};
+                     input_axes_, output_axes_, device_helpers_, concurrent_iterations_};
 
   auto status = scan_impl.Initialize();
   ORT_RETURN_IF_ERROR(status);
@@ -240,7 +256,8 @@ ScanImpl::ScanImpl(OpKernelContextInternal& context,
                    const gsl::span<const int64_t>& output_directions,
                    const gsl::span<const int64_t>& input_axes,
                    const gsl::span<const int64_t>& output_axes,
-                   const scan::detail::DeviceHelpers& device_helpers)
+                   const scan::detail::DeviceHelpers& device_helpers,
+                   bool concurrent_iterations)
     : context_(context),
       session_state_(session_state),
       info_(info),
@@ -249,7 +266,8 @@ ScanImpl::ScanImpl(OpKernelContextInternal& context,
       input_axes_from_attribute_(input_axes),
       output_axes_from_attribute_(output_axes),
       implicit_inputs_(context_.GetImplicitInputs()),
-      device_helpers_(device_helpers) {
+      device_helpers_(device_helpers),
+      concurrent_iterations_(concurrent_iterations) {
   inputs_.reserve(info_.num_scan_inputs);
   input_axes_.reserve(info_.num_scan_inputs);
 }
@@ -406,7 +424,8 @@ Status ScanImpl::AllocateOutputTensors() {
   return Status::OK();
 }
 
-Status ScanImpl::CreateLoopStateVariables(std::vector<LoopStateVariable>& loop_state_variables) {
+Status ScanImpl::CreateLoopStateVariables(std::vector<LoopStateVariable>& loop_state_variables,
+                                          int64_t sequence_len) {
   AllocatorPtr alloc;
   auto status = context_.GetTempSpaceAllocator(&alloc);
   ORT_RETURN_IF_ERROR(status);
@@ -418,7 +437,7 @@ Status ScanImpl::CreateLoopStateVariables(std::vector<LoopStateVariable>& loop_s
     OrtValue* output_mlvalue = context_.GetOutputMLValue(i);
     ORT_ENFORCE(output_mlvalue, "Output OrtValue has not been created for loop state variable output ", i);
 
-    loop_state_variables.push_back(LoopStateVariable(input_mlvalue, *output_mlvalue, sequence_len_, alloc));
+    loop_state_variables.push_back(LoopStateVariable(input_mlvalue, *output_mlvalue, sequence_len, alloc));
   }
 
   return status;
@@ -427,8 +446,13 @@ Status ScanImpl::CreateLoopStateVariables(std::vector<LoopStateVariable>& loop_s
 Status ScanImpl::Execute(const FeedsFetchesManager& ffm) {
   Status status = Status::OK();
 
+  // if the iterations are independent the first one is run on its own to discover the shapes of the outputs,
+  // and writes the loop state variables straight to the final outputs as they are passed through unchanged.
+  const bool concurrent = concurrent_iterations_ && sequence_len_ > 1 && context_.GetComputeStream() == nullptr;
+  const int64_t sequential_len = concurrent ? 1 : sequence_len_;
+
   std::vector<LoopStateVariable> loop_state_variables;
-  status = CreateLoopStateVariables(loop_state_variables);
+  status = CreateLoopStateVariables(loop_state_variables, sequential_len);
   ORT_RETURN_IF_ERROR(status);
 
   // Setup input OrtValue streams
@@ -449,11 +473,18 @@ Status ScanImpl::Execute(const FeedsFetchesManager& ffm) {
 
   // Call the subgraph for each item in the sequence
   status = IterateSequence(context_, session_state_, loop_state_variables, scan_input_stream_iterators,
-                           sequence_len_, info_.num_loop_state_variables, info_.num_inputs, info_.num_outputs,
+                           sequential_len, info_.num_loop_state_variables, info_.num_inputs, info_.num_outputs,
                            implicit_inputs_, output_iterators_, ffm);
 
   ORT_RETURN_IF_ERROR(status);
 
+  if (concurrent) {
+    status = IterateSequenceConcurrently(context_, session_state_, scan_input_stream_iterators, sequence_len_ - 1,
+                                         info_.num_loop_state_variables, info_.num_inputs, info_.num_outputs,
+                                         implicit_inputs_, output_iterators_, ffm);
+    ORT_RETURN_IF_ERROR(status);
+  }
+
   status = TransposeOutput();
 
   return status;
@@ -17,6 +17,7 @@
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/framework/session_options.h"
 
@@ -293,6 +294,90 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
   return status;
 }
 
+Status IterateSequenceConcurrently(
+    OpKernelContextInternal& context, const SessionState& session_state,
+    std::vector<OrtValueTensorSlicer<const OrtValue>::Iterator>& scan_input_stream_iterators,
+    int64_t seq_length, int num_loop_state_variables, int num_variadic_inputs,
+    int num_variadic_outputs, const std::vector<const OrtValue*>& implicit_inputs,
+    std::vector<std::unique_ptr<OutputIterator>>& output_iterators,
+    const FeedsFetchesManager& ffm) {
+  const auto num_iterations = onnxruntime::narrow<size_t>(seq_length);
+
+  // slice the inputs and outputs of all the iterations up front as the iterators can only be moved sequentially
+  std::vector<std::vector<OrtValue>> iteration_feeds(num_iterations);
+  std::vector<std::vector<OrtValue>> iteration_fetches(num_iterations);
+
+  for (size_t seq_no = 0; seq_no < num_iterations; ++seq_no) {
+    auto& feeds = iteration_feeds[seq_no];
+    feeds.reserve(num_variadic_inputs + implicit_inputs.size());
+
+    for (int input = 0; input < num_variadic_inputs; ++input) {
+      if (input < num_loop_state_variables) {
+        // the loop state variables never change so every iteration gets the initial value
+        feeds.push_back(*context.GetInputMLValue(input));
+      } else {
+        auto& iterator = scan_input_stream_iterators[static_cast<ptrdiff_t>(input) - num_loop_state_variables];
+        feeds.push_back(*iterator);
+
+        ++iterator;
+      }
+    }
+
+    for (const auto* implicit_input : implicit_inputs) {
+      feeds.push_back(*implicit_input);
+    }
+
+    // the loop state variable outputs are left empty for the subgraph to allocate, and are discarded
+    auto& fetches = iteration_fetches[seq_no];
+    fetches.resize(num_variadic_outputs);
+
+    for (int output = num_loop_state_variables; output < num_variadic_outputs; ++output) {
+      auto& iterator = *output_iterators[output];
+      ORT_RETURN_IF_NOT(iterator.FinalOutputAllocated(), "Scan output ", output, " has not been allocated.");
+      fetches[output] = *iterator;
+
+      ++iterator;
+    }
+  }
+
+  std::vector<Status> statuses(num_iterations);
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      controlflow::detail::GetIterationThreadPool(session_state), static_cast<std::ptrdiff_t>(num_iterations),
+      [&](std::ptrdiff_t seq_no) {
+        auto& fetches = iteration_fetches[seq_no];
+        std::vector<OrtValue> output_slices(fetches);
+        auto& status = statuses[seq_no];
+        status = utils::ExecuteSubgraph(session_state, ffm, iteration_feeds[seq_no], fetches, {},
+                                        ExecutionMode::ORT_SEQUENTIAL, context.GetTerminateFlag(), context.Logger(),
+                                        nullptr);
+
+        // a scan output that is a feed of the subgraph, e.g. a scan input slice or an outer scope value, replaces
+        // its slice of the Scan output
+        for (int output = num_loop_state_variables; status.IsOK() && output < num_variadic_outputs; ++output) {
+          const auto& fetch = fetches[output].Get<Tensor>();
+          Tensor& slice = *output_slices[output].GetMutable<Tensor>();
+          if (fetch.DataRaw() == slice.DataRaw()) {
+            continue;
+          }
+
+          if (fetch.Shape() != slice.Shape()) {
+            status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Inconsistent shape in scan output ", output,
+                                     ". Expected:", slice.Shape(), " Got:", fetch.Shape());
+            break;
+          }
+
+          status = session_state.GetDataTransferMgr().CopyTensor(fetch, slice);
+        }
+      });
+
+  // report the error of the earliest failing iteration, as the sequential execution would
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  return Status::OK();
+}
+
 OrtValue AllocateTensorInMLValue(const MLDataType data_type, const TensorShape& shape, AllocatorPtr& allocator) {
   OrtValue ort_value;
   Tensor::InitOrtValue(data_type, shape, allocator, ort_value);
@@ -187,6 +187,19 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
                        std::vector<std::unique_ptr<OutputIterator>>& output_iterators,
                        const FeedsFetchesManager& ffm);
 
+/**
+Execute the next seq_length iterations of a subgraph that passes the loop state variables through unchanged, so no
+value flows from one iteration to the next. The iterations run concurrently and write directly to their slices of
+the Scan outputs, so the output iterators must have allocated the final outputs.
+*/
+Status IterateSequenceConcurrently(
+    OpKernelContextInternal& context, const SessionState& session_state,
+    std::vector<OrtValueTensorSlicer<const OrtValue>::Iterator>& scan_input_stream_iterators,
+    int64_t seq_length, int num_loop_state_variables, int num_variadic_inputs,
+    int num_variadic_outputs, const std::vector<const OrtValue*>& implicit_inputs,
+    std::vector<std::unique_ptr<OutputIterator>>& output_iterators,
+    const FeedsFetchesManager& ffm);
+
 OrtValue AllocateTensorInMLValue(MLDataType data_type, const TensorShape& shape, AllocatorPtr& allocator);
 
 /**
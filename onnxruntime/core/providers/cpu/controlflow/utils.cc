@@ -3,8 +3,10 @@
 
 #include "core/providers/cpu/controlflow/utils.h"
 
+#include <string_view>
 #include <vector>
 #include "core/common/common.h"
+#include "core/common/inlined_containers.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/session_state.h"
 #include "core/framework/utils.h"
@@ -28,6 +30,60 @@ common::Status FindDevicesForValues(const SessionState& session_state,
   return Status::OK();
 }
 
+bool CanExecuteSubgraphConcurrently(const Graph& subgraph) {
+  // the values drawn depend on the order of the executions
+  static const InlinedHashSet<std::string_view> onnx_random_ops = {"Bernoulli", "Dropout", "Multinomial",
+                                                                   "RandomNormal", "RandomNormalLike",
+                                                                   "RandomUniform", "RandomUniformLike"};
+  static const InlinedHashSet<std::string_view> ms_random_ops = {"BiasDropout", "BitmaskBiasDropout",
+                                                                 "BitmaskDropout", "Sampling"};
+
+  for (const auto& node : subgraph.Nodes()) {
+    if (node.GetExecutionProviderType() != kCpuExecutionProvider) {
+      return false;
+    }
+
+    const auto& domain = node.Domain();
+    // the layout transformations put ONNX ops in the NHWC and NCHWc domains
+    if (domain == kOnnxDomain || domain == kMLDomain || domain == kMSInternalNHWCDomain || domain == kMSNchwcDomain) {
+      if (onnx_random_ops.count(node.OpType()) != 0) {
+        return false;
+      }
+    } else if (domain == kMSDomain) {
+      if (ms_random_ops.count(node.OpType()) != 0) {
+        return false;
+      }
+    } else {
+      // custom ops may draw random numbers or keep a state between their calls
+      return false;
+    }
+
+    for (const auto& nested_subgraph : node.GetSubgraphs()) {
+      if (!CanExecuteSubgraphConcurrently(*nested_subgraph)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool IsPassThroughOutput(const GraphViewer& subgraph, const std::string& output_name, const std::string& input_name) {
+  const std::string* name = &output_name;
+  const Node* producer = subgraph.GetProducerNode(*name);
+  while (producer != nullptr && producer->OpType() == "Identity" && producer->Domain() == kOnnxDomain) {
+    name = &producer->InputDefs()[0]->Name();
+    producer = subgraph.GetProducerNode(*name);
+  }
+
+  return *name == input_name;
+}
+
+concurrency::ThreadPool* GetIterationThreadPool(const SessionState& session_state) {
+  auto* thread_pool = session_state.GetInterOpThreadPool();
+  return thread_pool != nullptr ? thread_pool : session_state.GetThreadPool();
+}
+
 }  // namespace detail
 }  // namespace controlflow
 }  // namespace onnxruntime
@@ -58,6 +58,20 @@ common::Status FindDevicesForValues(const SessionState& session_state,
                                     std::vector<OrtDevice>& devices,
                                     size_t start_at = 0);
 
+#ifndef SHARED_PROVIDER
+// Returns true if concurrent executions of the subgraph give the results of sequential ones: all its nodes, including
+// those of nested subgraphs, run on the CPU execution provider, are ONNX or Microsoft ops, and none of them draws
+// random numbers.
+bool CanExecuteSubgraphConcurrently(const Graph& subgraph);
+
+// Returns true if the subgraph output is the subgraph input, directly or through Identity nodes.
+bool IsPassThroughOutput(const GraphViewer& subgraph, const std::string& output_name, const std::string& input_name);
+
+// Thread pool the independent iterations of a subgraph run on: the inter-op one, or the intra-op one in sequential
+// execution mode.
+concurrency::ThreadPool* GetIterationThreadPool(const SessionState& session_state);
+#endif
+
 }  // namespace detail
 }  // namespace controlflow
 }  // namespace onnxruntime
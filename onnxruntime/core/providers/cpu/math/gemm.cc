@@ -284,6 +284,41 @@ Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+template <typename T>
+bool Gemm<T>::IsPrePackCacheable(int /*input_idx*/) const {
+  return false;
+}
+
+template <>
+bool Gemm<float>::IsPrePackCacheable(int input_idx) const {
+  return input_idx == 1;
+}
+
+template <typename T>
+Status Gemm<T>::UseCachedPrePackedBuffers(const Tensor& /*tensor*/,
+                                          std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                          int /*input_idx*/,
+                                          /*out*/ bool& used_cached_buffers) {
+  used_cached_buffers = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::UseCachedPrePackedBuffers(const Tensor& tensor,
+                                              std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              int input_idx,
+                                              /*out*/ bool& used_cached_buffers) {
+  used_cached_buffers = false;
+
+  if (input_idx == 1) {
+    used_cached_buffers = true;
+    // PrePack() only packs 2D weights, see GemmPackBFp32()
+    b_shape_ = tensor.Shape();
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+  return Status::OK();
+}
+
 template <typename T>
 void Gemm<T>::ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const {
   if (activation_) {
@@ -386,16 +421,24 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   const auto* B = packed_b_ ? nullptr : context->Input<Tensor>(1);
   const auto* C = context->Input<Tensor>(2);
 
-  // Bias could be missing. Treat as scalar 0 if that is the case.
-  GemmHelper helper(A->Shape(), trans_A_ != CblasNoTrans, B ? B->Shape() : b_shape_, trans_B_ != CblasNoTrans,
-                    C != nullptr ? C->Shape() : TensorShape({}));
-
-  if (!helper.State().IsOK())
-    return helper.State();
-
-  ptrdiff_t M = helper.M();
-  ptrdiff_t N = helper.N();
-  ptrdiff_t K = helper.K();
+  const TensorShape& b_shape = B ? B->Shape() : b_shape_;
+  std::shared_ptr<const GemmPlan> plan;
+  ORT_RETURN_IF_ERROR(plan_cache_.GetOrCreate(
+      ShapePlanKey().AddShape(&A->Shape()).AddShape(&b_shape).AddShape(C != nullptr ? &C->Shape() : nullptr),
+      [&](GemmPlan& new_plan) {
+        // Bias could be missing. Treat as scalar 0 if that is the case.
+        GemmHelper helper(A->Shape(), trans_A_ != CblasNoTrans, b_shape, trans_B_ != CblasNoTrans,
+                          C != nullptr ? C->Shape() : TensorShape({}));
+        new_plan.M = helper.M();
+        new_plan.N = helper.N();
+        new_plan.K = helper.K();
+        return helper.State();
+      },
+      plan));
+
+  ptrdiff_t M = plan->M;
+  ptrdiff_t N = plan->N;
+  ptrdiff_t K = plan->K;
 
   auto Y = context->Output(0, {M, N});
 
@@ -6,6 +6,7 @@
 #include "gemm_base.h"
 
 #include "core/framework/op_kernel.h"
+#include "core/framework/shape_plan_cache.h"
 #include "core/common/common.h"
 #include "core/util/math.h"
 #include "core/providers/cpu/activation/activations.h"
@@ -28,6 +29,13 @@ class Gemm : protected GemmBase, public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  bool IsPrePackCacheable(int input_idx) const override;
+
+  Status UseCachedPrePackedBuffers(const Tensor& tensor,
+                                   std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx,
+                                   /*out*/ bool& used_cached_buffers) override;
+
   static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
                           T alpha,
@@ -45,6 +53,15 @@ class Gemm : protected GemmBase, public OpKernel {
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
 
   void ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const;
+
+  // Dimensions validated by GemmHelper for the shapes of A, B and C. Only used by Gemm<float>.
+  struct GemmPlan {
+    ptrdiff_t M;
+    ptrdiff_t N;
+    ptrdiff_t K;
+  };
+
+  ShapePlanCache<GemmPlan> plan_cache_;
 };
 
 }  // namespace onnxruntime
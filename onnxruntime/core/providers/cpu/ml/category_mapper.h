@@ -6,6 +6,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/ml/ml_common.h"
+#include "core/providers/cpu/ml/string_lookup_table.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -26,22 +27,21 @@ class CategoryMapper final : public OpKernel {
 
     ORT_ENFORCE(num_entries == int_categories.size());
 
-    string_to_int_map_.reserve(num_entries);
+    // a repeated category maps to its last value
+    string_to_int_map_ = StringLookupTable<int64_t>(string_categories, int_categories,
+                                                    /* keep_last_duplicate */ true);
+
     int_to_string_map_.reserve(num_entries);
 
     for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_categories[i];
-      int64_t index = int_categories[i];
-
-      string_to_int_map_[str] = index;
-      int_to_string_map_[index] = str;
+      int_to_string_map_[int_categories[i]] = string_categories[i];
     }
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
+  StringLookupTable<int64_t> string_to_int_map_;
   std::unordered_map<int64_t, std::string> int_to_string_map_;
 
   std::string default_string_;
@@ -3,9 +3,11 @@
 
 #pragma once
 #include <filesystem>
+#include <numeric>
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/ml/ml_common.h"
+#include "core/providers/cpu/ml/string_lookup_table.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/common/safeint.h"
 
@@ -22,29 +24,37 @@ class LabelEncoder final : public OpKernel {
     ORT_ENFORCE(info.GetAttr<std::string>("default_string", &default_string_).IsOK());
     ORT_ENFORCE(info.GetAttr<int64_t>("default_int64", &default_int_).IsOK());
 
-    auto num_entries = string_classes.size();
+    std::vector<int64_t> indices(string_classes.size());
+    std::iota(indices.begin(), indices.end(), int64_t{0});
 
-    string_to_int_map_.reserve(num_entries);
-    int_to_string_map_.reserve(num_entries);
-
-    for (size_t i = 0; i < num_entries; ++i) {
-      const std::string& str = string_classes[i];
-
-      string_to_int_map_[str] = i;
-      int_to_string_map_[i] = str;
-    }
+    // a repeated class maps to its last index
+    string_to_int_map_ = StringLookupTable<int64_t>(string_classes, indices, /* keep_last_duplicate */ true);
+    classes_ = std::move(string_classes);
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  StringLookupTable<int64_t> string_to_int_map_;
+  // the int64 to string mapping is the index of the class
+  std::vector<std::string> classes_;
 
   std::string default_string_;
   int64_t default_int_;
 };
 
+// Returns the value of the key in a hash map or a StringLookupTable, or nullptr if the key is missing.
+template <typename Map, typename TKey>
+const typename Map::mapped_type* FindValue(const Map& map, const TKey& key) {
+  const auto found = map.find(key);
+  return found == map.end() ? nullptr : &found->second;
+}
+
+template <typename TValue>
+const TValue* FindValue(const StringLookupTable<TValue>& map, const std::string& key) {
+  return map.Find(key);
+}
+
 template <typename TKey, typename TValue>
 class LabelEncoder_2 final : public OpKernel {
  public:
@@ -63,8 +73,12 @@ class LabelEncoder_2 final : public OpKernel {
     ORT_ENFORCE(num_keys == num_values, "The ", key_field_name_, " and ", value_field_name_,
                 " attributes in LabelEncoder ", "(name: ", info.node().Name(), ") must have the same length. ",
                 "However, the number of key is ", num_keys, " and the number of ", "values is ", num_values, ".");
-    map_.reserve(num_keys);
-    for (size_t i = 0; i < num_keys; ++i) map_.emplace(keys[i], values[i]);
+    if constexpr (std::is_same_v<TKey, std::string>) {
+      map_ = StringLookupTable<TValue>(keys, values, /* keep_last_duplicate */ false);
+    } else {
+      map_.reserve(num_keys);
+      for (size_t i = 0; i < num_keys; ++i) map_.emplace(keys[i], values[i]);
+    }
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -74,14 +88,8 @@ class LabelEncoder_2 final : public OpKernel {
 
     auto input = X->template DataAsSpan<TKey>();
     auto output = Y->template MutableDataAsSpan<TValue>();
-    auto input_iter = input.begin();
-    auto output_iter = output.begin();
-    while (input_iter != input.end()) {
-      const auto found = map_.find(*input_iter);
-      *output_iter = found == map_.end() ? default_value_ : found->second;
-      ++output_iter;
-      ++input_iter;
-    }
+    LookupValues(input, output, default_value_, [this](const TKey& key) { return FindValue(map_, key); },
+                 context->GetOperatorThreadPool());
     return Status::OK();
   }
 
@@ -94,7 +102,7 @@ class LabelEncoder_2 final : public OpKernel {
   // A collection of key-value pairs. Each (a_key, a_value) pair
   // means that the "a_key" in the input would be mapped to "a_value".
   // If map_ doesn't contain "a_key", we use default_value_ as its output.
-  InlinedHashMap<TKey, TValue> map_;
+  std::conditional_t<std::is_same_v<TKey, std::string>, StringLookupTable<TValue>, InlinedHashMap<TKey, TValue>> map_;
   TValue default_value_;
   // ONNX attribute name to load keys.
   std::string key_field_name_;
@@ -202,8 +210,12 @@ class LabelEncoder_4 final : public OpKernel {
     auto keys = GetAttribute<TKey>(kernel_info, key_field_name_, "keys_tensor");
     auto values = GetAttribute<TValue>(kernel_info, value_field_name_, "values_tensor");
     ORT_ENFORCE(keys.size() == values.size(), "Keys and values must have the same length.");
-    for (size_t i = 0; i < keys.size(); ++i) {
-      map_.emplace(keys[i], values[i]);
+    if constexpr (std::is_same_v<TKey, std::string>) {
+      map_ = StringLookupTable<TValue>(keys, values, /* keep_last_duplicate */ false);
+    } else {
+      for (size_t i = 0; i < keys.size(); ++i) {
+        map_.emplace(keys[i], values[i]);
+      }
     }
   }
   Status Compute(OpKernelContext* context) const override {
@@ -213,20 +225,16 @@ class LabelEncoder_4 final : public OpKernel {
 
     auto input = X->template DataAsSpan<TKey>();
     auto output = Y->template MutableDataAsSpan<TValue>();
-    auto input_iter = input.begin();
-    auto output_iter = output.begin();
-    while (input_iter != input.end()) {
-      const auto found = map_.find(*input_iter);
-      *output_iter = found == map_.end() ? default_value_ : found->second;
-      ++output_iter;
-      ++input_iter;
-    }
+    LookupValues(input, output, default_value_, [this](const TKey& key) { return FindValue(map_, key); },
+                 context->GetOperatorThreadPool());
     return Status::OK();
   }
 
  private:
   void InitializeAttrFields(const OpKernelInfo& kernel_info);
-  HashMap<TKey, TValue, NaNHash<TKey>, NaNEqual<TKey>> map_;
+  std::conditional_t<std::is_same_v<TKey, std::string>, StringLookupTable<TValue>,
+                     HashMap<TKey, TValue, NaNHash<TKey>, NaNEqual<TKey>>>
+      map_;
   TValue default_value_;
   std::string key_field_name_;
   std::string value_field_name_;
@@ -0,0 +1,150 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace ml {
+
+/**
+Immutable map from strings to values, built once when a kernel is created and shared by its Compute calls.
+
+The table uses open addressing with linear probing and is at most half full. Each slot stores the hash of its key,
+so a probe only compares the characters of keys whose hash matches. The characters of all the keys are stored in
+one buffer. A slot takes 16 bytes on 64-bit platforms, so a probe sequence usually stays in one cache line.
+A lookup takes a std::string_view and does not allocate.
+*/
+template <typename TValue>
+class StringLookupTable {
+ public:
+  StringLookupTable() = default;
+
+  /**
+  @param keep_last_duplicate If a key is repeated, map it to the value of its last occurrence instead of its first.
+  */
+  StringLookupTable(gsl::span<const std::string> keys, gsl::span<const TValue> values, bool keep_last_duplicate) {
+    ORT_ENFORCE(keys.size() == values.size(), "Keys and values must have the same length.");
+
+    size_t capacity = 2;
+    shift_ = 63;
+    while (capacity < 2 * keys.size()) {
+      capacity *= 2;
+      --shift_;
+    }
+
+    slots_.resize(capacity);
+    values_.resize(capacity);
+
+    size_t total_length = 0;
+    for (const auto& key : keys) {
+      total_length += key.size();
+    }
+
+    ORT_ENFORCE(total_length < kEmpty, "The keys of the lookup table are too long.");
+    key_data_.reserve(total_length);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const std::string& key = keys[i];
+      const size_t hash = Hash(key);
+      const size_t index = FindSlot(key, hash);
+      Slot& slot = slots_[index];
+
+      if (slot.IsEmpty()) {
+        slot.hash = hash;
+        slot.offset = narrow<uint32_t>(key_data_.size());
+        slot.length = narrow<uint32_t>(key.size());
+        key_data_.append(key);
+        values_[index] = values[i];
+      } else if (keep_last_duplicate) {
+        values_[index] = values[i];
+      }
+    }
+  }
+
+  /** Returns the value of the key, or nullptr if the table doesn't contain it. */
+  const TValue* Find(std::string_view key) const {
+    if (slots_.empty()) {
+      return nullptr;
+    }
+
+    const size_t index = FindSlot(key, Hash(key));
+    return slots_[index].IsEmpty() ? nullptr : &values_[index];
+  }
+
+ private:
+  static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+  struct Slot {
+    size_t hash = 0;
+    uint32_t offset = kEmpty;  // of the key in key_data_
+    uint32_t length = 0;
+
+    bool IsEmpty() const { return offset == kEmpty; }
+  };
+
+  static size_t Hash(std::string_view key) { return std::hash<std::string_view>{}(key); }
+
+  // Returns the slot of the key, or the empty slot that ends its probe sequence.
+  size_t FindSlot(std::string_view key, size_t hash) const {
+    // Fibonacci hashing picks the start of the sequence from the high bits, which std::hash mixes better
+    const size_t mask = slots_.size() - 1;
+    size_t index = static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> shift_) & mask;
+    for (;;) {
+      const Slot& slot = slots_[index];
+      if (slot.IsEmpty() ||
+          (slot.hash == hash && slot.length == key.size() &&
+           (key.empty() || std::memcmp(key_data_.data() + slot.offset, key.data(), key.size()) == 0))) {
+        return index;
+      }
+
+      index = (index + 1) & mask;
+    }
+  }
+
+  std::vector<Slot> slots_;
+  std::vector<TValue> values_;  // value of the key in the slot with the same index
+  std::string key_data_;
+  int shift_ = 63;
+};
+
+/**
+Writes the value lookup returns for each input to output, or default_value when it returns nullptr.
+The elements are split across the thread pool.
+*/
+template <typename TKey, typename TValue, typename Lookup>
+void LookupValues(gsl::span<const TKey> input, gsl::span<TValue> output, const TValue& default_value,
+                  const Lookup& lookup, concurrency::ThreadPool* thread_pool) {
+  // hashing a string and copying a string value cost more than a comparison of numbers
+  constexpr bool has_strings = std::is_same_v<TKey, std::string> || std::is_same_v<TValue, std::string>;
+  const TensorOpCost cost{static_cast<double>(sizeof(TKey)), static_cast<double>(sizeof(TValue)),
+                          has_strings ? 64.0 : 16.0};
+
+  const TKey* in = input.data();
+  TValue* out = output.data();
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(input.size()), cost,
+      [in, out, &default_value, &lookup](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const TValue* value = lookup(in[i]);
+          out[i] = value != nullptr ? *value : default_value;
+        }
+      });
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -4,14 +4,63 @@
 #pragma once
 
 #include "tree_ensemble_aggregator.h"
+#include "core/common/parse_string.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "tree_ensemble_helper.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace onnxruntime {
 namespace ml {
 namespace detail {
 
+// Flattened representation of the trees for the QuickScorer algorithm (Lucchese et al., SIGIR 2015).
+// The leaves of every tree are numbered from left to right, the true branch being on the left, and the leaves
+// still reachable by a row are tracked with a 64-bit mask per tree. Every false condition removes the leaves of
+// its true branch from the mask of its tree, and the exit leaf is the first leaf still set.
+// The conditions are grouped by feature and sorted by threshold so that the false conditions of a feature are
+// a prefix of its conditions: the trees are not walked node by node.
+template <typename ThresholdType>
+struct QuickScorerTrees {
+  bool enabled = false;
+  bool strict = false;                     // BRANCH_LT instead of BRANCH_LEQ
+  InlinedVector<size_t> feature_offsets;   // conditions of feature f are [feature_offsets[f], feature_offsets[f + 1])
+  std::vector<ThresholdType> thresholds;   // sorted by increasing threshold for every feature
+  std::vector<uint32_t> tree_ids;          // tree of the condition
+  std::vector<uint64_t> masks;             // mask removing the leaves of the true branch of the condition
+  std::vector<size_t> leaf_offsets;        // leaves of tree j start at leaves[leaf_offsets[j]]
+  std::vector<const TreeNodeElement<ThresholdType>*> leaves;  // leaves of the trees, from left to right
+};
+
+inline int QuickScorerFirstLeaf(uint64_t mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, mask);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctzll(mask);
+#endif
+}
+
+// Number of rows evaluated together against every tree when the rows are split across threads,
+// the nodes of a tree stay in cache while it is evaluated on the block of rows. QuickScorer evaluates all the
+// trees for one row at a time and ignores the order, the rows of a block only share its bitvectors.
+inline int GetParallelRowBlock(const OpKernelInfo& info) {
+  constexpr int default_row_block = 8;
+  auto value = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsTreeEnsembleRowBlockSize);
+  if (!value.has_value()) {
+    return default_row_block;
+  }
+  int row_block = default_row_block;
+  ORT_ENFORCE(TryParseStringWithClassicLocale(*value, row_block) && row_block > 0,
+              "Invalid value for ", kOrtSessionOptionsTreeEnsembleRowBlockSize, ": ", *value);
+  return row_block;
+}
+
 class TreeEnsembleCommonAttributes {
  public:
   int64_t get_target_or_class_count() const { return this->n_targets_or_classes_; }
@@ -32,6 +81,7 @@ class TreeEnsembleCommonAttributes {
   int parallel_tree_;    // starts parallelizing the computing by trees if n_tree >= parallel_tree_
   int parallel_tree_N_;  // batch size if parallelizing by trees
   int parallel_N_;       // starts parallelizing the computing by rows if n_rows <= parallel_N_
+  int parallel_row_block_;  // number of rows evaluated against one tree before the next one when parallelizing by rows
 };
 
 // TI: input type
@@ -47,6 +97,8 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   // `ThresholdType` is used as well for output type (double as well for lightgbm) and not `OutputType`.
   std::vector<SparseValue<ThresholdType>> weights_;
   std::vector<TreeNodeElement<ThresholdType>*> roots_;
+  // Used instead of walking the trees when every tree has at most 64 leaves and the nodes are BRANCH_LEQ or BRANCH_LT.
+  QuickScorerTrees<ThresholdType> quick_scorer_;
 
  public:
   TreeEnsembleCommon() {}
@@ -57,6 +109,7 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   Status Init(int parallel_tree,
               int parallel_tree_N,
               int parallel_N,
+              int parallel_row_block,
               const std::string& aggregate_function,
               const std::vector<float>& base_values,
               const std::vector<ThresholdType>& base_values_as_tensor,
@@ -83,10 +136,30 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   TreeNodeElement<ThresholdType>* ProcessTreeNodeLeave(TreeNodeElement<ThresholdType>* root,
                                                        const InputType* x_data) const;
 
+  // Calls fn with the leaf of every tree for row x_data, in the order of the trees, using quick_scorer_.
+  // bitvectors is a scratch buffer with n_trees_ elements.
+  template <typename FN>
+  void ProcessTreeNodeLeavesQuickScorer(const InputType* x_data, uint64_t* bitvectors, FN&& fn) const;
+
+  // Calls fn with the leaf of every tree for row x_data, in the order of the trees.
+  template <typename FN>
+  void ProcessTreeNodeLeaves(const InputType* x_data, InlinedVector<uint64_t>& bitvectors, FN&& fn) const {
+    if (quick_scorer_.enabled) {
+      bitvectors.resize(roots_.size());
+      ProcessTreeNodeLeavesQuickScorer(x_data, bitvectors.data(), std::forward<FN>(fn));
+    } else {
+      for (size_t j = 0, limit = roots_.size(); j < limit; ++j) {
+        fn(*ProcessTreeNodeLeave(roots_[j], x_data));
+      }
+    }
+  }
+
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label, const AGG& agg) const;
 
  private:
+  void InitQuickScorer();
+
   size_t AddNodes(const size_t i, const InlinedVector<NODE_MODE>& cmodes, const InlinedVector<size_t>& truenode_ids,
                   const InlinedVector<size_t>& falsenode_ids, const std::vector<int64_t>& nodes_featureids,
                   const std::vector<ThresholdType>& nodes_values_as_tensor, const std::vector<float>& node_values,
@@ -109,6 +182,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(const OpKe
       80,
       128,
       50,
+      GetParallelRowBlock(info),
       info.GetAttrOrDefault<std::string>("aggregate_function", "SUM"),
       info.GetAttrsOrDefault<float>("base_values"),
       base_values_as_tensor,
@@ -137,6 +211,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
     int parallel_tree,
     int parallel_tree_N,
     int parallel_N,
+    int parallel_row_block,
     const std::string& aggregate_function,
     const std::vector<float>& base_values,
     const std::vector<ThresholdType>& base_values_as_tensor,
@@ -161,6 +236,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
   parallel_tree_ = parallel_tree;
   parallel_tree_N_ = parallel_tree_N;
   parallel_N_ = parallel_N;
+  parallel_row_block_ = std::max(parallel_row_block, 1);
 
   ORT_ENFORCE(n_targets_or_classes > 0);
   ORT_ENFORCE(nodes_falsenodeids.size() == nodes_featureids.size());
@@ -338,9 +414,104 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
     }
   }
 
+  InitQuickScorer();
   return Status::OK();
 }
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::InitQuickScorer() {
+  quick_scorer_ = QuickScorerTrees<ThresholdType>();
+  if (!same_mode_ || has_missing_tracks_) {
+    return;
+  }
+  NODE_MODE mode = NODE_MODE::LEAF;
+  for (const auto& node : nodes_) {
+    if (node.is_not_leaf()) {
+      mode = node.mode();
+      break;
+    }
+  }
+  if (mode != NODE_MODE::BRANCH_LEQ && mode != NODE_MODE::BRANCH_LT && mode != NODE_MODE::LEAF) {
+    return;
+  }
+
+  struct Condition {
+    int feature_id;
+    ThresholdType threshold;
+    uint32_t tree_id;
+    uint64_t mask;
+  };
+  std::vector<Condition> conditions;
+  std::vector<const TreeNodeElement<ThresholdType>*> leaves;
+  std::vector<size_t> leaf_offsets;
+  leaf_offsets.reserve(roots_.size());
+  InlinedVector<bool> visited(nodes_.size(), false);
+  constexpr size_t kMaxLeaves = 64;
+
+  for (size_t j = 0; j < roots_.size(); ++j) {
+    const size_t first_leaf = leaves.size();
+    leaf_offsets.push_back(first_leaf);
+
+    // Walks the tree depth first, true branch first, so that the leaves are numbered from left to right.
+    // Every node must be reached once (a tree, not a graph) and the tree must have at most 64 leaves.
+    InlinedVector<std::pair<const TreeNodeElement<ThresholdType>*, size_t>> stack;  // node, parent condition + 1
+    stack.emplace_back(roots_[j], 0);
+    InlinedVector<size_t> pending;  // conditions whose true branch is being numbered, with the leaf where it starts
+    while (!stack.empty()) {
+      auto [node, parent] = stack.back();
+      stack.pop_back();
+      if (parent > 0) {
+        // the false branch starts: the true branch of the condition is [start, leaves.size())
+        Condition& condition = conditions[parent - 1];
+        const size_t start = static_cast<size_t>(condition.mask);
+        const size_t end = leaves.size() - first_leaf;
+        uint64_t true_leaves = (end - start == kMaxLeaves) ? ~uint64_t{0}
+                                                           : (((uint64_t{1} << (end - start)) - 1) << start);
+        condition.mask = ~true_leaves;
+      }
+      size_t index = static_cast<size_t>(node - nodes_.data());
+      if (visited[index]) {
+        return;
+      }
+      visited[index] = true;
+      if (!node->is_not_leaf()) {
+        if (leaves.size() - first_leaf == kMaxLeaves) {
+          return;
+        }
+        leaves.push_back(node);
+        continue;
+      }
+      // The start of the true branch is kept in the mask until the false branch is reached.
+      conditions.push_back(Condition{node->feature_id, node->value_or_unique_weight, static_cast<uint32_t>(j),
+                                     static_cast<uint64_t>(leaves.size() - first_leaf)});
+      stack.emplace_back(node + 1, conditions.size());
+      stack.emplace_back(node->truenode_or_weight.ptr, 0);
+    }
+  }
+
+  std::stable_sort(conditions.begin(), conditions.end(), [](const Condition& a, const Condition& b) {
+    return a.feature_id < b.feature_id || (a.feature_id == b.feature_id && a.threshold < b.threshold);
+  });
+
+  quick_scorer_.strict = mode == NODE_MODE::BRANCH_LT;
+  quick_scorer_.feature_offsets.assign(static_cast<size_t>(max_feature_id_) + 2, 0);
+  quick_scorer_.thresholds.reserve(conditions.size());
+  quick_scorer_.tree_ids.reserve(conditions.size());
+  quick_scorer_.masks.reserve(conditions.size());
+  for (const auto& condition : conditions) {
+    ++quick_scorer_.feature_offsets[static_cast<size_t>(condition.feature_id) + 1];
+    quick_scorer_.thresholds.push_back(condition.threshold);
+    quick_scorer_.tree_ids.push_back(condition.tree_id);
+    quick_scorer_.masks.push_back(condition.mask);
+  }
+  for (size_t f = 1; f < quick_scorer_.feature_offsets.size(); ++f) {
+    quick_scorer_.feature_offsets[f] += quick_scorer_.feature_offsets[f - 1];
+  }
+  quick_scorer_.leaf_offsets = std::move(leaf_offsets);
+  quick_scorer_.leaves = std::move(leaves);
+  quick_scorer_.enabled = true;
+}
+
 template <typename InputType, typename ThresholdType, typename OutputType>
 size_t TreeEnsembleCommon<InputType, ThresholdType, OutputType>::AddNodes(
     const size_t i, const InlinedVector<NODE_MODE>& cmodes, const InlinedVector<size_t>& truenode_ids,
@@ -459,9 +630,10 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
     if (N == 1) {
       ScoreValue<ThresholdType> score = {0, 0};
       if (n_trees_ <= parallel_tree_ || max_num_threads == 1) { /* section A: 1 output, 1 row and not enough trees to parallelize */
-        for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[onnxruntime::narrow<size_t>(j)], x_data));
-        }
+        InlinedVector<uint64_t> bitvectors;
+        ProcessTreeNodeLeaves(x_data, bitvectors, [&agg, &score](const TreeNodeElement<ThresholdType>& leaf) {
+          agg.ProcessTreeNodePrediction1(score, leaf);
+        });
       } else { /* section B: 1 output, 1 row and enough trees to parallelize */
         std::vector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_trees_), {0, 0});
         concurrency::ThreadPool::TryBatchParallelFor(
@@ -488,7 +660,9 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
       // In that case, looping first on tree or on data is almost the same. That's why the first loop
       // split into batch so that every batch holds on caches, then loop on trees and finally loop
       // on the batch rows.
+      // QuickScorer evaluates all the trees for one row at a time and does not need the batches.
       std::vector<ScoreValue<ThresholdType>> scores(parallel_tree_N_);
+      InlinedVector<uint64_t> bitvectors;
       size_t j;
       int64_t i, batch, batch_end;
 
@@ -497,9 +671,18 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
         for (i = batch; i < batch_end; ++i) {
           scores[SafeInt<ptrdiff_t>(i - batch)] = {0, 0};
         }
-        for (j = 0; j < static_cast<size_t>(n_trees_); ++j) {
+        if (quick_scorer_.enabled) {
           for (i = batch; i < batch_end; ++i) {
-            agg.ProcessTreeNodePrediction1(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+            auto& score = scores[SafeInt<ptrdiff_t>(i - batch)];
+            ProcessTreeNodeLeaves(x_data + i * stride, bitvectors, [&agg, &score](const TreeNodeElement<ThresholdType>& leaf) {
+              agg.ProcessTreeNodePrediction1(score, leaf);
+            });
+          }
+        } else {
+          for (j = 0; j < static_cast<size_t>(n_trees_); ++j) {
+            for (i = batch; i < batch_end; ++i) {
+              agg.ProcessTreeNodePrediction1(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+            }
           }
         }
         for (i = batch; i < batch_end; ++i) {
@@ -543,18 +726,35 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
                                   label_data == nullptr ? nullptr : (label_data + i));
             }
           });
-    } else { /* section E: 1 output, 2+ rows, parallelization by rows */
+    } else { /* section E: 1 output, 2+ rows, parallelization by blocks of rows */
+      const int64_t row_block = parallel_row_block_;
       concurrency::ThreadPool::TryBatchParallelFor(
           ttp,
-          SafeInt<int32_t>(N),
-          [this, &agg, x_data, z_data, stride, label_data](ptrdiff_t i) {
-            ScoreValue<ThresholdType> score = {0, 0};
-            for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-              agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+          SafeInt<int32_t>((N + row_block - 1) / row_block),
+          [this, &agg, x_data, z_data, stride, label_data, N, row_block](ptrdiff_t block) {
+            const int64_t begin = block * row_block;
+            const int64_t end = std::min(N, begin + row_block);
+            InlinedVector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(end - begin), {0, 0});
+            if (quick_scorer_.enabled) {
+              InlinedVector<uint64_t> bitvectors;
+              for (int64_t i = begin; i < end; ++i) {
+                auto& score = scores[SafeInt<ptrdiff_t>(i - begin)];
+                ProcessTreeNodeLeaves(x_data + i * stride, bitvectors, [&agg, &score](const TreeNodeElement<ThresholdType>& leaf) {
+                  agg.ProcessTreeNodePrediction1(score, leaf);
+                });
+              }
+            } else {
+              for (size_t j = 0, limit = roots_.size(); j < limit; ++j) {
+                for (int64_t i = begin; i < end; ++i) {
+                  agg.ProcessTreeNodePrediction1(scores[SafeInt<ptrdiff_t>(i - begin)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+                }
+              }
             }
 
-            agg.FinalizeScores1(z_data + i, score,
-                                label_data == nullptr ? nullptr : (label_data + i));
+            for (int64_t i = begin; i < end; ++i) {
+              agg.FinalizeScores1(z_data + i, scores[SafeInt<ptrdiff_t>(i - begin)],
+                                  label_data == nullptr ? nullptr : (label_data + i));
+            }
           },
           max_num_threads);
     }
@@ -562,9 +762,10 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
     if (N == 1) {                                               /* section A2: 2+ outputs, 1 row, not enough trees to parallelize */
       if (n_trees_ <= parallel_tree_ || max_num_threads == 1) { /* section A2 */
         InlinedVector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
-        for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[onnxruntime::narrow<size_t>(j)], x_data), weights_);
-        }
+        InlinedVector<uint64_t> bitvectors;
+        ProcessTreeNodeLeaves(x_data, bitvectors, [this, &agg, &scores](const TreeNodeElement<ThresholdType>& leaf) {
+          agg.ProcessTreeNodePrediction(scores, leaf, weights_);
+        });
         agg.FinalizeScores(scores, z_data, -1, label_data);
       } else { /* section B2: 2+ outputs, 1 row, enough trees to parallelize */
         auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(n_trees_));
@@ -586,6 +787,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
       }
     } else if (N <= parallel_N_ || max_num_threads == 1) { /* section C2: 2+ outputs, 2+ rows, not enough rows to parallelize */
       std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(parallel_tree_N_);
+      InlinedVector<uint64_t> bitvectors;
       size_t j, limit;
       int64_t i, batch, batch_end;
       batch_end = std::min(N, static_cast<int64_t>(parallel_tree_N_));
@@ -597,9 +799,18 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
         for (i = batch; i < batch_end; ++i) {
           std::fill(scores[SafeInt<ptrdiff_t>(i - batch)].begin(), scores[SafeInt<ptrdiff_t>(i - batch)].end(), ScoreValue<ThresholdType>({0, 0}));
         }
-        for (j = 0, limit = roots_.size(); j < limit; ++j) {
+        if (quick_scorer_.enabled) {
           for (i = batch; i < batch_end; ++i) {
-            agg.ProcessTreeNodePrediction(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
+            auto& row_scores = scores[SafeInt<ptrdiff_t>(i - batch)];
+            ProcessTreeNodeLeaves(x_data + i * stride, bitvectors, [this, &agg, &row_scores](const TreeNodeElement<ThresholdType>& leaf) {
+              agg.ProcessTreeNodePrediction(row_scores, leaf, weights_);
+            });
+          }
+        } else {
+          for (j = 0, limit = roots_.size(); j < limit; ++j) {
+            for (i = batch; i < batch_end; ++i) {
+              agg.ProcessTreeNodePrediction(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
+            }
           }
         }
         for (i = batch; i < batch_end; ++i) {
@@ -644,25 +855,43 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
                                  label_data == nullptr ? nullptr : (label_data + i));
             }
           });
-    } else { /* section E2: 2+ outputs, 2+ rows, parallelization by rows */
+    } else { /* section E2: 2+ outputs, 2+ rows, parallelization by blocks of rows */
       auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(N));
       concurrency::ThreadPool::TrySimpleParallelFor(
           ttp,
           num_threads,
           [this, &agg, num_threads, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
-            size_t j, limit;
-            InlinedVector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_targets_or_classes_));
+            const ptrdiff_t row_block = parallel_row_block_;
+            std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(
+                static_cast<size_t>(row_block), InlinedVector<ScoreValue<ThresholdType>>(onnxruntime::narrow<size_t>(n_targets_or_classes_)));
+            InlinedVector<uint64_t> bitvectors;
             auto work = concurrency::ThreadPool::PartitionWork(batch_num, onnxruntime::narrow<ptrdiff_t>(num_threads), onnxruntime::narrow<ptrdiff_t>(N));
 
-            for (auto i = work.start; i < work.end; ++i) {
-              std::fill(scores.begin(), scores.end(), ScoreValue<ThresholdType>({0, 0}));
-              for (j = 0, limit = roots_.size(); j < limit; ++j) {
-                agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
+            for (auto begin = work.start; begin < work.end; begin += row_block) {
+              const auto end = std::min(work.end, begin + row_block);
+              for (auto i = begin; i < end; ++i) {
+                std::fill(scores[i - begin].begin(), scores[i - begin].end(), ScoreValue<ThresholdType>({0, 0}));
+              }
+              if (quick_scorer_.enabled) {
+                for (auto i = begin; i < end; ++i) {
+                  auto& row_scores = scores[i - begin];
+                  ProcessTreeNodeLeaves(x_data + i * stride, bitvectors, [this, &agg, &row_scores](const TreeNodeElement<ThresholdType>& leaf) {
+                    agg.ProcessTreeNodePrediction(row_scores, leaf, weights_);
+                  });
+                }
+              } else {
+                for (size_t j = 0, limit = roots_.size(); j < limit; ++j) {
+                  for (auto i = begin; i < end; ++i) {
+                    agg.ProcessTreeNodePrediction(scores[i - begin], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
+                  }
+                }
               }
 
-              agg.FinalizeScores(scores,
-                                 z_data + i * n_targets_or_classes_, -1,
-                                 label_data == nullptr ? nullptr : (label_data + i));
+              for (auto i = begin; i < end; ++i) {
+                agg.FinalizeScores(scores[i - begin],
+                                   z_data + i * n_targets_or_classes_, -1,
+                                   label_data == nullptr ? nullptr : (label_data + i));
+              }
             }
           });
     }
@@ -767,6 +996,39 @@ TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeave(
   return root;
 }
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename FN>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeavesQuickScorer(
+    const InputType* x_data, uint64_t* bitvectors, FN&& fn) const {
+  const size_t n_trees = roots_.size();
+  std::fill(bitvectors, bitvectors + n_trees, ~uint64_t{0});
+  const ThresholdType* thresholds = quick_scorer_.thresholds.data();
+  const uint32_t* tree_ids = quick_scorer_.tree_ids.data();
+  const uint64_t* masks = quick_scorer_.masks.data();
+  for (size_t f = 0, n_features = quick_scorer_.feature_offsets.size() - 1; f < n_features; ++f) {
+    size_t k = quick_scorer_.feature_offsets[f];
+    const size_t end = quick_scorer_.feature_offsets[f + 1];
+    if (k == end) {
+      continue;
+    }
+    // A missing value makes every condition false and follows every false branch like ProcessTreeNodeLeave.
+    const InputType val = x_data[f];
+    if (quick_scorer_.strict) {
+      for (; k < end && !(val < thresholds[k]); ++k) {
+        bitvectors[tree_ids[k]] &= masks[k];
+      }
+    } else {
+      for (; k < end && !(val <= thresholds[k]); ++k) {
+        bitvectors[tree_ids[k]] &= masks[k];
+      }
+    }
+  }
+  const TreeNodeElement<ThresholdType>* const* leaves = quick_scorer_.leaves.data();
+  for (size_t j = 0; j < n_trees; ++j) {
+    fn(*leaves[quick_scorer_.leaf_offsets[j] + QuickScorerFirstLeaf(bitvectors[j])]);
+  }
+}
+
 // TI: input type
 // TH: threshold type, double if T==double, float otherwise
 // TO: output type
@@ -786,6 +1048,7 @@ class TreeEnsembleCommonClassifier : public TreeEnsembleCommon<InputType, Thresh
   Status Init(int parallel_tree,
               int parallel_tree_N,
               int parallel_N,
+              int parallel_row_block,
               const std::string& aggregate_function,
               const std::vector<float>& base_values,
               const std::vector<ThresholdType>& base_values_as_tensor,
@@ -825,6 +1088,7 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::Init(
       80,
       128,
       50,
+      GetParallelRowBlock(info),
       info.GetAttrOrDefault<std::string>("aggregate_function", "SUM"),
       info.GetAttrsOrDefault<float>("base_values"),
       base_values_as_tensor,
@@ -854,6 +1118,7 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::Init(
     int parallel_tree,
     int parallel_tree_N,
     int parallel_N,
+    int parallel_row_block,
     const std::string& aggregate_function,
     const std::vector<float>& base_values,
     const std::vector<ThresholdType>& base_values_as_tensor,
@@ -880,6 +1145,7 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::Init(
       parallel_tree,
       parallel_tree_N,
       parallel_N,
+      parallel_row_block,
       aggregate_function,
       base_values,
       base_values_as_tensor,
@@ -153,6 +153,58 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::CreatePlan(const Tensor& X, const Tensor& W, float Beta, concurrency::ThreadPool* thread_pool,
+                               ConvPlan& plan) const {
+  const int64_t N = X.Shape()[0];
+  const int64_t C = X.Shape()[1];
+  const int64_t M = W.Shape()[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(&X, &W));
+
+  // kernel_shape is an optional attribute and has to be inferred from W if not provided
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W.Shape(), plan.kernel_shape));
+  const size_t kernel_rank = plan.kernel_shape.size();
+
+  plan.pads.assign(conv_attrs_.pads.begin(), conv_attrs_.pads.end());
+  if (plan.pads.empty()) {
+    plan.pads.resize(kernel_rank * 2, 0);
+  }
+  plan.dilations.assign(conv_attrs_.dilations.begin(), conv_attrs_.dilations.end());
+  if (plan.dilations.empty()) {
+    plan.dilations.resize(kernel_rank, 1);
+  }
+  plan.strides.assign(conv_attrs_.strides.begin(), conv_attrs_.strides.end());
+  if (plan.strides.empty()) {
+    plan.strides.resize(kernel_rank, 1);
+  }
+
+  plan.Y_dims = {N, M};
+  TensorShape input_shape = X.Shape().Slice(2);
+  ORT_RETURN_IF_ERROR(conv_attrs_.InferPadsAndOutputShape(input_shape, plan.kernel_shape, plan.strides,
+                                                          plan.dilations, plan.pads, plan.Y_dims));
+  TensorShape output_shape = TensorShape(plan.Y_dims).Slice(2);
+
+  if (kernel_rank >= 1 && kernel_rank <= 3 && output_shape.Size() != 0 && N != 0 && M != 0) {
+    MlasConvPrepare(&plan.parameters,
+                    kernel_rank,
+                    narrow<size_t>(N),
+                    narrow<size_t>(conv_attrs_.group),
+                    narrow<size_t>(C / conv_attrs_.group),
+                    input_shape.GetDims().data(),
+                    plan.kernel_shape.data(),
+                    plan.dilations.data(),
+                    plan.pads.data(),
+                    plan.strides.data(),
+                    output_shape.GetDims().data(),
+                    narrow<size_t>(M / conv_attrs_.group),
+                    &activation_,
+                    &plan.working_buffer_size,
+                    Beta,
+                    thread_pool);
+  }
+
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* X = context->Input<Tensor>(0);
@@ -162,29 +214,24 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
   const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
-
-  // kernel_shape is an optional attribute and has to be inferred from W if not provided
-  TensorShapeVector kernel_shape;
-  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
 
-  ConvPadVector pads(conv_attrs_.pads);
-  if (pads.empty()) {
-    pads.resize(kernel_shape.size() * 2, 0);
-  }
-  TensorShapeVector dilations(conv_attrs_.dilations);
-  if (dilations.empty()) {
-    dilations.resize(kernel_shape.size(), 1);
-  }
-  TensorShapeVector strides(conv_attrs_.strides);
-  if (strides.empty()) {
-    strides.resize(kernel_shape.size(), 1);
-  }
+  // The optional Conv/Sum fusion accumulates into the output.
+  const float Beta = Sum != nullptr ? 1.0f : 0.0f;
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
 
-  TensorShapeVector Y_dims({N, M});
+  // The padding, the output shape and the MLAS parameters only depend on the shapes of the inputs.
+  std::shared_ptr<const ConvPlan> plan;
+  ORT_RETURN_IF_ERROR(plan_cache_.GetOrCreate(
+      ShapePlanKey().AddShape(&X->Shape()).AddShape(&W->Shape()).AddShape(Sum != nullptr ? &Sum->Shape() : nullptr),
+      [&](ConvPlan& new_plan) { return CreatePlan(*X, *W, Beta, thread_pool, new_plan); },
+      plan));
+  const auto& kernel_shape = plan->kernel_shape;
+  const auto& pads = plan->pads;
+  const auto& dilations = plan->dilations;
+  const auto& strides = plan->strides;
+
+  Tensor* Y = context->Output(0, TensorShape(plan->Y_dims));
   TensorShape input_shape = X->Shape().Slice(2);
-  ORT_RETURN_IF_ERROR(conv_attrs_.InferPadsAndOutputShape(input_shape, kernel_shape, strides, dilations, pads, Y_dims));
-  Tensor* Y = context->Output(0, TensorShape(Y_dims));
   TensorShape output_shape = Y->Shape().Slice(2);
 
   // Bail out early if one of the dimensions is zero.
@@ -198,8 +245,6 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   auto Xdata = X->DataAsSpan<float>();
   const auto* Bdata = B != nullptr ? B->Data<float>() : nullptr;
   auto Ydata = Y->MutableDataAsSpan<float>();
-  // Check for the optional Conv/Sum fusion.
-  float Beta = 0.0f;
   if (Sum != nullptr) {
     const auto& sum_shape = Sum->Shape();
     ORT_RETURN_IF_NOT(Y->Shape() == sum_shape, "output and sum shape must match");
@@ -208,36 +253,16 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
     if (Ydata.data() != sum_data.data()) {
       gsl::copy(sum_data, Ydata);
     }
-    Beta = 1.0f;
   }
   const size_t kernel_rank = kernel_shape.size();
-  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
 
   if (kernel_rank >= 1 && kernel_rank <= 3) {
-    MLAS_CONV_PARAMETERS Parameters;
-    size_t WorkingBufferSize;
-    MlasConvPrepare(&Parameters,
-                    kernel_rank,
-                    narrow<size_t>(N),
-                    narrow<size_t>(conv_attrs_.group),
-                    narrow<size_t>(C / conv_attrs_.group),
-                    input_shape.GetDims().data(),
-                    kernel_shape.data(),
-                    dilations.data(),
-                    pads.data(),
-                    strides.data(),
-                    output_shape.GetDims().data(),
-                    narrow<size_t>(M / conv_attrs_.group),
-                    &activation_,
-                    &WorkingBufferSize,
-                    Beta,
-                    thread_pool);
-
+    const size_t WorkingBufferSize = plan->working_buffer_size;
     auto* working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * SafeInt<size_t>(WorkingBufferSize))
                                                : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(std::move(alloc)));
 
-    MlasConv(&Parameters,
+    MlasConv(&plan->parameters,
              Xdata.data(),
              W->Data<float>(),
              Bdata,
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "core/framework/op_kernel.h"
+#include "core/framework/shape_plan_cache.h"
 #include "core/providers/cpu/nn/conv_attributes.h"
 #include "core/mlas/inc/mlas.h"
 
@@ -34,6 +35,24 @@ class Conv<float> : public OpKernel {
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  // State derived from the shapes of X, W and the optional Sum input.
+  struct ConvPlan {
+    TensorShapeVector kernel_shape;
+    ConvAttributes::ConvPadVector pads;
+    TensorShapeVector dilations;
+    TensorShapeVector strides;
+    TensorShapeVector Y_dims;
+    // set when the kernel rank is 1 to 3 and the output is not empty
+    MLAS_CONV_PARAMETERS parameters;
+    size_t working_buffer_size = 0;
+  };
+
+  Status CreatePlan(const Tensor& X, const Tensor& W, float Beta, concurrency::ThreadPool* thread_pool,
+                    ConvPlan& plan) const;
+
+  ShapePlanCache<ConvPlan> plan_cache_;
 };
 
 }  // namespace onnxruntime
@@ -123,8 +123,17 @@ Status PoolBase::Compute(OpKernelContext* context, MLAS_POOLING_KIND kind) const
                       "kernel_shape num_dims is not compatible with X num_dims.");
   }
 
-  auto pads = pool_attrs_.pads;
-  auto output_dims = pool_attrs_.SetOutputSize(x_shape, x_shape[1], &pads);
+  std::shared_ptr<const PoolPlan> plan;
+  ORT_RETURN_IF_ERROR(plan_cache_.GetOrCreate(
+      ShapePlanKey().AddShape(&x_shape),
+      [&](PoolPlan& new_plan) {
+        new_plan.pads = pool_attrs_.pads;
+        new_plan.output_dims = pool_attrs_.SetOutputSize(x_shape, x_shape[1], &new_plan.pads);
+        return Status::OK();
+      },
+      plan));
+  const auto& pads = plan->pads;
+  const auto& output_dims = plan->output_dims;
   TensorShape output_shape(output_dims);
   Tensor* Y = context->Output(0, output_shape);
 
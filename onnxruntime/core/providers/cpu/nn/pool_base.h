@@ -7,6 +7,7 @@
 #ifndef SHARED_PROVIDER
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/shape_plan_cache.h"
 #include "core/util/math.h"
 #endif
 #include "core/providers/cpu/nn/pool_attributes.h"
@@ -121,6 +122,16 @@ class PoolBase {
 
   PoolAttributes pool_attrs_;
 
+#ifndef SHARED_PROVIDER
+  // Padding and output shape of the MLAS pooling path, derived from the shape of X.
+  struct PoolPlan {
+    TensorShapeVector pads;
+    TensorShapeVector output_dims;
+  };
+
+  ShapePlanCache<PoolPlan> plan_cache_;
+#endif
+
   inline int64_t stride_h() const {
     return pool_attrs_.global_pooling ? 1 : pool_attrs_.strides[0];
   }
@@ -13,10 +13,13 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 
-#include <queue>
+#include <algorithm>
+#include <cmath>
 #include <utility>
+#include <vector>
 
 #include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
 #include "non_max_suppression_helper.h"
 
 // TODO:fix the warnings
@@ -118,6 +121,116 @@ Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
   return Status::OK();
 }
 
+namespace {
+
+// The corners and areas of boxes, one array per coordinate, so that the IOU of a candidate box with many boxes is
+// computed by loops the compiler can vectorize.
+struct BoxCorners {
+  void Resize(size_t num_boxes) {
+    x_min_.resize(num_boxes);
+    y_min_.resize(num_boxes);
+    x_max_.resize(num_boxes);
+    y_max_.resize(num_boxes);
+    area_.resize(num_boxes);
+  }
+
+  // Same arithmetic as SuppressByIOU.
+  void Set(size_t i, const float* box, int64_t center_point_box) {
+    float x_min{}, y_min{}, x_max{}, y_max{};
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2]
+      MaxMin(box[1], box[3], x_min, x_max);
+      MaxMin(box[0], box[2], y_min, y_max);
+    } else {
+      // boxes data format [x_center, y_center, width, height]
+      const float width_half = box[2] / 2;
+      const float height_half = box[3] / 2;
+      x_min = box[0] - width_half;
+      x_max = box[0] + width_half;
+      y_min = box[1] - height_half;
+      y_max = box[1] + height_half;
+    }
+    x_min_[i] = x_min;
+    y_min_[i] = y_min;
+    x_max_[i] = x_max;
+    y_max_[i] = y_max;
+    area_[i] = (x_max - x_min) * (y_max - y_min);
+  }
+
+  void Append(const BoxCorners& boxes, size_t i) {
+    x_min_.push_back(boxes.x_min_[i]);
+    y_min_.push_back(boxes.y_min_[i]);
+    x_max_.push_back(boxes.x_max_[i]);
+    y_max_.push_back(boxes.y_max_[i]);
+    area_.push_back(boxes.area_[i]);
+  }
+
+  void Clear() {
+    x_min_.clear();
+    y_min_.clear();
+    x_max_.clear();
+    y_max_.clear();
+    area_.clear();
+  }
+
+  size_t Size() const { return area_.size(); }
+
+  // Returns true if the IOU of box i of candidates with one of these boxes exceeds iou_threshold.
+  // The comparisons are those of SuppressByIOU, including for NaN coordinates, so the selections do not change.
+  bool Suppress(const BoxCorners& candidates, size_t i, float iou_threshold) const {
+    const float x_min = candidates.x_min_[i];
+    const float y_min = candidates.y_min_[i];
+    const float x_max = candidates.x_max_[i];
+    const float y_max = candidates.y_max_[i];
+    const float area = candidates.area_[i];
+
+    // Blocks without branches inside, so that the boxes selected first, which suppress the most, are checked first.
+    constexpr size_t kBlockSize = 16;
+    const size_t size = Size();
+    for (size_t begin = 0; begin < size; begin += kBlockSize) {
+      const size_t end = std::min(begin + kBlockSize, size);
+      bool suppressed = false;
+      for (size_t j = begin; j < end; ++j) {
+        const float intersection_x_min = std::max(x_min, x_min_[j]);
+        const float intersection_x_max = std::min(x_max, x_max_[j]);
+        const float intersection_y_min = std::max(y_min, y_min_[j]);
+        const float intersection_y_max = std::min(y_max, y_max_[j]);
+        const float intersection_area = (intersection_x_max - intersection_x_min) *
+                                        (intersection_y_max - intersection_y_min);
+        const float union_area = area + area_[j] - intersection_area;
+        const bool overlaps = !(intersection_x_max <= intersection_x_min) &&
+                              !(intersection_y_max <= intersection_y_min) && !(intersection_area <= .0f) &&
+                              !(area <= .0f) && !(area_[j] <= .0f) && !(union_area <= .0f) &&
+                              intersection_area / union_area > iou_threshold;
+        suppressed |= overlaps;
+      }
+      if (suppressed) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::vector<float> x_min_;
+  std::vector<float> y_min_;
+  std::vector<float> x_max_;
+  std::vector<float> y_max_;
+  std::vector<float> area_;
+};
+
+struct BoxInfoPtr {
+  float score_{};
+  int64_t index_{};
+
+  BoxInfoPtr() = default;
+  explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
+  inline bool operator<(const BoxInfoPtr& rhs) const {
+    return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
+  }
+};
+
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   ORT_RETURN_IF_ERROR(PrepareCompute(ctx, pc));
@@ -135,75 +248,99 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
 
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
-
-  struct BoxInfoPtr {
-    float score_{};
-    int64_t index_{};
-
-    BoxInfoPtr() = default;
-    explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
-    inline bool operator<(const BoxInfoPtr& rhs) const {
-      return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
-    }
-  };
-
   const auto center_point_box = GetCenterPointBox();
-
-  std::vector<SelectedIndex> selected_indices;
-  std::vector<BoxInfoPtr> selected_boxes_inside_class;
-  selected_boxes_inside_class.reserve(std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), pc.num_boxes_));
-
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
-      std::vector<BoxInfoPtr> candidate_boxes;
-      candidate_boxes.reserve(pc.num_boxes_);
-
-      // Filter by score_threshold_
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            candidate_boxes.emplace_back(*class_scores, box_index);
+  const auto num_boxes = static_cast<size_t>(pc.num_boxes_);
+  auto* thread_pool = ctx->GetOperatorThreadPool();
+
+  // The corners of the boxes of a batch are shared by all its classes.
+  std::vector<BoxCorners> batch_corners(static_cast<size_t>(pc.num_batches_));
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(pc.num_batches_),
+      TensorOpCost{static_cast<double>(num_boxes * 4 * sizeof(float)),
+                   static_cast<double>(num_boxes * 5 * sizeof(float)), static_cast<double>(num_boxes * 8)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t batch_index = first; batch_index < last; ++batch_index) {
+          auto& corners = batch_corners[batch_index];
+          corners.Resize(num_boxes);
+          const float* batch_boxes = boxes_data + batch_index * pc.num_boxes_ * 4;
+          for (size_t box_index = 0; box_index < num_boxes; ++box_index) {
+            corners.Set(box_index, batch_boxes + box_index * 4, center_point_box);
           }
         }
-      } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          candidate_boxes.emplace_back(*class_scores, box_index);
-        }
-      }
-      std::priority_queue<BoxInfoPtr, std::vector<BoxInfoPtr>> sorted_boxes(std::less<BoxInfoPtr>(), std::move(candidate_boxes));
-
-      selected_boxes_inside_class.clear();
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_boxes.empty() && static_cast<int64_t>(selected_boxes_inside_class.size()) < max_output_boxes_per_class) {
-        const BoxInfoPtr& next_top_score = sorted_boxes.top();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (const auto& selected_index : selected_boxes_inside_class) {
-          if (SuppressByIOU(batch_boxes, next_top_score.index_, selected_index.index_, center_point_box, iou_threshold)) {
-            selected = false;
-            break;
+      });
+
+  // Every (batch, class) pair is suppressed independently into its own list, and the lists are concatenated in
+  // (batch, class) order, so the output does not depend on the number of threads.
+  const auto max_selected = std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), num_boxes);
+  const auto num_lists = static_cast<std::ptrdiff_t>(pc.num_batches_ * pc.num_classes_);
+  std::vector<std::vector<SelectedIndex>> selected_per_class(static_cast<size_t>(num_lists));
+  const double log_num_boxes = std::log2(static_cast<double>(std::max<size_t>(num_boxes, 2)));
+  const TensorOpCost cost{static_cast<double>(num_boxes * sizeof(float)),
+                          static_cast<double>(max_selected * sizeof(SelectedIndex)),
+                          static_cast<double>(num_boxes) * log_num_boxes * 2 +
+                              static_cast<double>(max_selected) * std::min(static_cast<double>(max_selected), 64.0) * 8};
+
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, num_lists, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<BoxInfoPtr> candidate_boxes;
+        BoxCorners selected_boxes_inside_class;
+        for (std::ptrdiff_t list_index = first; list_index < last; ++list_index) {
+          const int64_t batch_index = list_index / pc.num_classes_;
+          const int64_t class_index = list_index % pc.num_classes_;
+          const BoxCorners& corners = batch_corners[static_cast<size_t>(batch_index)];
+
+          // Filter by score_threshold_
+          candidate_boxes.clear();
+          candidate_boxes.reserve(num_boxes);
+          const auto* class_scores = scores_data + list_index * pc.num_boxes_;
+          if (pc.score_threshold_ != nullptr) {
+            for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index) {
+              if (class_scores[box_index] > score_threshold) {
+                candidate_boxes.emplace_back(class_scores[box_index], box_index);
+              }
+            }
+          } else {
+            for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index) {
+              candidate_boxes.emplace_back(class_scores[box_index], box_index);
+            }
           }
-        }
 
-        if (selected) {
-          selected_boxes_inside_class.push_back(next_top_score);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+          // The boxes are popped in score order from a heap, so only the candidates visited before
+          // max_output_boxes_per_class boxes are selected are ever sorted.
+          std::make_heap(candidate_boxes.begin(), candidate_boxes.end());
+          auto heap_end = candidate_boxes.end();
+
+          auto& selected_indices = selected_per_class[static_cast<size_t>(list_index)];
+          selected_boxes_inside_class.Clear();
+          // Get the next box with top score, filter by iou_threshold
+          while (heap_end != candidate_boxes.begin() && selected_boxes_inside_class.Size() < max_selected) {
+            std::pop_heap(candidate_boxes.begin(), heap_end);
+            --heap_end;
+            const auto box_index = static_cast<size_t>(heap_end->index_);
+
+            // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
+            if (!selected_boxes_inside_class.Suppress(corners, box_index, iou_threshold)) {
+              selected_boxes_inside_class.Append(corners, box_index);
+              selected_indices.emplace_back(batch_index, class_index, heap_end->index_);
+            }
+          }
         }
-        sorted_boxes.pop();
-      }  // while
-    }  // for class_index
-  }  // for batch_index
+      });
+
+  size_t num_selected = 0;
+  for (const auto& selected_indices : selected_per_class) {
+    num_selected += selected_indices.size();
+  }
 
   constexpr auto last_dim = 3;
-  const auto num_selected = selected_indices.size();
   Tensor* output = ctx->Output(0, {static_cast<int64_t>(num_selected), last_dim});
   ORT_ENFORCE(output != nullptr);
   static_assert(last_dim * sizeof(int64_t) == sizeof(SelectedIndex), "Possible modification of SelectedIndex");
-  memcpy(output->MutableData<int64_t>(), selected_indices.data(), num_selected * sizeof(SelectedIndex));
+  auto* output_data = output->MutableData<int64_t>();
+  for (const auto& selected_indices : selected_per_class) {
+    memcpy(output_data, selected_indices.data(), selected_indices.size() * sizeof(SelectedIndex));
+    output_data += selected_indices.size() * last_dim;
+  }
 
   return Status::OK();
 }
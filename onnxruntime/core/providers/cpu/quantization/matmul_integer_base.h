@@ -78,6 +78,27 @@ class MatMulIntegerBase : public OpKernel {
     return Status::OK();
   }
 
+  bool IsPrePackCacheable(int input_idx) const override {
+    return input_idx == GetBIdx();
+  }
+
+  Status UseCachedPrePackedBuffers(const Tensor& tensor,
+                                   std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx,
+                                   /*out*/ bool& used_cached_buffers) override {
+    used_cached_buffers = false;
+
+    if (input_idx == GetBIdx()) {
+      used_cached_buffers = true;
+      // the state PrePack() derives from the tensor
+      b_shape_ = tensor.Shape();
+      b_is_signed_ = tensor.IsDataType<int8_t>();
+      packed_b_ = std::move(prepacked_buffers[0]);
+    }
+
+    return Status::OK();
+  }
+
  protected:
   /**
    * @return input index of Matrix B, the weight tensor
@@ -3,16 +3,20 @@
 
 #include "core/providers/cpu/signal/dft.h"
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
 #include <functional>
 #include <limits>
+#include <memory>
+#include <type_traits>
 #include <vector>
 #include <core/common/safeint.h>
 
 #include "core/framework/op_kernel.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
+#include "core/providers/cpu/signal/mixed_radix_fft.h"
 #include "core/providers/cpu/signal/utils.h"
 #include "core/util/math_cpuonly.h"
 #include "Eigen/src/Core/Map.h"
@@ -112,11 +116,8 @@ static Status fft_radix2(OpKernelContext* /*ctx*/, const Tensor* X, Tensor* Y, s
 
   // Get data
   auto* X_data = const_cast<U*>(reinterpret_cast<const U*>(X->DataRaw())) + X_offset;
-  // Get window
-  U* window_data = nullptr;
-  if (window) {
-    window_data = const_cast<U*>(reinterpret_cast<const U*>(window->DataRaw()));
-  }
+  // Get window, which is real valued for complex signals too
+  const T* window_data = window ? reinterpret_cast<const T*>(window->DataRaw()) : nullptr;
 
   size_t Y_data_stride = 1;
   std::complex<T>* Y_data;
@@ -256,10 +257,8 @@ static Status dft_bluestein_z_chirp(
   // Get data
   auto* X_data = const_cast<U*>(reinterpret_cast<const U*>(X->DataRaw())) + X_offset;
   auto* Y_data = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw()) + Y_offset;
-  U* window_data = nullptr;
-  if (window) {
-    window_data = const_cast<U*>(reinterpret_cast<const U*>(window->DataRaw()));
-  }
+  // the window is real valued for complex signals too
+  const T* window_data = window ? reinterpret_cast<const T*>(window->DataRaw()) : nullptr;
 
   auto a = onnxruntime::Tensor(X->DataType(), dft_input_shape, alloc);
   auto a_fft = onnxruntime::Tensor(Y->DataType(), dft_input_shape, alloc);
@@ -313,11 +312,59 @@ static Status dft_bluestein_z_chirp(
   return Status::OK();
 }
 
+// Transforms one signal with a mixed radix plan. The signal is zero padded or truncated to the length of the plan.
+template <typename T, typename U>
+static void fft_mixed_radix(const signal::FftPlan<T>& plan, const U* X_data, size_t X_stride, size_t number_of_samples,
+                            const T* window_data, std::complex<T>* Y_data, size_t Y_stride, size_t output_size,
+                            std::complex<T>* data, std::complex<T>* scratch) {
+  const size_t signal_length = plan.SignalLength();
+  const size_t available_samples = std::min(number_of_samples, signal_length);
+  auto load_samples = [&](auto&& store) {
+    for (size_t n = 0; n < available_samples; n++) {
+      const U x = X_data[n * X_stride];
+      store(n, window_data ? x * window_data[n] : x);
+    }
+    for (size_t n = available_samples; n < signal_length; n++) {
+      store(n, U(0));
+    }
+  };
+
+  if constexpr (std::is_same_v<T, U>) {
+    if (plan.IsRealInput()) {
+      // the even samples are the real parts of the packed signal, the odd ones the imaginary parts
+      auto* packed = reinterpret_cast<T*>(data);
+      load_samples([packed](size_t n, T x) { packed[n] = x; });
+      plan.Transform(data, scratch);
+      for (size_t i = 0; i < output_size; i++) {
+        *(Y_data + i * Y_stride) = data[i];
+      }
+      return;
+    }
+  }
+
+  load_samples([data](size_t n, U x) { data[n] = std::complex<T>(x); });
+  plan.Transform(data, scratch);
+  const T scale = plan.IsInverse() ? static_cast<T>(1) / static_cast<T>(signal_length) : static_cast<T>(1);
+  for (size_t i = 0; i < output_size; i++) {
+    *(Y_data + i * Y_stride) = data[i] * scale;
+  }
+}
+
+// Cost of a transform of the plan for TryParallelFor.
+template <typename T, typename U>
+static TensorOpCost fft_mixed_radix_cost(const signal::FftPlan<T>& plan, size_t output_size) {
+  const double signal_length = static_cast<double>(plan.SignalLength());
+  const double transform_length = static_cast<double>(plan.IsRealInput() ? plan.SignalLength() / 2 : plan.SignalLength());
+  return TensorOpCost{signal_length * sizeof(U), static_cast<double>(output_size * sizeof(std::complex<T>)),
+                      5.0 * transform_length * std::max(1.0, std::log2(transform_length))};
+}
+
 template <typename T, typename U>
 static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X, Tensor* Y, Tensor& b_fft, Tensor& chirp,
                                          int64_t axis, int64_t dft_length, const Tensor* window, bool is_onesided, bool inverse,
                                          InlinedVector<std::complex<T>>& V,
-                                         InlinedVector<std::complex<T>>& temp_output) {
+                                         InlinedVector<std::complex<T>>& temp_output,
+                                         const signal::FftPlan<T>* plan) {
   // Get shape
   const auto& X_shape = X->Shape();
   const auto& Y_shape = Y->Shape();
@@ -333,9 +380,9 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
   }
 
   // Calculate x/y offsets/strides
-  for (size_t i = 0; i < total_dfts; i++) {
-    size_t X_offset = 0;
-    size_t X_stride = onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / complex_input_factor);
+  auto compute_offsets = [&](size_t i, size_t& X_offset, size_t& X_stride, size_t& Y_offset, size_t& Y_stride) {
+    X_offset = 0;
+    X_stride = onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / complex_input_factor);
     size_t cumulative_packed_stride = total_dfts;
     size_t temp = i;
     for (size_t r = 0; r < batch_and_signal_rank; r++) {
@@ -348,8 +395,8 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
       X_offset += index * SafeInt<size_t>(X_shape.SizeFromDimension(r + 1)) / complex_input_factor;
     }
 
-    size_t Y_offset = 0;
-    size_t Y_stride = onnxruntime::narrow<size_t>(Y_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / 2);
+    Y_offset = 0;
+    Y_stride = onnxruntime::narrow<size_t>(Y_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / 2);
     cumulative_packed_stride = total_dfts;
     temp = i;
     for (size_t r = 0; r < batch_and_signal_rank; r++) {
@@ -361,6 +408,34 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
       temp -= (index * cumulative_packed_stride);
       Y_offset += index * SafeInt<size_t>(Y_shape.SizeFromDimension(r + 1)) / 2;
     }
+  };
+
+  if (plan != nullptr) {
+    // The plan is immutable, so the signals are transformed in parallel, each thread with its own buffers.
+    const auto* X_data = reinterpret_cast<const U*>(X->DataRaw());
+    auto* Y_data = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw());
+    const T* window_data = window ? reinterpret_cast<const T*>(window->DataRaw()) : nullptr;
+    const size_t number_of_samples = onnxruntime::narrow<size_t>(X_shape[onnxruntime::narrow<size_t>(axis)]);
+    const size_t output_size = onnxruntime::narrow<size_t>(Y_shape[onnxruntime::narrow<size_t>(axis)]);
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(total_dfts),
+        fft_mixed_radix_cost<T, U>(*plan, output_size),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          std::vector<std::complex<T>> buffers(2 * plan->BufferSize());
+          for (std::ptrdiff_t i = first; i < last; i++) {
+            size_t X_offset, X_stride, Y_offset, Y_stride;
+            compute_offsets(static_cast<size_t>(i), X_offset, X_stride, Y_offset, Y_stride);
+            fft_mixed_radix<T, U>(*plan, X_data + X_offset, X_stride, number_of_samples, window_data,
+                                  Y_data + Y_offset, Y_stride, output_size,
+                                  buffers.data(), buffers.data() + plan->BufferSize());
+          }
+        });
+    return Status::OK();
+  }
+
+  for (size_t i = 0; i < total_dfts; i++) {
+    size_t X_offset, X_stride, Y_offset, Y_stride;
+    compute_offsets(i, X_offset, X_stride, Y_offset, Y_stride);
 
     if (is_power_of_2(onnxruntime::narrow<size_t>(dft_length))) {
       ORT_RETURN_IF_ERROR((fft_radix2<T, U>(ctx, X, Y, X_offset, X_stride, Y_offset, Y_stride, axis, onnxruntime::narrow<size_t>(dft_length), window,
@@ -374,7 +449,8 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
   return Status::OK();
 }
 
-static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, bool is_onesided, bool inverse) {
+static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, bool is_onesided, bool inverse,
+                                         const signal::FftPlanCache& plans) {
   // Get input shape
   const auto* X = ctx->Input<Tensor>(0);
   const auto* dft_length = ctx->Input<Tensor>(1);
@@ -413,12 +489,16 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, boo
   if (element_size == sizeof(float)) {
     InlinedVector<std::complex<float>> V;
     InlinedVector<std::complex<float>> temp_output;
+    std::shared_ptr<const signal::FftPlan<float>> plan;
+    ORT_RETURN_IF_ERROR(plans.GetPlan<float>(onnxruntime::narrow<size_t>(number_of_samples), inverse,
+                                           is_real_valued && is_onesided, plan));
     if (is_real_valued) {
       ORT_RETURN_IF_ERROR((discrete_fourier_transform<float, float>(ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr,
-                                                                    is_onesided, inverse, V, temp_output)));
+                                                                    is_onesided, inverse, V, temp_output, plan.get())));
     } else if (is_complex_valued) {
       ORT_RETURN_IF_ERROR((discrete_fourier_transform<float, std::complex<float>>(
-          ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr, is_onesided, inverse, V, temp_output)));
+          ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr, is_onesided, inverse, V, temp_output,
+          plan.get())));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimension must be the batch dimension and its second "
@@ -429,12 +509,16 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, boo
   } else if (element_size == sizeof(double)) {
     InlinedVector<std::complex<double>> V;
     InlinedVector<std::complex<double>> temp_output;
+    std::shared_ptr<const signal::FftPlan<double>> plan;
+    ORT_RETURN_IF_ERROR(plans.GetPlan<double>(onnxruntime::narrow<size_t>(number_of_samples), inverse,
+                                            is_real_valued && is_onesided, plan));
     if (is_real_valued) {
       ORT_RETURN_IF_ERROR((discrete_fourier_transform<double, double>(ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr,
-                                                                      is_onesided, inverse, V, temp_output)));
+                                                                      is_onesided, inverse, V, temp_output, plan.get())));
     } else if (is_complex_valued) {
       ORT_RETURN_IF_ERROR((discrete_fourier_transform<double, std::complex<double>>(
-          ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr, is_onesided, inverse, V, temp_output)));
+          ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr, is_onesided, inverse, V, temp_output,
+          plan.get())));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimension must be the batch dimension and its second "
@@ -456,12 +540,13 @@ Status DFT::Compute(OpKernelContext* ctx) const {
     axis = axes_tensor->Data<int64_t>()[0];
   }
 
-  ORT_RETURN_IF_ERROR(discrete_fourier_transform(ctx, axis, is_onesided_, is_inverse_));
+  ORT_RETURN_IF_ERROR(discrete_fourier_transform(ctx, axis, is_onesided_, is_inverse_, fft_plans_));
   return Status::OK();
 }
 
 template <typename T, typename U>
-static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_onesided, bool /*inverse*/) {
+static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_onesided, bool /*inverse*/,
+                                           const signal::FftPlanCache& plans) {
   // Attr("onesided"): default = 1
   // Input(0, "signal") type = T1
   // Input(1, "frame_length") type = T2
@@ -529,6 +614,33 @@ static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_oneside
   auto dft_input_shape = onnxruntime::TensorShape({1, window_size, signal_components});
   auto dft_output_shape = onnxruntime::TensorShape({1, dft_output_size, output_components});
 
+  std::shared_ptr<const signal::FftPlan<T>> plan;
+  ORT_RETURN_IF_ERROR(plans.GetPlan<T>(onnxruntime::narrow<size_t>(window_size), false,
+                                       std::is_same_v<T, U> && is_onesided, plan));
+  if (plan) {
+    // Frames start frame_step samples apart, each is windowed and transformed independently.
+    const auto* signal_begin = reinterpret_cast<const U*>(signal->DataRaw());
+    auto* spectra_begin = reinterpret_cast<std::complex<T>*>(Y_data);
+    const T* window_data = window ? window->Data<T>() : nullptr;
+    const auto frame_size = onnxruntime::narrow<size_t>(window_size);
+    const auto spectrum_size = onnxruntime::narrow<size_t>(dft_output_size);
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(batch_size * n_dfts),
+        fft_mixed_radix_cost<T, U>(*plan, spectrum_size),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          std::vector<std::complex<T>> buffers(2 * plan->BufferSize());
+          for (std::ptrdiff_t frame = first; frame < last; frame++) {
+            const int64_t batch_idx = frame / n_dfts;
+            const int64_t i = frame % n_dfts;
+            const U* input_frame_begin = signal_begin + batch_idx * signal_size + i * frame_step;
+            fft_mixed_radix<T, U>(*plan, input_frame_begin, 1, frame_size, window_data,
+                                  spectra_begin + frame * dft_output_size, 1, spectrum_size,
+                                  buffers.data(), buffers.data() + plan->BufferSize());
+          }
+        });
+    return Status::OK();
+  }
+
   Tensor b_fft, chirp;
   InlinedVector<std::complex<T>> V;
   InlinedVector<std::complex<T>> temp_output;
@@ -536,8 +648,8 @@ static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_oneside
   // Run each dft of each batch as if it was a real-valued batch size 1 dft operation
   for (int64_t batch_idx = 0; batch_idx < batch_size; batch_idx++) {
     for (int64_t i = 0; i < n_dfts; i++) {
-      auto input_frame_begin =
-          signal_data + (batch_idx * signal_size * signal_components) + (i * frame_step * signal_components);
+      // U is std::complex<T> for complex signals, so the offsets count samples rather than components
+      auto input_frame_begin = signal_data + (batch_idx * signal_size) + (i * frame_step);
 
       auto output_frame_begin = Y_data + (batch_idx * n_dfts * dft_output_size * output_components) +
                                 (i * dft_output_size * output_components);
@@ -549,7 +661,7 @@ static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_oneside
 
       // Run individual dft
       ORT_RETURN_IF_ERROR((discrete_fourier_transform<T, U>(ctx, &input, &output, b_fft, chirp, 1, window_size, window, is_onesided,
-                                                            false, V, temp_output)));
+                                                            false, V, temp_output, nullptr)));
     }
   }
 
@@ -576,9 +688,9 @@ Status STFT::Compute(OpKernelContext* ctx) const {
   const auto element_size = data_type->Size();
   if (element_size == sizeof(float)) {
     if (is_real_valued) {
-      ORT_RETURN_IF_ERROR((short_time_fourier_transform<float, float>(ctx, is_onesided_, false)));
+      ORT_RETURN_IF_ERROR((short_time_fourier_transform<float, float>(ctx, is_onesided_, false, fft_plans_)));
     } else if (is_complex_valued) {
-      ORT_RETURN_IF_ERROR((short_time_fourier_transform<float, std::complex<float>>(ctx, is_onesided_, false)));
+      ORT_RETURN_IF_ERROR((short_time_fourier_transform<float, std::complex<float>>(ctx, is_onesided_, false, fft_plans_)));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimenstion must be the batch dimension and its second "
@@ -588,9 +700,9 @@ Status STFT::Compute(OpKernelContext* ctx) const {
     }
   } else if (element_size == sizeof(double)) {
     if (is_real_valued) {
-      ORT_RETURN_IF_ERROR((short_time_fourier_transform<double, double>(ctx, is_onesided_, false)));
+      ORT_RETURN_IF_ERROR((short_time_fourier_transform<double, double>(ctx, is_onesided_, false, fft_plans_)));
     } else if (is_complex_valued) {
-      ORT_RETURN_IF_ERROR((short_time_fourier_transform<double, std::complex<double>>(ctx, is_onesided_, false)));
+      ORT_RETURN_IF_ERROR((short_time_fourier_transform<double, std::complex<double>>(ctx, is_onesided_, false, fft_plans_)));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimenstion must be the batch dimension and its second "
@@ -0,0 +1,235 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/signal/mixed_radix_fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace onnxruntime {
+namespace signal {
+
+namespace {
+
+// i * z for the forward transform's -i and the inverse one's +i: sign * i * z
+template <typename T>
+inline std::complex<T> MulI(const std::complex<T>& z, T sign) {
+  return std::complex<T>(-sign * z.imag(), sign * z.real());
+}
+
+// In place DFT of the R values of t, W = exp(sign * 2 pi i / R).
+template <typename T, size_t R>
+inline void Butterfly(std::complex<T>* t, T sign) {
+  if constexpr (R == 2) {
+    const auto t0 = t[0];
+    t[0] = t0 + t[1];
+    t[1] = t0 - t[1];
+  } else if constexpr (R == 3) {
+    constexpr T c = static_cast<T>(-0.5);
+    const T s = sign * static_cast<T>(0.86602540378443864676);  // sin(2 pi / 3)
+    const auto sum = t[1] + t[2];
+    const auto diff = MulI(t[1] - t[2], s);
+    const auto base = t[0] + c * sum;
+    t[0] = t[0] + sum;
+    t[1] = base + diff;
+    t[2] = base - diff;
+  } else if constexpr (R == 4) {
+    const auto a = t[0] + t[2];
+    const auto b = t[0] - t[2];
+    const auto c = t[1] + t[3];
+    const auto d = MulI(t[1] - t[3], sign);
+    t[0] = a + c;
+    t[1] = b + d;
+    t[2] = a - c;
+    t[3] = b - d;
+  } else {
+    static_assert(R == 5, "Unsupported radix.");
+    constexpr T c1 = static_cast<T>(0.30901699437494742410);   // cos(2 pi / 5)
+    constexpr T c2 = static_cast<T>(-0.80901699437494742410);  // cos(4 pi / 5)
+    const T s1 = sign * static_cast<T>(0.95105651629515357212);  // sin(2 pi / 5)
+    const T s2 = sign * static_cast<T>(0.58778525229247312917);  // sin(4 pi / 5)
+    const auto a1 = t[1] + t[4];
+    const auto b1 = t[1] - t[4];
+    const auto a2 = t[2] + t[3];
+    const auto b2 = t[2] - t[3];
+    const auto base1 = t[0] + c1 * a1 + c2 * a2;
+    const auto base2 = t[0] + c2 * a1 + c1 * a2;
+    const auto rot1 = MulI(s1 * b1 + s2 * b2, static_cast<T>(1));
+    const auto rot2 = MulI(s2 * b1 - s1 * b2, static_cast<T>(1));
+    t[0] = t[0] + a1 + a2;
+    t[1] = base1 + rot1;
+    t[4] = base1 - rot1;
+    t[2] = base2 + rot2;
+    t[3] = base2 - rot2;
+  }
+}
+
+// One Stockham stage. The input holds stride sub transforms of length sub_length interleaved: value k of sub
+// transform s is in[k * stride + s]. Each group of R consecutive sub transforms, s + q * (stride / R), is combined
+// into one of length sub_length * R, written the same way to out.
+template <typename T, size_t R>
+void Stage(const std::complex<T>* in, std::complex<T>* out, size_t sub_length, size_t stride,
+           const std::complex<T>* twiddles, T sign) {
+  const size_t next_stride = stride / R;
+  std::complex<T> t[R];
+  for (size_t k = 0; k < sub_length; ++k) {
+    const std::complex<T>* w = twiddles + k * (R - 1);
+    const std::complex<T>* src = in + k * stride;
+    std::complex<T>* dst = out + k * next_stride;
+    for (size_t s = 0; s < next_stride; ++s) {
+      t[0] = src[s];
+      for (size_t q = 1; q < R; ++q) {
+        t[q] = src[q * next_stride + s] * w[q - 1];
+      }
+      Butterfly<T, R>(t, sign);
+      for (size_t p = 0; p < R; ++p) {
+        dst[p * sub_length * next_stride + s] = t[p];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+bool FftPlan<T>::IsSupportedLength(size_t length) {
+  if (length == 0) {
+    return false;
+  }
+  for (size_t factor : {2, 3, 5}) {
+    while (length % factor == 0) {
+      length /= factor;
+    }
+  }
+  return length == 1;
+}
+
+template <typename T>
+FftPlan<T>::FftPlan(size_t length, bool inverse, bool real_input)
+    : length_(length), inverse_(inverse), real_input_(real_input) {
+  ORT_ENFORCE(IsSupportedLength(length), "Unsupported FFT length ", length);
+  ORT_ENFORCE(!(real_input && inverse), "Real input FFT plans are forward only.");
+
+  size_t remaining = length;
+  while (remaining % 4 == 0) {
+    radices_.push_back(4);
+    remaining /= 4;
+  }
+  for (size_t radix : {2, 3, 5}) {
+    while (remaining % radix == 0) {
+      radices_.push_back(radix);
+      remaining /= radix;
+    }
+  }
+
+  // computed in double precision for the float plans
+  const double sign = inverse ? 1.0 : -1.0;
+  constexpr double tau = 2.0 * M_PI;
+  size_t sub_length = 1;
+  for (size_t radix : radices_) {
+    const size_t next_length = sub_length * radix;
+    for (size_t k = 0; k < sub_length; ++k) {
+      for (size_t q = 1; q < radix; ++q) {
+        const double angle = sign * tau * static_cast<double>(q * k) / static_cast<double>(next_length);
+        twiddles_.emplace_back(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
+      }
+    }
+    sub_length = next_length;
+  }
+
+  if (real_input) {
+    real_twiddles_.reserve(length + 1);
+    for (size_t k = 0; k <= length; ++k) {
+      const double angle = -tau * static_cast<double>(k) / static_cast<double>(2 * length);
+      real_twiddles_.emplace_back(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
+    }
+  }
+}
+
+template <typename T>
+void FftPlan<T>::Transform(std::complex<T>* data, std::complex<T>* scratch) const {
+  const T sign = inverse_ ? static_cast<T>(1) : static_cast<T>(-1);
+  std::complex<T>* in = data;
+  std::complex<T>* out = scratch;
+  const std::complex<T>* twiddles = twiddles_.data();
+  size_t sub_length = 1;
+  size_t stride = length_;
+  for (size_t radix : radices_) {
+    switch (radix) {
+      case 2:
+        Stage<T, 2>(in, out, sub_length, stride, twiddles, sign);
+        break;
+      case 3:
+        Stage<T, 3>(in, out, sub_length, stride, twiddles, sign);
+        break;
+      case 4:
+        Stage<T, 4>(in, out, sub_length, stride, twiddles, sign);
+        break;
+      default:
+        Stage<T, 5>(in, out, sub_length, stride, twiddles, sign);
+        break;
+    }
+    twiddles += sub_length * (radix - 1);
+    sub_length *= radix;
+    stride /= radix;
+    std::swap(in, out);
+  }
+
+  if (!real_input_) {
+    if (in != data) {
+      std::copy(in, in + length_, data);
+    }
+    return;
+  }
+
+  // Z = FFT(x[2n] + i x[2n+1]) holds the spectra of the even and odd samples:
+  // E[k] = (Z[k] + conj(Z[n - k])) / 2, O[k] = (Z[k] - conj(Z[n - k])) / 2i, X[k] = E[k] + exp(-2 pi i k / 2n) O[k]
+  const std::complex<T>* z = in;
+  std::complex<T>* spectrum = in == data ? scratch : data;
+  const std::complex<T> half(static_cast<T>(0.5), 0);
+  const std::complex<T> minus_half_i(0, static_cast<T>(-0.5));
+  for (size_t k = 0; k <= length_; ++k) {
+    const std::complex<T> z_k = z[k == length_ ? 0 : k];
+    const std::complex<T> z_conj = std::conj(z[k == 0 ? 0 : length_ - k]);
+    const std::complex<T> even = (z_k + z_conj) * half;
+    const std::complex<T> odd = (z_k - z_conj) * minus_half_i;
+    spectrum[k] = even + real_twiddles_[k] * odd;
+  }
+  if (spectrum != data) {
+    std::copy(spectrum, spectrum + length_ + 1, data);
+  }
+}
+
+template <typename T>
+Status FftPlanCache::GetPlan(size_t signal_length, bool inverse, bool real_input,
+                             std::shared_ptr<const FftPlan<T>>& plan) const {
+  plan = nullptr;
+  real_input = real_input && !inverse && signal_length % 2 == 0 && FftPlan<T>::IsSupportedLength(signal_length / 2);
+  if (!real_input && !FftPlan<T>::IsSupportedLength(signal_length)) {
+    return Status::OK();
+  }
+
+  const size_t length = real_input ? signal_length / 2 : signal_length;
+  ShapePlanKey key;
+  const int64_t key_values[] = {static_cast<int64_t>(length), inverse, real_input};
+  key.AddValues(gsl::make_span(key_values));
+
+  auto create_plan = [length, inverse, real_input](FftPlan<T>& new_plan) {
+    new_plan = FftPlan<T>(length, inverse, real_input);
+    return Status::OK();
+  };
+  if constexpr (std::is_same_v<T, float>) {
+    return float_plans_.GetOrCreate(std::move(key), create_plan, plan);
+  } else {
+    return double_plans_.GetOrCreate(std::move(key), create_plan, plan);
+  }
+}
+
+template class FftPlan<float>;
+template class FftPlan<double>;
+template Status FftPlanCache::GetPlan<float>(size_t, bool, bool, std::shared_ptr<const FftPlan<float>>&) const;
+template Status FftPlanCache::GetPlan<double>(size_t, bool, bool, std::shared_ptr<const FftPlan<double>>&) const;
+
+}  // namespace signal
+}  // namespace onnxruntime
@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/shape_plan_cache.h"
+
+namespace onnxruntime {
+namespace signal {
+
+/**
+Mixed radix FFT of a length whose prime factors are 2, 3 and 5, e.g. the frame lengths 400 and 480 of 16 kHz audio.
+
+The transform is a Stockham autosort FFT: every stage reads one buffer and writes the other in natural order, so no
+bit reversal pass is needed, and the innermost loop of a stage walks both buffers contiguously. The twiddle factors of
+all the stages are computed once per plan.
+
+A plan for a real input transforms a real signal of twice the length of the plan, packed as the complex signal
+x[2n] + i x[2n+1], and unpacks the onesided spectrum of the real signal, which halves the work of a onesided DFT.
+*/
+template <typename T>
+class FftPlan {
+ public:
+  /** Returns false if the length has prime factors other than 2, 3 and 5. */
+  static bool IsSupportedLength(size_t length);
+
+  FftPlan() = default;
+
+  /**
+  @param length Number of points of the complex transform.
+  @param real_input Whether the plan transforms real signals of 2 * length samples, forward only.
+  */
+  FftPlan(size_t length, bool inverse, bool real_input);
+
+  /** Number of samples of the transformed signals. */
+  size_t SignalLength() const { return real_input_ ? 2 * length_ : length_; }
+  /** Number of complex values of the data and scratch buffers of Transform. */
+  size_t BufferSize() const { return real_input_ ? length_ + 1 : length_; }
+  bool IsRealInput() const { return real_input_; }
+  bool IsInverse() const { return inverse_; }
+
+  /**
+  Transforms the signal in data, without the 1 / n scaling of the inverse transform.
+  A complex transform writes the spectrum to data. A real input transform takes the packed real signal and writes the
+  length + 1 values of its onesided spectrum to data.
+  data and scratch are buffers of BufferSize() values.
+  */
+  void Transform(std::complex<T>* data, std::complex<T>* scratch) const;
+
+ private:
+  size_t length_ = 0;
+  bool inverse_ = false;
+  bool real_input_ = false;
+  InlinedVector<size_t> radices_;
+  // W^(q * k) of every stage, for k over the length of the sub transforms computed so far and q over the radix.
+  std::vector<std::complex<T>> twiddles_;
+  // exp(-2 pi i k / (2 * length)) for k in [0, length], to unpack the spectrum of a real signal.
+  std::vector<std::complex<T>> real_twiddles_;
+};
+
+/**
+FFT plans of the signal lengths a kernel has seen. Shared by the concurrent Compute calls of the kernel.
+*/
+class FftPlanCache {
+ public:
+  /**
+  Gets the plan for the DFT of signal_length samples, or nullptr when the length is not supported.
+  When real_input is set and the length allows it, the plan is a real input one.
+  */
+  template <typename T>
+  Status GetPlan(size_t signal_length, bool inverse, bool real_input, std::shared_ptr<const FftPlan<T>>& plan) const;
+
+ private:
+  ShapePlanCache<FftPlan<float>> float_plans_;
+  ShapePlanCache<FftPlan<double>> double_plans_;
+};
+
+}  // namespace signal
+}  // namespace onnxruntime
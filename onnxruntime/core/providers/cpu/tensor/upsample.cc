@@ -1218,10 +1218,18 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
                                       X, Y->MutableData<T>(), alloc, get_original_coordinate_,
                                       output_height * output_width > 64 ? context->GetOperatorThreadPool() : nullptr);
           } else {
+            std::shared_ptr<const BilinearParams> p;
+            ORT_RETURN_IF_ERROR(bilinear_plan_cache_.GetOrCreate(
+                ShapePlanKey().AddValues(dims).AddValues(output_dims).AddValues(scales).AddValues(roi),
+                [&](BilinearParams& new_p) {
+                  new_p = SetupUpsampleBilinear(input_height, input_width, output_height, output_width,
+                                                height_scale, width_scale, roi,
+                                                alloc, get_original_coordinate_, true);
+                  return Status::OK();
+                },
+                p));
             UpsampleBilinear(batch_size, num_channels, input_height, input_width, output_height, output_width,
-                             height_scale, width_scale, roi,
-                             use_extrapolation_, extrapolation_value_, X->Data<T>(),
-                             Y->MutableData<T>(), alloc, get_original_coordinate_,
+                             *p, use_extrapolation_, extrapolation_value_, X->Data<T>(), Y->MutableData<T>(),
                              output_height * output_width > 64 ? context->GetOperatorThreadPool() : nullptr);
           }
         } else {
@@ -6,6 +6,7 @@
 #include <vector>
 #ifndef SHARED_PROVIDER
 #include "core/framework/op_kernel.h"
+#include "core/framework/shape_plan_cache.h"
 #endif
 #include "core/providers/cpu/tensor/upsamplebase.h"
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -68,6 +69,11 @@ class Upsample : public UpsampleBase, public OpKernel {
 
   Status BaseCompute(OpKernelContext* context, gsl::span<const float> roi, gsl::span<const float> scales,
                      gsl::span<const int64_t> output_dims) const;
+
+ private:
+  // Coordinates and weights of the NCHW bilinear path, which only depend on the input and output shapes, the scales
+  // and the roi.
+  ShapePlanCache<BilinearParams> bilinear_plan_cache_;
 };
 
 BilinearParams SetupUpsampleBilinear(const int32_t input_height,
@@ -81,6 +87,7 @@ BilinearParams SetupUpsampleBilinear(const int32_t input_height,
                                      const GetOriginalCoordinateFunc& get_original_coordinate,
                                      const bool is_nchw);
 
+// p is the result of SetupUpsampleBilinear for the NCHW layout.
 template <typename T>
 void UpsampleBilinear(const int32_t batch_size,
                       const int32_t num_channels,
@@ -88,19 +95,12 @@ void UpsampleBilinear(const int32_t batch_size,
                       const int32_t input_width,
                       const int32_t output_height,
                       const int32_t output_width,
-                      const float height_scale,
-                      const float width_scale,
-                      gsl::span<const float> roi,
+                      const BilinearParams& p,
                       const bool use_extrapolation,
                       const float extrapolation_value,
                       const T* const XdataBase,
                       T* const YdataBase,
-                      AllocatorPtr& alloc,
-                      const GetOriginalCoordinateFunc& get_original_coordinate,
                       concurrency::ThreadPool* tp) {
-  BilinearParams p = SetupUpsampleBilinear(input_height, input_width, output_height, output_width,
-                                           height_scale, width_scale, roi,
-                                           alloc, get_original_coordinate, true);
   for (int32_t n = 0; n < batch_size; ++n) {
     concurrency::ThreadPool::TrySimpleParallelFor(
         tp, num_channels,
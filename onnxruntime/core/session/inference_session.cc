@@ -20,6 +20,7 @@
 #include "core/flatbuffers/flatbuffers_utils.h"
 #include "core/flatbuffers/ort_format_version.h"
 #include "core/framework/bfc_arena.h"
+#include "core/framework/captured_cpu_graph.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/feeds_fetches_manager.h"
@@ -38,6 +39,7 @@
 #include "core/framework/utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
+#include "core/optimizer/activation_recompute.h"
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/layout_transformation/layout_transformation.h"
@@ -66,6 +68,7 @@
 #include "core/optimizer/stft_decomposition.h"
 #endif
 #include "core/session/environment.h"
+#include "core/session/run_completion_queue.h"
 #include "core/session/user_logging_sink.h"
 #include "core/session/IOBinding.h"
 #include "core/session/inference_session_utils.h"
@@ -470,6 +473,34 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
   }
 #endif
 
+#if !defined(ORT_MINIMAL_BUILD)
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryAwareExecutionOrder, "0") == "1") {
+    session_options_.execution_order = ExecutionOrder::MEMORY_AWARE;
+  }
+
+  // The recomputed values are scheduled through the node priorities, which the default order ignores.
+  const std::string activation_memory_budget =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigActivationMemoryBudget, "0");
+  ORT_ENFORCE(TryParseStringWithClassicLocale<int64_t>(activation_memory_budget, activation_memory_budget_),
+              "Invalid value for ", kOrtSessionOptionsConfigActivationMemoryBudget, ": ", activation_memory_budget);
+  if (activation_memory_budget_ > 0 && session_options_.execution_order == ExecutionOrder::DEFAULT) {
+    session_options_.execution_order = ExecutionOrder::PRIORITY_BASED;
+  }
+#endif
+
+#if !defined(ORT_NO_EXCEPTIONS)
+  // A replay detects an output shape depending on the data from the exception of the shape verification of the frame,
+  // so builds without exceptions always run the executor.
+  enable_cpu_graph_capture_ =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableCpuGraphCapture, "0") == "1";
+#endif
+
+  const std::string max_concurrent_async_runs =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMaxConcurrentAsyncRuns, "0");
+  ORT_ENFORCE(TryParseStringWithClassicLocale<int>(max_concurrent_async_runs, max_concurrent_async_runs_) &&
+                  max_concurrent_async_runs_ >= 0,
+              "Invalid value for ", kOrtSessionOptionsConfigMaxConcurrentAsyncRuns, ": ", max_concurrent_async_runs);
+
   bool set_denormal_as_zero =
       session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSetDenormalAsZero, "0") == "1";
 
@@ -515,6 +546,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, to.affinity_str)) {
           ORT_ENFORCE(!to.affinity_str.empty(), "Affinity string must not be empty");
         }
+        to.numa_aware =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpNumaAware, "0") == "1";
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
                                to.affinity_str.empty();
@@ -704,6 +737,12 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  {
+    // the submitted runs use the session
+    std::unique_lock<OrtMutex> lock(submitted_runs_mutex_);
+    submitted_runs_cv_.wait(lock, [this]() { return num_submitted_run_workers_ == 0; });
+  }
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -1330,6 +1369,12 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
   }
 #endif
 
+  // Recompute cheap activations to keep the estimated peak under the budget, once no other node will be added.
+  if (activation_memory_budget_ > 0) {
+    ActivationRecompute activation_recompute{activation_memory_budget_, session_options_.execution_order};
+    ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(activation_recompute, *session_logger_, graph));
+  }
+
   return Status::OK();
 }
 #endif  // !defined(ORT_MINIMAL_BUILD)
@@ -1854,8 +1899,17 @@ common::Status InferenceSession::Initialize() {
 #endif
 
       // apply any transformations to the main graph and any subgraphs
+      TimePoint transform_tp;
+      if (session_profiler_.IsEnabled()) {
+        transform_tp = session_profiler_.Start();
+      }
+
       ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, saving_ort_format));
 
+      if (session_profiler_.IsEnabled()) {
+        session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_transform", transform_tp);
+      }
+
       // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
       ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
 
@@ -2018,12 +2072,21 @@ common::Status InferenceSession::Initialize() {
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
     }
 
+    TimePoint finalize_tp;
+    if (session_profiler_.IsEnabled()) {
+      finalize_tp = session_profiler_.Start();
+    }
+
     ORT_RETURN_IF_ERROR_SESSIONID_(
         session_state_->FinalizeSessionState(model_location_, kernel_registry_manager_,
                                              // need to keep the initializers if saving the optimized model
                                              !saving_model,
                                              saving_ort_format));
 
+    if (session_profiler_.IsEnabled()) {
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "session_state_finalize", finalize_tp);
+    }
+
 #if !defined(ORT_MINIMAL_BUILD)
     if (saving_model) {
       if (session_state_->GetFuncMgr().NumFuncs() > 0) {
@@ -2136,6 +2199,10 @@ int InferenceSession::GetCurrentNumRuns() const {
   return current_num_runs_.load();
 }
 
+int InferenceSession::GetNumCpuGraphReplays() const {
+  return num_cpu_graph_replays_.load();
+}
+
 const std::vector<std::string>& InferenceSession::GetRegisteredProviderTypes() const {
   return execution_providers_.GetIds();
 }
@@ -2462,6 +2529,69 @@ struct ThreadPoolSpinningSwitch {
 };
 }  // namespace
 
+Status InferenceSession::TryReplayCpuGraph(const FeedsFetchesManager& feeds_fetches_manager,
+                                           gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                           const RunOptions& run_options, bool& replayed) {
+  replayed = false;
+  std::unique_lock<OrtMutex> lock(cpu_graph_mutex_, std::try_to_lock);
+  if (!lock.owns_lock() || cpu_graph_capture_disabled_) {
+    return Status::OK();
+  }
+
+  const auto& info = feeds_fetches_manager.GetFeedsFetchesInfo();
+  if (!captured_cpu_graph_) {
+    // The first run goes through the executor, which traces the memory pattern the captured graph then allocates from.
+    if (cpu_graph_runs_before_capture_++ == 0) {
+      return Status::OK();
+    }
+
+    if (!CapturedCpuGraph::IsSupported(*session_state_)) {
+      LOGS(*session_logger_, WARNING) << "CPU graph capture is enabled but the session has nodes that can't be "
+                                         "captured. All the runs go through the executor.";
+      cpu_graph_capture_disabled_ = true;
+      return Status::OK();
+    }
+
+    auto status = CapturedCpuGraph::Capture(*session_state_, info.feeds_mlvalue_idxs, feeds,
+                                            info.fetches_mlvalue_idxs, fetches, *session_logger_,
+                                            run_options.terminate, captured_cpu_graph_);
+    if (status.IsOK()) {
+      LOGS(*session_logger_, INFO) << "Captured the CPU graph of the session with "
+                                   << captured_cpu_graph_->NumKernelCalls() << " kernel calls.";
+      replayed = true;
+      return status;
+    }
+    if (run_options.terminate) {
+      replayed = true;
+      return status;
+    }
+    LOGS(*session_logger_, WARNING) << "CPU graph capture failed, all the runs go through the executor. "
+                                    << status.ErrorMessage();
+    cpu_graph_capture_disabled_ = true;
+    return Status::OK();
+  }
+
+  if (!captured_cpu_graph_->Matches(info.feeds_mlvalue_idxs, feeds, info.fetches_mlvalue_idxs)) {
+    return Status::OK();
+  }
+
+  auto status = captured_cpu_graph_->Replay(feeds, fetches, run_options.terminate);
+  if (status.IsOK() || run_options.terminate) {
+    if (status.IsOK()) {
+      ++num_cpu_graph_replays_;
+    }
+    replayed = true;
+    return status;
+  }
+
+  // e.g. a kernel whose output shape depends on the values of its inputs. The executor runs the graph again.
+  LOGS(*session_logger_, WARNING) << "Replaying the captured CPU graph failed, all the runs go through the executor. "
+                                  << status.ErrorMessage();
+  captured_cpu_graph_.reset();
+  cpu_graph_capture_disabled_ = true;
+  return Status::OK();
+}
+
 Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
@@ -2591,7 +2721,12 @@ Status InferenceSession::Run(const RunOptions& run_options,
       DeviceStreamCollectionHolder device_stream_collection_holder(session_state_.get());
 #endif
 
-      if (retval.IsOK()) {
+      bool replayed_cpu_graph = false;
+      if (retval.IsOK() && enable_cpu_graph_capture_) {
+        retval = TryReplayCpuGraph(feeds_fetches_manager, feeds, *p_fetches, run_options, replayed_cpu_graph);
+      }
+
+      if (retval.IsOK() && !replayed_cpu_graph) {
         retval = utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
                                      session_options_.execution_mode,
                                      run_options,
@@ -2781,6 +2916,94 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
   return Status::OK();
 }
 
+struct InferenceSession::SubmittedRun {
+  RunOptions run_options;
+  InlinedVector<std::string> feed_names;
+  InlinedVector<OrtValue> feeds;
+  InlinedVector<std::string> output_names;
+  RunCompletionQueue* completion_queue;
+  uint64_t tag;
+};
+
+common::Status InferenceSession::SubmitRun(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                           gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                           RunCompletionQueue& completion_queue, uint64_t tag) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  auto* tp = GetInterOpThreadPoolToUse();
+  if (tp == nullptr) {
+    tp = GetIntraOpThreadPoolToUse();
+  }
+  const int num_threads = concurrency::ThreadPool::DegreeOfParallelism(tp) - 1;
+  if (num_threads < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "inter op or intra op thread pool must have at least one thread for SubmitRun");
+  }
+
+  auto run = std::make_unique<SubmittedRun>();
+  run->run_options = run_options;
+  run->feed_names.assign(feed_names.begin(), feed_names.end());
+  run->feeds.assign(feeds.begin(), feeds.end());
+  run->output_names.assign(output_names.begin(), output_names.end());
+  run->completion_queue = &completion_queue;
+  run->tag = tag;
+  completion_queue.OnSubmit();
+
+  bool start_worker = false;
+  {
+    std::lock_guard<OrtMutex> lock(submitted_runs_mutex_);
+    submitted_runs_.push_back(std::move(run));
+    const int max_workers = max_concurrent_async_runs_ > 0 ? max_concurrent_async_runs_ : num_threads;
+    if (num_submitted_run_workers_ < max_workers) {
+      ++num_submitted_run_workers_;
+      start_worker = true;
+    }
+  }
+
+  // Otherwise one of the running workers picks it up.
+  if (start_worker) {
+    concurrency::ThreadPool::Schedule(tp, [this]() { ExecuteSubmittedRuns(); });
+  }
+  return Status::OK();
+}
+
+void InferenceSession::ExecuteSubmittedRuns() {
+  for (;;) {
+    std::unique_ptr<SubmittedRun> run;
+    {
+      std::lock_guard<OrtMutex> lock(submitted_runs_mutex_);
+      if (submitted_runs_.empty()) {
+        --num_submitted_run_workers_;
+        submitted_runs_cv_.notify_all();
+        return;
+      }
+      run = std::move(submitted_runs_.front());
+      submitted_runs_.pop_front();
+    }
+
+    RunCompletionQueue::Completion completion{run->tag, Status::OK(), {}};
+    ORT_TRY {
+      completion.status = Run(run->run_options, run->feed_names, run->feeds, run->output_names,
+                              &completion.fetches, nullptr);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        completion.status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+    ORT_CATCH(...) {
+      completion.status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "unknown exception");
+    }
+    if (!completion.status.IsOK()) {
+      completion.fetches.clear();
+    }
+    run->completion_queue->Complete(std::move(completion));
+  }
+}
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds, gsl::span<const std::string> output_names,
                                      std::vector<OrtValue>* p_fetches) {
   return Run(RunOptions(), feeds, output_names, p_fetches);
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <deque>
 #include <map>
 #include <optional>
 #include <string>
@@ -46,12 +47,14 @@ class ModelProto;
 }  // namespace ONNX_NAMESPACE
 
 namespace onnxruntime {  // forward declarations
+class CapturedCpuGraph;
 class CustomRegistry;
 class Environment;
 class GraphTransformer;
 class IExecutionProvider;
 class IOBinding;
 struct Notification;
+class RunCompletionQueue;
 
 #ifdef ENABLE_TRAINING
 struct PartialGraphExecutionState;
@@ -348,6 +351,19 @@ class InferenceSession {
                                         RunAsyncCallbackFn callback,
                                         void* user_data = nullptr);
 
+  /**
+   * Submits a run and returns without waiting for it. The run is executed by a thread of the inter-op thread pool,
+   * or of the intra-op one when the session has no inter-op thread pool, and its result is posted to the completion
+   * queue with the tag. A single thread can keep many runs in flight this way, see RunCompletionQueue.
+   * At most session.max_concurrent_async_runs runs of the session execute at the same time, the others wait in the
+   * order they were submitted. Destroying the session waits for the submitted runs.
+   * @param run_options Copied. Setting terminate on the caller's RunOptions has no effect on the submitted run.
+   * @param feeds Referenced by the run until it completes.
+   */
+  [[nodiscard]] common::Status SubmitRun(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                         gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                         RunCompletionQueue& completion_queue, uint64_t tag);
+
   /**
    * Run a pre-loaded and pre-intialized model.
    * Multiple threads are allowed to run this function; hence its thread-safe.
@@ -438,6 +454,12 @@ class InferenceSession {
    */
   int GetCurrentNumRuns() const;
 
+  /**
+   * Get the number of Run calls served by replaying the captured CPU graph, see
+   * kOrtSessionOptionsConfigEnableCpuGraphCapture. The run that captures the graph is not counted.
+   */
+  int GetNumCpuGraphReplays() const;
+
   /**
    * Get the names of registered Execution Providers. The returned vector is ordered by Execution Provider
    * priority. The first provider in the vector has the highest priority.
@@ -690,6 +712,13 @@ class InferenceSession {
    */
   void ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_to_shrink);
 
+  /**
+   * Replays the captured CPU graph when the run matches it, capturing it first once a run traced the memory pattern.
+   * @param replayed Set to false when the run has to go through the executor.
+   */
+  common::Status TryReplayCpuGraph(const FeedsFetchesManager& feeds_fetches_manager, gsl::span<const OrtValue> feeds,
+                                   std::vector<OrtValue>& fetches, const RunOptions& run_options, bool& replayed);
+
 #ifdef _WIN32
   void LogAllSessions();
 #endif
@@ -767,6 +796,9 @@ class InferenceSession {
 
 #if !defined(ORT_MINIMAL_BUILD)
   std::list<std::shared_ptr<onnxruntime::IOnnxRuntimeOpSchemaCollection>> custom_schema_registries_;
+
+  // Budget for the estimated peak size of the intermediate tensors, from the session configuration. 0 disables it.
+  int64_t activation_memory_budget_ = 0;
 #endif
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_MINIMAL_BUILD_CUSTOM_OPS)
@@ -787,6 +819,17 @@ class InferenceSession {
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_ = 0;
 
+  // Runs submitted with SubmitRun waiting for a thread. Up to max_concurrent_async_runs_ tasks of the thread pool
+  // execute them one after the other, until none is left.
+  struct SubmittedRun;
+  void ExecuteSubmittedRuns();
+  OrtMutex submitted_runs_mutex_;
+  OrtCondVar submitted_runs_cv_;
+  std::deque<std::unique_ptr<SubmittedRun>> submitted_runs_;  // GUARDED_BY(submitted_runs_mutex_)
+  int num_submitted_run_workers_ = 0;                         // GUARDED_BY(submitted_runs_mutex_)
+  // From the session configuration, 0 for the number of threads of the pool executing the runs.
+  int max_concurrent_async_runs_ = 0;
+
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
@@ -897,6 +940,15 @@ class InferenceSession {
   };
 
   CachedExecutionProviderForGraphReplay cached_execution_provider_for_graph_replay_;
+
+  // CPU graph capture, enabled from the session configuration. Declared after session_state_ as the captured graph
+  // refers to its kernels. A Run finding the captured graph in use by another one goes through the executor.
+  bool enable_cpu_graph_capture_ = false;
+  OrtMutex cpu_graph_mutex_;
+  int cpu_graph_runs_before_capture_ = 0;                 // GUARDED_BY(cpu_graph_mutex_)
+  bool cpu_graph_capture_disabled_ = false;               // GUARDED_BY(cpu_graph_mutex_)
+  std::unique_ptr<CapturedCpuGraph> captured_cpu_graph_;  // GUARDED_BY(cpu_graph_mutex_)
+  std::atomic<int> num_cpu_graph_replays_ = 0;
 };
 
 struct SessionIOBinding {
@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/run_completion_queue.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+
+RunCompletionQueue::~RunCompletionQueue() {
+  // the runs still in flight complete into this queue
+  std::unique_lock<OrtMutex> lock(mutex_);
+  completed_cv_.wait(lock, [this]() { return num_running_ == 0; });
+}
+
+void RunCompletionQueue::OnSubmit() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  ++num_in_flight_;
+  ++num_running_;
+}
+
+void RunCompletionQueue::Complete(Completion&& completion) {
+  // notify while holding the lock: once num_running_ is 0 the destructor may return and destroy completed_cv_
+  std::lock_guard<OrtMutex> lock(mutex_);
+  completed_.push_back(std::move(completion));
+  --num_running_;
+  completed_cv_.notify_all();
+}
+
+size_t RunCompletionQueue::MoveCompletions(std::vector<Completion>& completions, size_t max_completions) {
+  const size_t count = std::min(max_completions, completed_.size());
+  for (size_t i = 0; i < count; ++i) {
+    completions.push_back(std::move(completed_.front()));
+    completed_.pop_front();
+  }
+  num_in_flight_ -= count;
+  return count;
+}
+
+size_t RunCompletionQueue::Poll(std::vector<Completion>& completions, size_t max_completions) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return MoveCompletions(completions, max_completions);
+}
+
+size_t RunCompletionQueue::Wait(std::vector<Completion>& completions, size_t max_completions,
+                                std::chrono::milliseconds timeout) {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  auto has_completion_or_idle = [this]() { return !completed_.empty() || num_running_ == 0; };
+  if (timeout == std::chrono::milliseconds::max()) {
+    completed_cv_.wait(lock, has_completion_or_idle);
+  } else {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!has_completion_or_idle()) {
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        break;
+      }
+      completed_cv_.wait_for(lock, deadline - now);
+    }
+  }
+  return MoveCompletions(completions, max_completions);
+}
+
+size_t RunCompletionQueue::NumInFlight() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return num_in_flight_;
+}
+
+}  // namespace onnxruntime
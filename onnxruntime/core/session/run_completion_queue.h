@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Collects the results of the runs submitted with InferenceSession::SubmitRun, so that a single caller thread can
+ * keep many runs in flight and pick up their results as they complete.
+ * Usage is as follows:
+ *
+ * RunCompletionQueue queue;
+ * session.SubmitRun(run_options, feed_names, feeds, output_names, queue, tag);
+ * ...
+ * std::vector<RunCompletionQueue::Completion> completions;
+ * while (queue.NumInFlight() > 0) {
+ *   queue.Wait(completions);
+ *   for (auto& completion : completions) { ... completion.tag, completion.status, completion.fetches ... }
+ *   completions.clear();
+ * }
+ *
+ * A queue can collect the runs of several sessions. Destroying it waits for the runs submitted to it to complete.
+ * All the methods are thread-safe.
+ */
+class RunCompletionQueue {
+ public:
+  struct Completion {
+    uint64_t tag;  // as passed to SubmitRun
+    Status status;
+    std::vector<OrtValue> fetches;  // empty if the run failed
+  };
+
+  static constexpr size_t kAllCompletions = std::numeric_limits<size_t>::max();
+
+  RunCompletionQueue() = default;
+  ~RunCompletionQueue();
+
+  /**
+   * Moves up to max_completions completed runs, in completion order, to the end of completions without blocking.
+   * @return The number of completions added.
+   */
+  size_t Poll(std::vector<Completion>& completions, size_t max_completions = kAllCompletions);
+
+  /**
+   * Like Poll, but first blocks until a submitted run completes or the timeout expires.
+   * Does not block when all the submitted runs have completed.
+   */
+  size_t Wait(std::vector<Completion>& completions, size_t max_completions = kAllCompletions,
+              std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+  /** Number of runs submitted and not yet returned by Poll or Wait, completed or not. */
+  size_t NumInFlight() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunCompletionQueue);
+
+  friend class InferenceSession;
+
+  void OnSubmit();
+  void Complete(Completion&& completion);
+
+  size_t MoveCompletions(std::vector<Completion>& completions, size_t max_completions);  // GUARDED_BY(mutex_)
+
+  mutable OrtMutex mutex_;
+  OrtCondVar completed_cv_;
+  std::deque<Completion> completed_;  // GUARDED_BY(mutex_)
+  size_t num_in_flight_ = 0;          // GUARDED_BY(mutex_)
+  size_t num_running_ = 0;            // GUARDED_BY(mutex_)
+};
+
+}  // namespace onnxruntime
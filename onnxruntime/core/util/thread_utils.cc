@@ -9,8 +9,10 @@
 #include <Windows.h>
 #include <versionhelpers.h>
 #endif
+#include <fstream>
 #include <thread>
 #include "core/session/ort_apis.h"
+#include "core/common/parse_string.h"
 #include "core/common/string_utils.h"
 #include "core/common/logging/logging.h"
 
@@ -24,6 +26,7 @@ std::ostream& operator<<(std::ostream& os, const OrtThreadPoolParams& params) {
   os << " affinity_str: " << params.affinity_str;
   // os << " name: " << (params.name ? params.name : L"nullptr");
   os << " set_denormal_as_zero: " << params.set_denormal_as_zero;
+  os << " numa_aware: " << params.numa_aware;
   // os << " custom_create_thread_fn: " << (params.custom_create_thread_fn ? "set" : "nullptr");
   // os << " custom_thread_creation_options: " << (params.custom_thread_creation_options ? "set" : "nullptr");
   // os << " custom_join_thread_fn: " << (params.custom_join_thread_fn ? "set" : "nullptr");
@@ -87,6 +90,70 @@ static std::vector<LogicalProcessors> ReadThreadAffinityConfig(const std::string
   }
   ORT_THROW("Failed to read affinities from affinity string");
 }
+
+// Return the NUMA node of a logical processor, or -1 if it cannot be determined.
+static int GetNumaNodeOfProcessor(int processor_id) {
+#ifdef _WIN32
+  PROCESSOR_NUMBER processor_number{};
+  processor_number.Group = static_cast<WORD>(processor_id / 64);
+  processor_number.Number = static_cast<BYTE>(processor_id % 64);
+  USHORT node = 0;
+  if (GetNumaProcessorNodeEx(&processor_number, &node) && node != MAXUSHORT) {
+    return static_cast<int>(node);
+  }
+  return -1;
+#elif defined(__linux__)
+  // /sys/devices/system/node/node<N>/cpulist lists the processors of node N, e.g. "0-15,32-47"
+  constexpr int kMaxNumaNodes = 64;
+  for (int node = 0; node < kMaxNumaNodes; ++node) {
+    std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string line;
+    if (!cpulist || !std::getline(cpulist, line)) {
+      continue;
+    }
+    for (const auto& range : utils::SplitString(line, ",")) {
+      auto bounds = utils::SplitString(range, "-");
+      int from = 0, to = 0;
+      if (bounds.empty() ||
+          !TryParseStringWithClassicLocale(bounds.front(), from) ||
+          !TryParseStringWithClassicLocale(bounds.back(), to)) {
+        break;
+      }
+      if (processor_id >= from && processor_id <= to) {
+        return node;
+      }
+    }
+  }
+  return -1;
+#else
+  ORT_UNUSED_PARAMETER(processor_id);
+  return -1;
+#endif
+}
+
+// Derive the NUMA node of each thread from its affinity. A thread is attributed to the node of the first
+// processor it is bound to. Returns an empty vector if the node of any thread cannot be determined.
+static std::vector<int> ReadThreadNumaNodes(const std::vector<LogicalProcessors>& affinities) {
+  std::vector<int> numa_nodes;
+  numa_nodes.reserve(affinities.size());
+  // the first entry is the placeholder for the main thread, which has no affinity set by ORT
+  for (size_t i = 0; i < affinities.size(); ++i) {
+    if (i == 0 && affinities[i].empty()) {
+      numa_nodes.push_back(-1);
+      continue;
+    }
+    int node = affinities[i].empty() ? -1 : GetNumaNodeOfProcessor(affinities[i].front());
+    if (node < 0) {
+      return {};
+    }
+    numa_nodes.push_back(node);
+  }
+  // the main thread is not pinned by ORT; treat it as part of the first worker's node
+  if (numa_nodes.size() > 1 && numa_nodes[0] < 0) {
+    numa_nodes[0] = numa_nodes[1];
+  }
+  return numa_nodes;
+}
 #endif
 
 static std::unique_ptr<ThreadPool>
@@ -145,6 +212,27 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
 #endif
   }
 
+  if (options.numa_aware) {
+#if defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+    ORT_THROW("NUMA-aware thread pools are not implemented in this build.");
+#else
+    if (to.affinities.empty()) {
+      // NUMA grouping is only meaningful for pinned threads, so fall back to one thread per physical core
+      auto default_affinities = Env::Default().GetDefaultThreadAffinities();
+      if (default_affinities.size() >= static_cast<size_t>(options.thread_pool_size)) {
+        default_affinities.resize(static_cast<size_t>(options.thread_pool_size));
+        to.affinities = std::move(default_affinities);
+      }
+    }
+    to.numa_nodes = ReadThreadNumaNodes(to.affinities);
+    if (to.numa_nodes.size() != static_cast<size_t>(options.thread_pool_size)) {
+      LOGS_DEFAULT(WARNING) << "Unable to determine the NUMA node of every thread, "
+                            << "creating a thread pool that is not NUMA-aware";
+      to.numa_nodes.clear();
+    }
+#endif
+  }
+
   to.set_denormal_as_zero = options.set_denormal_as_zero;
   // set custom thread management members
   to.custom_create_thread_fn = options.custom_create_thread_fn;
@@ -42,6 +42,11 @@ struct OrtThreadPoolParams {
   // Set or unset denormal as zero
   bool set_denormal_as_zero = false;
 
+  // If it is true, the threads are grouped by the NUMA node of their affinity so that work stealing and
+  // loop partitioning prefer node-local threads. Thread affinities are required; if none are specified,
+  // the default per-physical-core affinities are used.
+  bool numa_aware = false;
+
   // members to manage custom threads
   OrtCustomCreateThreadFn custom_create_thread_fn = nullptr;
   void* custom_thread_creation_options = nullptr;
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Relu(a * b + c)
+TEST(FusedElementwiseTest, SameShape) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Mul", "Add", "Relu"});
+  test.AddAttribute<std::vector<int64_t>>("operands", {0, 1, 3, 2, 4, -1});
+  test.AddInput<float>("a", {2, 3}, {1.0f, -2.0f, 3.0f, -4.0f, 5.0f, -6.0f});
+  test.AddInput<float>("b", {2, 3}, {2.0f, 2.0f, 2.0f, 0.5f, 0.5f, 0.5f});
+  test.AddInput<float>("c", {2, 3}, {-1.0f, 1.0f, -7.0f, 3.0f, 0.0f, 4.0f});
+  test.AddOutput<float>("y", {2, 3}, {1.0f, 0.0f, 0.0f, 1.0f, 2.5f, 1.0f});
+  test.Run();
+}
+
+// x * sigmoid(x * scale + bias) - y with the rows longer than a tile, scale broadcast along the rows and bias
+// broadcast along the columns.
+TEST(FusedElementwiseTest, BroadcastAcrossTiles) {
+  constexpr int64_t rows = 3, columns = 1100;
+  std::vector<float> x(rows * columns), y(rows * columns), scale(columns), bias{-0.5f, 0.0f, 0.5f};
+  for (int64_t j = 0; j < columns; ++j) {
+    scale[j] = 0.001f * static_cast<float>(j % 50);
+  }
+  for (int64_t i = 0; i < rows * columns; ++i) {
+    x[i] = 0.01f * static_cast<float>(i % 200 - 100);
+    y[i] = 0.1f * static_cast<float>(i % 7);
+  }
+
+  std::vector<float> expected(rows * columns);
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t j = 0; j < columns; ++j) {
+      const float value = x[i * columns + j] * scale[j] + bias[i];
+      expected[i * columns + j] = x[i * columns + j] / (1.0f + std::exp(-value)) - y[i * columns + j];
+    }
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Mul", "Add", "Sigmoid", "Mul", "Sub"});
+  test.AddAttribute<std::vector<int64_t>>("operands", {0, 1, 4, 2, 5, -1, 0, 6, 7, 3});
+  test.AddInput<float>("x", {rows, columns}, x);
+  test.AddInput<float>("scale", {columns}, scale);
+  test.AddInput<float>("bias", {rows, 1}, bias);
+  test.AddInput<float>("y", {rows, columns}, y);
+  test.AddOutput<float>("z", {rows, columns}, expected);
+  test.Run();
+}
+
+// Only one input has the full shape, the output takes the broadcast shape of all of them.
+TEST(FusedElementwiseTest, OuterBroadcast) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Sub", "Abs", "Max"});
+  test.AddAttribute<std::vector<int64_t>>("operands", {0, 1, 3, -1, 4, 2});
+  test.AddInput<float>("a", {2, 1}, {1.0f, -1.0f});
+  test.AddInput<float>("b", {1, 3}, {0.0f, 1.0f, 2.0f});
+  test.AddInput<float>("c", {}, {0.5f});
+  test.AddOutput<float>("y", {2, 3}, {1.0f, 0.5f, 1.0f, 1.0f, 2.0f, 3.0f});
+  test.Run();
+}
+
+TEST(FusedElementwiseTest, InvalidOperands) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Neg", "Add"});
+  // the second step refers to its own result
+  test.AddAttribute<std::vector<int64_t>>("operands", {0, -1, 1, 2});
+  test.AddInput<float>("a", {2}, {1.0f, 2.0f});
+  test.AddOutput<float>("y", {2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Invalid operands for FusedElementwise step 1");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
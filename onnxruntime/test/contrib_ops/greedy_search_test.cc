@@ -2,9 +2,11 @@
 // Licensed under the MIT License.
 
 #include <memory>
+#include <string>
 #include <vector>
 #include "gtest/gtest.h"
 #include <gsl/gsl>
+#include "core/graph/model.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "test/common/cuda_op_test_utils.h"
 
@@ -183,5 +185,105 @@ TEST(GreedySearchTest, GptGreedySearchFp32) {
   }
 }
 
+namespace {
+
+// Runs a GPT GreedySearch or Sampling model on CPU with its eos_token_id attribute replaced and returns the sequences.
+std::vector<int32_t> RunGptGenerationOnCpu(const PathString& model_path, int64_t eos_token_id,
+                                           std::vector<int32_t> input_ids, int64_t batch_size, int32_t max_length) {
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ORT_THROW_IF_ERROR(Model::Load(model_path, model_proto));
+  for (auto& node : *model_proto.mutable_graph()->mutable_node()) {
+    for (auto& attribute : *node.mutable_attribute()) {
+      if (attribute.name() == "eos_token_id") {
+        attribute.set_i(eos_token_id);
+      }
+    }
+  }
+  std::string model_data;
+  model_proto.SerializeToString(&model_data);
+
+  std::vector<int64_t> input_ids_shape{batch_size, static_cast<int64_t>(input_ids.size()) / batch_size};
+  std::vector<int64_t> parameter_shape{1};
+  std::vector<int32_t> max_length_data{max_length};
+  std::vector<int32_t> min_length{1};
+  std::vector<float> repetition_penalty{1.0f};
+
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  std::vector<Ort::Value> ort_inputs;
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, input_ids.data(), input_ids.size(), input_ids_shape.data(),
+                                                input_ids_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, max_length_data.data(), max_length_data.size(),
+                                                parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, min_length.data(), min_length.size(), parameter_shape.data(),
+                                                parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(info, repetition_penalty.data(), repetition_penalty.size(),
+                                                parameter_shape.data(), parameter_shape.size()));
+  const char* input_names[] = {"input_ids", "max_length", "min_length", "repetition_penalty"};
+  const char* const output_names[] = {"sequences"};
+
+  Ort::SessionOptions session_options;
+  Ort::Session session(*ort_env, model_data.data(), model_data.size(), session_options);
+  auto ort_outputs = session.Run(Ort::RunOptions{}, input_names, ort_inputs.data(), ort_inputs.size(),
+                                 output_names, 1);
+
+  const auto* sequences = ort_outputs[0].GetTensorData<int32_t>();
+  return std::vector<int32_t>(sequences, sequences + batch_size * max_length);
+}
+
+// The sequences that meet EOS are evicted from the batch of the decoder subgraph on CPU. Makes the first token
+// generated for the first sequence EOS, so that it finishes after one step while the others keep going, and checks
+// that the sequences are the ones generated without eviction, up to EOS.
+void TestEvictFinishedSequences(const PathString& model_path, const std::vector<int32_t>& input_ids,
+                                int64_t batch_size, int32_t max_length) {
+  constexpr int64_t kEosTokenId = 98;  // eos_token_id and pad_token_id of the models
+  constexpr int32_t kPadTokenId = 98;
+  const int64_t sequence_length = static_cast<int64_t>(input_ids.size()) / batch_size;
+
+  const std::vector<int32_t> sequences = RunGptGenerationOnCpu(model_path, kEosTokenId, input_ids, batch_size,
+                                                               max_length);
+  const int32_t eos_token_id = sequences[static_cast<size_t>(sequence_length)];
+  ASSERT_NE(eos_token_id, kPadTokenId);
+
+  std::vector<int32_t> expected = sequences;
+  int64_t num_finished = 0;
+  for (int64_t b = 0; b < batch_size; ++b) {
+    bool finished = false;
+    for (int64_t i = sequence_length; i < max_length; ++i) {
+      int32_t& token = expected[static_cast<size_t>(b * max_length + i)];
+      finished = finished || token == eos_token_id;
+      if (finished) {
+        token = kPadTokenId;
+      }
+    }
+    num_finished += finished ? 1 : 0;
+  }
+  // some sequences are still generated once the first one is evicted
+  ASSERT_LT(num_finished, batch_size);
+
+  const std::vector<int32_t> evicted_sequences = RunGptGenerationOnCpu(model_path, eos_token_id, input_ids,
+                                                                       batch_size, max_length);
+  EXPECT_EQ(evicted_sequences, expected);
+}
+
+}  // namespace
+
+TEST(GreedySearchTest, GptGreedySearchEvictFinishedSequences) {
+  std::vector<int32_t> input_ids{
+      0, 0, 0, 52, 0, 0, 195, 731};
+
+  TestEvictFinishedSequences(ORT_TSTR("testdata/transformers/tiny_gpt2_greedysearch_with_init_decoder.onnx"),
+                             input_ids, 2, 10);
+}
+
+// Sampling runs on the GreedySearch implementation, with the finished sequences given zero logits.
+TEST(GreedySearchTest, GptSamplingEvictFinishedSequences) {
+  std::vector<int32_t> input_ids{
+      0, 0, 0, 0, 0, 52, 195, 731, 321, 301, 734, 620,
+      41, 554, 74, 622, 206, 222, 75, 223, 221, 198, 224, 572,
+      0, 0, 0, 52, 328, 219, 328, 206, 288, 227, 896, 328};
+
+  TestEvictFinishedSequences(ORT_TSTR("testdata/transformers/tiny_gpt2_sampling.onnx"), input_ids, 3, 15);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -414,7 +414,6 @@ TEST(MatMulNBits, Float16Large) {
 
 #endif  // defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DML)
 
-#if defined(ORT_NEURAL_SPEED)
 namespace {
 void RunSharedPrepackedWeightsTest(int64_t M, int64_t N, int64_t K, int block_size, bool is_asym,
                                    int64_t acc_lvl) {
@@ -583,7 +582,6 @@ TEST(MatMulNBits, SharedPrepackedWeights) {
   RunSharedPrepackedWeightsTest(2, 4096, 4096, 1024, false, 4);
   RunSharedPrepackedWeightsTest(2, 4096, 4096, 4096, false, 4);
 }
-#endif  // defined(ORT_NEURAL_SPEED)
 }  // namespace test
 }  // namespace onnxruntime
 
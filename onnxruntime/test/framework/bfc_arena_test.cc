@@ -6,7 +6,10 @@
 #include "core/framework/allocator_utils.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -481,5 +484,167 @@ TEST(BFCArenaTest, TestExtendStrategy) {
   ASSERT_EQ(extend_delta_bytes, extend_limit);
 }
 
+static std::unique_ptr<BFCArena> CreateArenaWithFrontCache(
+    int64_t front_cache_max_bytes,
+    ArenaExtendStrategy arena_extend_strategy = ArenaExtendStrategy::kNextPowerOfTwo) {
+  return std::make_unique<BFCArena>(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30,
+                                    arena_extend_strategy,
+                                    BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+                                    BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+                                    BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+                                    BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+                                    front_cache_max_bytes);
+}
+
+TEST(BFCArenaTest, FrontCacheReusesChunks) {
+  auto a = CreateArenaWithFrontCache(4096);
+
+  void* p1 = a->Alloc(100);
+  ASSERT_NE(p1, nullptr);
+  a->Free(p1);
+  // Same size class, so the parked chunk is handed out again.
+  void* p2 = a->Alloc(200);
+  EXPECT_EQ(p1, p2);
+  a->Free(p2);
+
+  // Larger than the cache limit, served by the bins.
+  void* p3 = a->Alloc(8192);
+  ASSERT_NE(p3, nullptr);
+  a->Free(p3);
+
+  AllocatorStats stats;
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.num_front_cache_hits, 1);
+  EXPECT_EQ(stats.num_front_cache_misses, 1);
+  // The parked chunk is in use from the point of view of the bins.
+  EXPECT_EQ(stats.bytes_in_use, 256);
+}
+
+TEST(BFCArenaTest, FrontCacheDisabledByDefault) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30);
+  void* p = a.Alloc(100);
+  a.Free(p);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_front_cache_hits, 0);
+  EXPECT_EQ(stats.num_front_cache_misses, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, FrontCacheFullSizeClassFallsBackToBins) {
+  auto a = CreateArenaWithFrontCache(1024);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 100; ++i) {
+    ptrs.push_back(a->Alloc(512));
+  }
+  for (void* p : ptrs) {
+    a->Free(p);
+  }
+
+  AllocatorStats stats;
+  a->GetStats(&stats);
+  // At most a bounded number of chunks stay parked, the rest went back to the bins.
+  EXPECT_GT(stats.bytes_in_use, 0);
+  EXPECT_LT(stats.bytes_in_use, 100 * 512);
+
+  // Every chunk can be allocated again.
+  ptrs.clear();
+  for (int i = 0; i < 100; ++i) {
+    ptrs.push_back(a->Alloc(512));
+  }
+  std::sort(ptrs.begin(), ptrs.end());
+  EXPECT_EQ(std::unique(ptrs.begin(), ptrs.end()), ptrs.end());
+  for (void* p : ptrs) {
+    a->Free(p);
+  }
+}
+
+TEST(BFCArenaTest, FrontCacheShrink) {
+  auto a = CreateArenaWithFrontCache(4096, ArenaExtendStrategy::kSameAsRequested);
+  void* p1k = a->Alloc(1024);
+  a->Free(p1k);
+
+  AllocatorStats stats;
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+
+  // Shrink returns the parked chunk to the bins, which frees the region.
+  EXPECT_EQ(a->Shrink(), Status::OK());
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_arena_shrinkages, 1);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+
+  // The chunk is no longer owned by the cache.
+  void* p = a->Alloc(1024);
+  ASSERT_NE(p, nullptr);
+  a->Free(p);
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.num_front_cache_hits, 0);
+  EXPECT_EQ(stats.num_front_cache_misses, 2);
+}
+
+TEST(BFCArenaTest, FrontCacheMultiThreaded) {
+  auto a = CreateArenaWithFrontCache(16 * 1024, ArenaExtendStrategy::kSameAsRequested);
+  constexpr int kNumThreads = 8;
+  constexpr int kNumIterations = 1000;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&a, t]() {
+      std::vector<std::pair<uint8_t*, size_t>> live;
+      for (int i = 0; i < kNumIterations; ++i) {
+        size_t size = 1 + static_cast<size_t>((i * 7919 + t * 104729) % (24 * 1024));
+        auto* p = static_cast<uint8_t*>(a->Alloc(size));
+        ASSERT_NE(p, nullptr);
+        // Tag the whole buffer, a chunk handed out twice would be overwritten by another thread.
+        std::memset(p, t, size);
+        live.emplace_back(p, size);
+        if (live.size() > 8 || (i % 3) == 0) {
+          auto [q, q_size] = live.front();
+          live.erase(live.begin());
+          for (size_t j = 0; j < q_size; ++j) {
+            ASSERT_EQ(q[j], static_cast<uint8_t>(t));
+          }
+          a->Free(q);
+        }
+      }
+      for (auto& [q, q_size] : live) {
+        a->Free(q);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  AllocatorStats stats;
+  a->GetStats(&stats);
+  EXPECT_GT(stats.num_front_cache_hits, 0);
+  EXPECT_EQ(a->Shrink(), Status::OK());
+  a->GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, FrontCacheFromArenaCfg) {
+  OrtArenaCfg config(0, -1, -1, -1, -1, -1);
+  config.front_cache_max_bytes = 1024;
+  AllocatorCreationInfo device_info{
+      [](OrtDevice::DeviceId) { return std::make_unique<CPUAllocator>(); },
+      0, true, config};
+  auto allocator = CreateAllocator(device_info);
+
+  void* p = allocator->Alloc(64);
+  allocator->Free(p);
+  EXPECT_EQ(allocator->Alloc(64), p);
+  allocator->Free(p);
+
+  AllocatorStats stats;
+  allocator->GetStats(&stats);
+  EXPECT_EQ(stats.num_front_cache_hits, 1);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -8,6 +8,7 @@
 #include "core/graph/model.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test_utils.h"
 #include "test/test_environment.h"
 #include "test/framework/TestAllocatorManager.h"
@@ -366,6 +367,119 @@ TEST_F(ExecutionFrameTest, MemPatternTest) {
   ASSERT_EQ(p->GetBlock(4)->offset_, kAllocAlignment);
 }
 
+TEST_F(ExecutionFrameTest, MemPatternShapeBucketTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 13;
+  onnxruntime::Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def("X", &tensor_float), relu1_out_def("T", &tensor_float),
+      relu2_out_def("Y", &tensor_float);
+
+  graph.AddNode("node1", "Relu", "relu1", ArgMap{&input_def}, ArgMap{&relu1_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "Relu", "relu2", ArgMap{&relu1_out_def}, ArgMap{&relu2_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistryManager kernel_registry_manager;
+
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(xp_type, std::move(cpu_xp)));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.enable_mem_reuse = true;
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigMemoryPatternShapeBucketing,
+                                                              "1"));
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigMemoryPatternMaxCacheSize,
+                                                              "1"));
+
+  SessionState state(graph, execution_providers, &tp_, nullptr, dtm,
+                     DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+
+  ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+  ASSERT_TRUE(state.GetMemoryPatternShapeBucketing());
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map(state.GetOrtValueNameIdxMap());
+  int x_idx = -1, t_idx = -1, y_idx = -1;
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("X", x_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("T", t_idx));
+  ASSERT_STATUS_OK(mlvalue_name_idx_map.GetIdx("Y", y_idx));
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->CreatePreferredAllocators()[0];
+
+  // Simulates a run with `x_rows` rows in the input, where the intermediate value has `t_rows` rows.
+  // Returns whether the frame had to trace a new pattern, and whether the cached one was too small.
+  auto run = [&](int64_t x_rows, int64_t t_rows, bool& traced, bool& too_small) {
+    OrtValue x_value;
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{x_rows, 64},
+                         std::vector<float>(static_cast<size_t>(x_rows * 64), 1.0f), &x_value);
+    std::vector<OrtValue> feeds{x_value};
+    std::vector<OrtValue> outputs;
+    ExecutionFrame frame(AsSpan({x_idx}), feeds, AsSpan({y_idx}), outputs, {},
+#ifdef ORT_ENABLE_STREAM
+                         {},
+#endif
+                         state);
+
+    OrtValue& t_value = *frame.GetMutableNodeInputOrOutputMLValue(t_idx);
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t_value, t_idx, DataTypeImpl::GetType<float>(),
+                                                              cpu_allocator->Info().device,
+                                                              TensorShape(std::vector<int64_t>{t_rows, 64})));
+    traced = frame.HasMemoryPatternPlanner();
+    too_small = frame.MemoryPatternsTooSmall();
+    if (traced) {
+      MemoryPatternGroup pattern;
+      ASSERT_STATUS_OK(frame.GeneratePatterns(pattern));
+      ASSERT_STATUS_OK(state.UpdateMemoryPatternGroupCache(feeds, std::move(pattern)));
+    } else if (too_small) {
+      state.MarkMemoryPatternGroupForUpdate(feeds);
+    }
+  };
+
+  bool traced = false, too_small = false;
+  run(3, 3, traced, too_small);
+  EXPECT_TRUE(traced);
+
+  // 4 rows is in the same bucket as 3 rows, and the smaller intermediate value fits the pattern.
+  run(4, 2, traced, too_small);
+  EXPECT_FALSE(traced);
+  EXPECT_FALSE(too_small);
+
+  // The larger intermediate value does not fit, so the next run of the bucket traces a larger pattern.
+  run(4, 4, traced, too_small);
+  EXPECT_FALSE(traced);
+  EXPECT_TRUE(too_small);
+  run(3, 4, traced, too_small);
+  EXPECT_TRUE(traced);
+  run(4, 4, traced, too_small);
+  EXPECT_FALSE(traced);
+  EXPECT_FALSE(too_small);
+  // The pattern did not shrink when it was traced again.
+  run(3, 3, traced, too_small);
+  EXPECT_FALSE(traced);
+  EXPECT_FALSE(too_small);
+
+  // 5 rows is in another bucket, which evicts the first one as the cache holds a single pattern.
+  run(5, 5, traced, too_small);
+  EXPECT_TRUE(traced);
+  run(6, 6, traced, too_small);
+  EXPECT_FALSE(traced);
+  run(3, 3, traced, too_small);
+  EXPECT_TRUE(traced);
+}
+
 #ifdef ENABLE_TRAINING
 TEST_F(ExecutionFrameTest, MemPatternWithExternalOutputsTest) {
   auto cpu_xp = CreateCPUExecutionProvider();
@@ -8,6 +8,7 @@
 #include <cfloat>
 #include <functional>
 #include <iterator>
+#include <numeric>
 #include <thread>
 #include <fstream>
 
@@ -47,6 +48,7 @@
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
+#include "core/session/run_completion_queue.h"
 #include "dummy_provider.h"
 #include "test_utils.h"
 #include "test/capturing_sink.h"
@@ -845,6 +847,208 @@ TEST(InferenceSessionTests, PreAllocateOutputVector) {
   RunModel(session_object, run_options, is_preallocate_output_vec);
 }
 
+#if !defined(ORT_NO_EXCEPTIONS)
+TEST(InferenceSessionTests, CpuGraphCapture) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.CpuGraphCapture";
+  InferenceSession reference_session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(reference_session.Load(MODEL_URI));
+  ASSERT_STATUS_OK(reference_session.Initialize());
+
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableCpuGraphCapture, "1"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto run = [](InferenceSession& session, const std::vector<int64_t>& dims, const std::vector<float>& values,
+                std::vector<OrtValue>& fetches) {
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, values, &ml_value);
+    NameMLValMap feeds{{"X", ml_value}};
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, std::vector<std::string>{"Y"}, &fetches));
+  };
+
+  // the first run traces the memory pattern, the second one captures, the next ones with the same shape replay
+  const std::vector<int64_t> dims = {3, 2};
+  for (int i = 0; i < 5; ++i) {
+    std::vector<float> values(6);
+    std::iota(values.begin(), values.end(), static_cast<float>(i));
+
+    std::vector<OrtValue> expected_fetches;
+    run(reference_session, dims, values, expected_fetches);
+    std::vector<OrtValue> fetches;
+    run(session_object, dims, values, fetches);
+
+    ASSERT_EQ(fetches.size(), 1u);
+    const auto& expected = expected_fetches[0].Get<Tensor>();
+    VerifyOutputs(fetches, dims, std::vector<float>(expected.Data<float>(), expected.Data<float>() + 6));
+  }
+
+  // pre-allocated fetches are filled by the replay
+  std::vector<OrtValue> fetches(1);
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, std::vector<float>(6),
+                       &fetches[0]);
+  run(session_object, dims, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, fetches);
+  VerifyOutputs(fetches, dims, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+
+  // the runs after the capturing one are replays
+  ASSERT_EQ(session_object.GetNumCpuGraphReplays(), 4);
+  ASSERT_EQ(reference_session.GetNumCpuGraphReplays(), 0);
+}
+
+TEST(InferenceSessionTests, CpuGraphCaptureDataDependentShape) {
+  onnxruntime::Model model("graph_nonzero", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 13}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  ONNX_NAMESPACE::TypeProto int64_tensor;
+  int64_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+
+  std::vector<onnxruntime::NodeArg*> inputs{&graph.GetOrCreateNodeArg("X", &float_tensor)};
+  std::vector<onnxruntime::NodeArg*> outputs{&graph.GetOrCreateNodeArg("Y", &int64_tensor)};
+  graph.AddNode("node_1", "NonZero", "node 1.", inputs, outputs);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.CpuGraphCaptureDataDependentShape";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableCpuGraphCapture, "1"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto run = [&session_object](const std::vector<float>& values, const std::vector<int64_t>& expected_indices) {
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {4}, values, &ml_value);
+    NameMLValMap feeds{{"X", ml_value}};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, std::vector<std::string>{"Y"}, &fetches));
+
+    ASSERT_EQ(fetches.size(), 1u);
+    const auto& output = fetches[0].Get<Tensor>();
+    ASSERT_EQ(output.Shape(), TensorShape({1, static_cast<int64_t>(expected_indices.size())}));
+    ASSERT_EQ(std::vector<int64_t>(output.Data<int64_t>(), output.Data<int64_t>() + expected_indices.size()),
+              expected_indices);
+  };
+
+  // traced, captured, then replayed with the same number of non-zero values
+  run({1.0f, 0.0f, 2.0f, 0.0f}, {0, 2});
+  run({0.0f, 3.0f, 0.0f, 4.0f}, {1, 3});
+  run({5.0f, 6.0f, 0.0f, 0.0f}, {0, 1});
+  ASSERT_EQ(session_object.GetNumCpuGraphReplays(), 1);
+
+  // the output shape changes, so the replay fails and the executor runs the graph, then all the next runs
+  run({1.0f, 2.0f, 3.0f, 0.0f}, {0, 1, 2});
+  run({0.0f, 0.0f, 0.0f, 7.0f}, {3});
+  run({1.0f, 0.0f, 2.0f, 0.0f}, {0, 2});
+  ASSERT_EQ(session_object.GetNumCpuGraphReplays(), 1);
+}
+
+TEST(InferenceSessionTests, CpuGraphCaptureSequenceValues) {
+  onnxruntime::Model model("graph_sequence", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 13}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  ONNX_NAMESPACE::TypeProto float_sequence;
+  float_sequence.mutable_sequence_type()->mutable_elem_type()->mutable_tensor_type()->set_elem_type(
+      ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+
+  // X is split into a sequence of its rows and concatenated back, Y is X
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& sequence_arg = graph.GetOrCreateNodeArg("S", &float_sequence);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  std::vector<onnxruntime::NodeArg*> inputs{&input_arg};
+  std::vector<onnxruntime::NodeArg*> outputs{&sequence_arg};
+  graph.AddNode("node_1", "SplitToSequence", "node 1.", inputs, outputs);
+  inputs = {&sequence_arg};
+  outputs = {&output_arg};
+  auto& concat_node = graph.AddNode("node_2", "ConcatFromSequence", "node 2.", inputs, outputs);
+  concat_node.AddAttribute("axis", static_cast<int64_t>(0));
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.CpuGraphCaptureSequenceValues";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableCpuGraphCapture, "1"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // a replay would hand the sequence of the previous run back to SplitToSequence, so every run uses the executor
+  const std::vector<int64_t> dims = {3, 2};
+  for (int i = 0; i < 5; ++i) {
+    std::vector<float> values(6);
+    std::iota(values.begin(), values.end(), static_cast<float>(i));
+
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, values, &ml_value);
+    NameMLValMap feeds{{"X", ml_value}};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, std::vector<std::string>{"Y"}, &fetches));
+    VerifyOutputs(fetches, dims, values);
+  }
+
+  ASSERT_EQ(session_object.GetNumCpuGraphReplays(), 0);
+}
+#endif  // !defined(ORT_NO_EXCEPTIONS)
+
+TEST(InferenceSessionTests, SubmitRunToCompletionQueue) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.SubmitRunToCompletionQueue";
+  so.intra_op_param.thread_pool_size = 3;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigMaxConcurrentAsyncRuns, "1"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const std::vector<int64_t> dims = {3, 2};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims,
+                       {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &ml_value);
+
+  RunCompletionQueue queue;
+  constexpr uint64_t kNumRuns = 16;
+  for (uint64_t tag = 0; tag < kNumRuns; ++tag) {
+    // the odd runs ask for an output the model doesn't have
+    const std::vector<std::string> output_names{tag % 2 ? "Z" : "Y"};
+    ASSERT_STATUS_OK(session_object.SubmitRun(RunOptions{}, std::vector<std::string>{"X"},
+                                              gsl::span<const OrtValue>(&ml_value, 1),
+                                              output_names, queue, tag));
+  }
+
+  std::vector<RunCompletionQueue::Completion> completions;
+  while (queue.NumInFlight() > 0) {
+    queue.Wait(completions);
+  }
+  ASSERT_EQ(completions.size(), kNumRuns);
+  EXPECT_EQ(queue.Wait(completions), 0u);
+
+  // a single run executes at a time, in submission order
+  for (uint64_t tag = 0; tag < kNumRuns; ++tag) {
+    const auto& completion = completions[tag];
+    ASSERT_EQ(completion.tag, tag);
+    if (tag % 2) {
+      EXPECT_FALSE(completion.status.IsOK());
+      EXPECT_TRUE(completion.fetches.empty());
+    } else {
+      ASSERT_STATUS_OK(completion.status);
+      VerifyOutputs(completion.fetches, dims, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+    }
+  }
+}
+
 TEST(InferenceSessionTests, ConfigureVerbosityLevel) {
   if constexpr (!SessionOptions::DEFAULT_USE_PER_SESSION_THREADS) {
     GTEST_SKIP() << "Skipping the test";
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_cost_estimator.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(OpCostEstimatorTest, MatMulAndGemm) {
+  const TensorShape a({2, 3, 4, 8}), b({8, 5}), y({2, 3, 4, 5});
+  const TensorShape* matmul_inputs[] = {&a, &b};
+  const TensorShape* matmul_outputs[] = {&y};
+  EXPECT_EQ(EstimateOpFlops("MatMul", matmul_inputs, matmul_outputs), 2 * 2 * 3 * 4 * 5 * 8);
+
+  // transposed A is KxM
+  const TensorShape gemm_a({8, 4}), gemm_b({8, 5}), gemm_c({5}), gemm_y({4, 5});
+  const TensorShape* gemm_inputs[] = {&gemm_a, &gemm_b, &gemm_c};
+  const TensorShape* gemm_outputs[] = {&gemm_y};
+  EXPECT_EQ(EstimateOpFlops("Gemm", gemm_inputs, gemm_outputs), 2 * 4 * 5 * 8);
+}
+
+TEST(OpCostEstimatorTest, Conv) {
+  // 2 groups of 4 input channels, 3x3 kernel
+  const TensorShape x({1, 8, 10, 10}), w({6, 4, 3, 3}), y({1, 6, 8, 8});
+  const TensorShape* conv_inputs[] = {&x, &w};
+  const TensorShape* conv_outputs[] = {&y};
+  EXPECT_EQ(EstimateOpFlops("Conv", conv_inputs, conv_outputs), 2 * 6 * 8 * 8 * 4 * 3 * 3);
+
+  const TensorShape* qlinear_conv_inputs[] = {&x, nullptr, nullptr, &w};
+  EXPECT_EQ(EstimateOpFlops("QLinearConv", qlinear_conv_inputs, conv_outputs), 2 * 6 * 8 * 8 * 4 * 3 * 3);
+
+  const TensorShape* conv_transpose_inputs[] = {&y, &w};
+  const TensorShape* conv_transpose_outputs[] = {&x};
+  EXPECT_EQ(EstimateOpFlops("ConvTranspose", conv_transpose_inputs, conv_transpose_outputs),
+            2 * 6 * 8 * 8 * 4 * 3 * 3);
+}
+
+TEST(OpCostEstimatorTest, ElementwiseAndReductions) {
+  const TensorShape x({4, 16}), bias({16}), reduced({4, 1});
+  const TensorShape* add_inputs[] = {&x, &bias};
+  const TensorShape* add_outputs[] = {&x};
+  EXPECT_EQ(EstimateOpFlops("Add", add_inputs, add_outputs), 64);
+
+  const TensorShape* reduce_inputs[] = {&x};
+  const TensorShape* reduce_outputs[] = {&reduced};
+  EXPECT_EQ(EstimateOpFlops("ReduceSum", reduce_inputs, reduce_outputs), 64);
+  EXPECT_EQ(EstimateOpFlops("Softmax", reduce_inputs, add_outputs), 5 * 64);
+}
+
+TEST(OpCostEstimatorTest, Unknown) {
+  const TensorShape x({4, 16});
+  const TensorShape* inputs[] = {&x};
+  const TensorShape* outputs[] = {&x};
+  EXPECT_EQ(EstimateOpFlops("Reshape", inputs, outputs), -1);
+  EXPECT_EQ(EstimateOpFlops("MatMul", inputs, {}), -1);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <absl/base/config.h>
 
@@ -344,6 +346,116 @@ TEST(SessionStateTest, TestInitializerMemoryAllocatedUsingNonArenaMemory) {
   }
 }
 
+// Test that initializers on CPU point to the memory mapped external data only if it is suitably aligned and
+// kOrtSessionOptionsMmapExternalInitializers is not disabled, and are copied into the arena otherwise.
+static const std::string kExternalInitializersFile = "session_state_test_external_initializers.bin";
+
+static void TestExternalInitializerMapping(bool mmap_external_initializers) {
+  const std::vector<float> values{1.f, 2.f, 3.f, 4.f};
+  const std::string& bin_file = kExternalInitializersFile;
+  const PathString model_file = ORT_TSTR("session_state_test_external_initializers.onnx");
+  // "aligned" at offset 0, "misaligned" at offset 18, which is not a multiple of sizeof(float)
+  constexpr int64_t kMisalignedOffset = 18;
+  {
+    std::vector<char> bytes(kMisalignedOffset + values.size() * sizeof(float));
+    memcpy(bytes.data(), values.data(), values.size() * sizeof(float));
+    memcpy(bytes.data() + kMisalignedOffset, values.data(), values.size() * sizeof(float));
+    std::ofstream out(bin_file, std::ios::binary);
+    out.write(bytes.data(), bytes.size());
+  }
+
+  onnxruntime::Model model("external_initializers", false, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  for (const auto& [name, offset] : {std::make_pair(std::string("aligned"), int64_t{0}),
+                                     std::make_pair(std::string("misaligned"), kMisalignedOffset)}) {
+    TensorProto tensor_proto;
+    tensor_proto.set_name(name);
+    tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+    tensor_proto.add_dims(4);
+    tensor_proto.set_data_location(TensorProto_DataLocation_EXTERNAL);
+    auto add_entry = [&tensor_proto](const std::string& key, const std::string& value) {
+      auto* entry = tensor_proto.add_external_data();
+      entry->set_key(key);
+      entry->set_value(value);
+    };
+    add_entry("location", bin_file);
+    add_entry("offset", std::to_string(offset));
+    add_entry("length", std::to_string(values.size() * sizeof(float)));
+    graph.AddInitializedTensor(tensor_proto);
+
+    auto& w = graph.GetOrCreateNodeArg(name, &float_tensor);
+    auto& y = graph.GetOrCreateNodeArg("Y_" + name, &float_tensor);
+    graph.AddNode("add_" + name, "Add", "", {&x, &w}, {&y});
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ExecutionProviders execution_providers;
+  CPUExecutionProviderInfo epi{true};  // use an arena-based allocator for this EP
+  ASSERT_STATUS_OK(execution_providers.Add(onnxruntime::kCpuExecutionProvider,
+                                           std::make_unique<CPUExecutionProvider>(epi)));
+
+  KernelRegistryManager krm;
+  ASSERT_STATUS_OK(krm.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsMmapExternalInitializers,
+                                                              mmap_external_initializers ? "1" : "0"));
+
+  SessionState session_state(graph, execution_providers, nullptr, nullptr, dtm,
+                             DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+
+  GraphPartitioner partitioner(krm, execution_providers);
+  ASSERT_STATUS_OK(partitioner.Partition(
+      graph, session_state.GetMutableFuncMgr(),
+      [](Graph& graph, bool& modified, const IExecutionProvider& execution_provider,
+         const layout_transformation::DebugGraphFn& debug_graph_fn) -> Status {
+        AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
+        return layout_transformation::TransformLayoutForEP(graph, modified, execution_provider,
+                                                           std::move(cpu_allocator), debug_graph_fn);
+      },
+      sess_options.config_options,
+      DefaultLoggingManager().DefaultLogger()));
+
+  ASSERT_STATUS_OK(session_state.FinalizeSessionState(model_file, krm));
+
+  const auto& name_to_idx = session_state.GetOrtValueNameIdxMap();
+  const auto& initialized_tensors = session_state.GetInitializedTensors();
+  for (const char* name : {"aligned", "misaligned"}) {
+    int idx;
+    ASSERT_STATUS_OK(name_to_idx.GetIdx(name, idx));
+    const Tensor& tensor = initialized_tensors.at(idx).Get<Tensor>();
+
+    const bool mapped = mmap_external_initializers && std::string(name) == "aligned";
+    EXPECT_EQ(tensor.Location().alloc_type, mapped ? OrtDeviceAllocator : OrtArenaAllocator) << name;
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(tensor.DataRaw()) % alignof(float), 0u) << name;
+    EXPECT_EQ(std::vector<float>(tensor.Data<float>().begin(), tensor.Data<float>().end()), values) << name;
+  }
+}
+
+TEST(SessionStateTest, TestExternalInitializersMappedWhenAligned) {
+  TestExternalInitializerMapping(true);
+  // the file is mapped until the session state is destroyed
+  std::filesystem::remove(kExternalInitializersFile);
+}
+
+TEST(SessionStateTest, TestExternalInitializersCopiedWhenMmapDisabled) {
+  TestExternalInitializerMapping(false);
+  std::filesystem::remove(kExternalInitializersFile);
+}
+
 #endif
 
 INSTANTIATE_TEST_SUITE_P(SessionStateTests, SessionStateTestP, testing::ValuesIn(param_list));
@@ -389,8 +501,24 @@ class PrePackingTestOpKernel : public OpKernel {
     return Status::OK();
   }
 
+  bool IsPrePackCacheable(int input_idx) const override {
+    return input_idx == 1;
+  }
+
+  Status UseCachedPrePackedBuffers(const Tensor& tensor, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx, /*out*/ bool& used_cached_buffers) override {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+
+    weight_packed_ = std::move(prepacked_buffers[0]);
+    used_cached_buffers = true;
+    ++use_cached_pre_packed_weight_calls_count;
+    return Status::OK();
+  }
+
   int prepack_calls_count = 0;
   int store_pre_packed_weight_calls_count = 0;
+  int use_cached_pre_packed_weight_calls_count = 0;
   IAllocatorUniquePtr<void> weight_packed_;
 };
 
@@ -526,6 +654,7 @@ static void PlaceAllNodesToCPUEP(Graph& graph) {
 struct PrepackingTestParam {
   bool test_subgraph;
   bool test_prepacking;
+  bool test_parallel_initialization = false;
 };
 
 class SessionStatePrepackingTest : public testing::TestWithParam<PrepackingTestParam> {};
@@ -567,6 +696,8 @@ TEST_P(SessionStatePrepackingTest, PrePackingTest) {
   sess_options.enable_mem_reuse = true;
   sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] =
       test_param.test_prepacking ? "0" : "1";
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigParallelInitialization] =
+      test_param.test_parallel_initialization ? "1" : "0";
 
   SessionState session_state(model.MainGraph(),
                              execution_providers,
@@ -597,6 +728,14 @@ TEST_P(SessionStatePrepackingTest, PrePackingTest) {
   const auto& const_initialized_tensors = session_state.GetConstantInitializedTensors();
   // check prepacking
   ASSERT_EQ(const_initialized_tensors.size(), size_t(test_param.test_prepacking ? 0 : 1));
+  if (test_param.test_prepacking && !test_param.test_subgraph) {
+    ASSERT_EQ(session_state.GetNumberOfPrepacksCounter(), size_t(1));
+  }
+
+  // the kernels are created whether the session state is initialized in parallel or not
+  for (const auto& node : model.MainGraph().Nodes()) {
+    ASSERT_NE(session_state.GetKernel(node.Index()), nullptr) << node.Name();
+  }
 }
 
 class SessionStateTestSharedInitalizersWithPrePacking : public ::testing::Test {
@@ -983,12 +1122,77 @@ TEST_F(SessionStateTestSharedInitalizersWithPrePacking, test4) {
   ASSERT_EQ(if_node_branches_shared_prepack_counter_2, static_cast<size_t>(2));
 }
 
+// Pre-packing enabled + persistent cache of pre-packed weights enabled =
+// pre-packed weights saved by the first session and used by the second one
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, PrepackedWeightsFileCache) {
+  const PathString model_path = ORT_TSTR("session_state_test_prepacked_weights_cache.onnx");
+  const PathString cache_path = model_path + ORT_TSTR(".prepacked");
+  {
+    // an invalid cache file is ignored and replaced
+    std::ofstream out(std::filesystem::path(cache_path), std::ios::binary);
+    out << "not a cache file";
+  }
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  // Enable pre-packing and the persistent cache
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+  sess_options.config_options.configurations[kOrtSessionOptionsEnablePrepackedWeightsCache] = "1";
+
+  for (int session = 0; session < 2; ++session) {
+    Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+
+    CreateSimpleGraph(model.MainGraph());
+    PlaceAllNodesToCPUEP(model.MainGraph());
+    SessionState session_state(model.MainGraph(),
+                               execution_providers,
+                               tp.get(),
+                               nullptr, /*inter_op_thread_pool*/
+                               dtm,
+                               DefaultLoggingManager().DefaultLogger(),
+                               profiler,
+                               sess_options);
+
+    ASSERT_STATUS_OK(session_state.FinalizeSessionState(model_path, kernel_registry_manager));
+
+    const auto* kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state.GetKernel(0));
+    ASSERT_EQ(session_state.GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+
+    if (session == 0) {
+      // Assert that the weight was pre-packed and written to the cache file
+      ASSERT_EQ(kernel->prepack_calls_count, 1);
+      ASSERT_EQ(kernel->use_cached_pre_packed_weight_calls_count, 0);
+      ASSERT_EQ(session_state.GetUsedCachedPrePackedWeightCounter(), static_cast<size_t>(0));
+      ASSERT_TRUE(std::filesystem::exists(cache_path));
+    } else {
+      // Assert that the pre-packed weight was read from the cache file instead
+      ASSERT_EQ(kernel->prepack_calls_count, 0);
+      ASSERT_EQ(kernel->use_cached_pre_packed_weight_calls_count, 1);
+      ASSERT_EQ(session_state.GetUsedCachedPrePackedWeightCounter(), static_cast<size_t>(1));
+    }
+
+    const float* weight_packed = static_cast<const float*>(kernel->weight_packed_.get());
+    ASSERT_EQ(weight_packed[0], 1.2345f);
+    ASSERT_EQ(weight_packed[1], 1.2345f * 2.f);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(weight_packed) % alignof(float), 0u);
+  }
+
+  std::filesystem::remove(cache_path);
+}
+
 INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                          SessionStatePrepackingTest,
                          testing::Values(PrepackingTestParam{false, false},
                                          PrepackingTestParam{false, true},
                                          PrepackingTestParam{true, false},
-                                         PrepackingTestParam{true, true}));
+                                         PrepackingTestParam{true, true},
+                                         PrepackingTestParam{false, true, true},
+                                         PrepackingTestParam{true, true, true}));
 #endif
 
 }  // namespace test
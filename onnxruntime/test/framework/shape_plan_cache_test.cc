@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shape_plan_cache.h"
+
+#include "gtest/gtest.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+struct SizePlan {
+  int64_t size = 0;
+};
+
+Status GetSizePlan(const ShapePlanCache<SizePlan>& cache, const TensorShape& shape, int& num_created,
+                   std::shared_ptr<const SizePlan>& plan) {
+  return cache.GetOrCreate(
+      ShapePlanKey().AddShape(&shape),
+      [&](SizePlan& new_plan) {
+        ++num_created;
+        new_plan.size = shape.Size();
+        return Status::OK();
+      },
+      plan);
+}
+
+}  // namespace
+
+TEST(ShapePlanCacheTest, ReusePlanForSameShapes) {
+  ShapePlanCache<SizePlan> cache;
+  int num_created = 0;
+  std::shared_ptr<const SizePlan> first, second;
+
+  ASSERT_STATUS_OK(GetSizePlan(cache, TensorShape({2, 3}), num_created, first));
+  ASSERT_STATUS_OK(GetSizePlan(cache, TensorShape({2, 3}), num_created, second));
+  EXPECT_EQ(num_created, 1);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(second->size, 6);
+
+  // same number of elements, other shape
+  ASSERT_STATUS_OK(GetSizePlan(cache, TensorShape({3, 2}), num_created, second));
+  EXPECT_EQ(num_created, 2);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(cache.Size(), 2u);
+}
+
+TEST(ShapePlanCacheTest, EvictLeastRecentlyUsed) {
+  ShapePlanCache<SizePlan> cache(2);
+  int num_created = 0;
+  std::shared_ptr<const SizePlan> plan;
+
+  ASSERT_STATUS_OK(GetSizePlan(cache, TensorShape({1}), num_created, plan));
+  ASSERT_STATUS_OK(GetSizePlan(cache, TensorShape({2}), num_created, plan));
+  // {1} becomes the most recently used, so {2} is evicted by {3}
+  ASSERT_STATUS_OK(GetSizePlan(cache, TensorShape({1}), num_created, plan));
+  ASSERT_STATUS_OK(GetSizePlan(cache, TensorShape({3}), num_created, plan));
+  EXPECT_EQ(num_created, 3);
+  EXPECT_EQ(cache.Size(), 2u);
+
+  ASSERT_STATUS_OK(GetSizePlan(cache, TensorShape({1}), num_created, plan));
+  EXPECT_EQ(num_created, 3);
+  ASSERT_STATUS_OK(GetSizePlan(cache, TensorShape({2}), num_created, plan));
+  EXPECT_EQ(num_created, 4);
+}
+
+TEST(ShapePlanCacheTest, FailedPlanIsNotCached) {
+  ShapePlanCache<SizePlan> cache;
+  std::shared_ptr<const SizePlan> plan;
+  const TensorShape shape({4});
+
+  auto failing_plan = [](SizePlan&) { return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid shape"); };
+  EXPECT_FALSE(cache.GetOrCreate(ShapePlanKey().AddShape(&shape), failing_plan, plan).IsOK());
+  EXPECT_EQ(cache.Size(), 0u);
+}
+
+TEST(ShapePlanCacheTest, KeyDistinguishesValues) {
+  const TensorShape shape({2, 2});
+  const float half[] = {0.5f}, one[] = {1.0f};
+  EXPECT_EQ(ShapePlanKey().AddShape(&shape).AddValues(gsl::make_span(half)),
+            ShapePlanKey().AddShape(&shape).AddValues(gsl::make_span(half)));
+  EXPECT_NE(ShapePlanKey().AddShape(&shape).AddValues(gsl::make_span(half)),
+            ShapePlanKey().AddShape(&shape).AddValues(gsl::make_span(one)));
+  // a missing optional input differs from a scalar
+  const TensorShape scalar({});
+  EXPECT_NE(ShapePlanKey().AddShape(nullptr), ShapePlanKey().AddShape(&scalar));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1154,6 +1154,73 @@ TEST_F(GraphTest, GraphConstruction_PriorityBasedTopologicalSort_MultiLayerRecom
   }
 }
 
+TEST_F(GraphTest, GraphConstruction_MemoryAwareTopologicalSort) {
+  Model model("graph_1", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  /*
+                                node_0 (Identity)
+                    /                 |                 \
+         expand_0 (large)     expand_1 (large)     expand_2 (large)
+                |                     |                  |
+         reduce_0 (small)     reduce_1 (small)     reduce_2 (small)
+                    \                 /                  |
+                     merge_0 (Merge)                     |
+                               \                         /
+                                      merge_1 (Merge)
+
+  Every large tensor should be consumed right after it is produced.
+  */
+
+  TypeProto tensor_small;
+  tensor_small.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  tensor_small.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  TypeProto tensor_large;
+  tensor_large.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  tensor_large.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1024);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("node_0_in_1", &tensor_small);
+  auto& output_arg0 = graph.GetOrCreateNodeArg("node_0_out_1", &tensor_small);
+  graph.AddNode("node_0", "Identity_Fake", "node 0", {&input_arg}, {&output_arg0});
+
+  std::vector<NodeArg*> reduced;
+  for (int i = 0; i < 3; ++i) {
+    const std::string suffix = std::to_string(i);
+    auto& large_arg = graph.GetOrCreateNodeArg("large_" + suffix, &tensor_large);
+    auto& small_arg = graph.GetOrCreateNodeArg("small_" + suffix, &tensor_small);
+    graph.AddNode("expand_" + suffix, "Identity_Fake", "expand", {&output_arg0}, {&large_arg});
+    graph.AddNode("reduce_" + suffix, "Identity_Fake", "reduce", {&large_arg}, {&small_arg});
+    reduced.push_back(&small_arg);
+  }
+
+  auto& merge_arg0 = graph.GetOrCreateNodeArg("merge_0_out_1", &tensor_small);
+  auto& merge_arg1 = graph.GetOrCreateNodeArg("merge_1_out_1", &tensor_small);
+  graph.AddNode("merge_0", "Merge_Fake", "merge 0", {reduced[0], reduced[1]}, {&merge_arg0});
+  graph.AddNode("merge_1", "Merge_Fake", "merge 1", {&merge_arg0, reduced[2]}, {&merge_arg1});
+
+  auto status = graph.Resolve();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  GraphViewer graph_viewer(graph);
+
+  auto& order = graph_viewer.GetNodesInTopologicalOrder(ExecutionOrder::MEMORY_AWARE);
+  ASSERT_EQ(order.size(), static_cast<size_t>(graph.NumberOfNodes()));
+  std::unordered_map<std::string, size_t> positions;
+  for (size_t i = 0; i < order.size(); ++i) {
+    positions[graph.GetNode(order[i])->Name()] = i;
+  }
+  EXPECT_EQ(positions["node_0"], 0u);
+  EXPECT_EQ(positions["merge_1"], order.size() - 1);
+  for (int i = 0; i < 3; ++i) {
+    const std::string suffix = std::to_string(i);
+    EXPECT_EQ(positions["reduce_" + suffix], positions["expand_" + suffix] + 1)
+        << "The large tensor of expand_" << suffix << " is kept alive while other nodes run.";
+  }
+  EXPECT_LT(positions["merge_0"], positions["merge_1"]);
+
+  // the order is computed once
+  EXPECT_EQ(&order, &graph_viewer.GetNodesInTopologicalOrder(ExecutionOrder::MEMORY_AWARE));
+}
+
 TEST_F(GraphTest, GraphConstruction_CheckGraphInputOutputOrderMaintained) {
   Model model("graph_1", false, *logger_);
   auto& graph = model.MainGraph();
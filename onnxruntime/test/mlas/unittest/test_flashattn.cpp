@@ -0,0 +1,159 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasFlashAttentionTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferKey;
+  MatrixGuardBuffer<float> BufferValue;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferScratch;
+  MLAS_THREADPOOL* threadpool_;
+
+  // Query is BxNxSxH, key and value are BxN_kvxTxH with kv_lengths[b] valid rows, output is BxSxNxH.
+  void ReferenceAttention(const float* Query, const float* Key, const float* Value, float* Output,
+                          int BatchSize, int NumHeads, int KvNumHeads, int QLength, int KvLength,
+                          const std::vector<int>& KvLengths, int HeadSize, float Scale, bool IsCausal) {
+    std::vector<double> scores(KvLength);
+    for (int b = 0; b < BatchSize; b++) {
+      const int kv_length = KvLengths[b];
+      const int causal_offset = (std::max)(kv_length - QLength, 0);
+      for (int n = 0; n < NumHeads; n++) {
+        const int kv_n = n / (NumHeads / KvNumHeads);
+        const float* k = Key + (static_cast<size_t>(b) * KvNumHeads + kv_n) * KvLength * HeadSize;
+        const float* v = Value + (static_cast<size_t>(b) * KvNumHeads + kv_n) * KvLength * HeadSize;
+        for (int s = 0; s < QLength; s++) {
+          const float* q = Query + ((static_cast<size_t>(b) * NumHeads + n) * QLength + s) * HeadSize;
+          const int end = IsCausal ? (std::min)(kv_length, s + causal_offset + 1) : kv_length;
+
+          double max_score = std::numeric_limits<double>::lowest();
+          for (int t = 0; t < end; t++) {
+            double dot = 0.0;
+            for (int h = 0; h < HeadSize; h++) {
+              dot += double(q[h]) * double(k[t * HeadSize + h]);
+            }
+            scores[t] = dot * Scale;
+            max_score = (std::max)(max_score, scores[t]);
+          }
+
+          double sum = 0.0;
+          for (int t = 0; t < end; t++) {
+            scores[t] = std::exp(scores[t] - max_score);
+            sum += scores[t];
+          }
+
+          float* o = Output + ((static_cast<size_t>(b) * QLength + s) * NumHeads + n) * HeadSize;
+          for (int h = 0; h < HeadSize; h++) {
+            double acc = 0.0;
+            for (int t = 0; t < end; t++) {
+              acc += scores[t] * double(v[t * HeadSize + h]);
+            }
+            o[h] = float(acc / sum);
+          }
+        }
+      }
+    }
+  }
+
+  void Test(int BatchSize, int NumHeads, int KvNumHeads, int QLength, int KvLength, int HeadSize,
+            bool IsCausal, bool VariableKvLengths, int BlockSize) {
+    const size_t query_size = static_cast<size_t>(BatchSize) * NumHeads * QLength * HeadSize;
+    const size_t kv_size = static_cast<size_t>(BatchSize) * KvNumHeads * KvLength * HeadSize;
+    float* Query = BufferQuery.GetBuffer(query_size);
+    float* Key = BufferKey.GetBuffer(kv_size);
+    float* Value = BufferValue.GetBuffer(kv_size);
+    float* Output = BufferOutput.GetBuffer(query_size);
+    float* OutputReference = BufferOutputReference.GetBuffer(query_size);
+
+    std::default_random_engine generator(static_cast<unsigned>(BatchSize * 131 + QLength * 17 + KvLength));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    for (size_t i = 0; i < query_size; i++) {
+      Query[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < kv_size; i++) {
+      Key[i] = distribution(generator);
+      Value[i] = distribution(generator);
+    }
+
+    std::vector<int> kv_lengths(BatchSize, KvLength);
+    if (VariableKvLengths) {
+      for (int b = 0; b < BatchSize; b++) {
+        kv_lengths[b] = 1 + (b * 7 + 3) % KvLength;
+      }
+    }
+
+    const float scale = 1.0f / std::sqrt(static_cast<float>(HeadSize));
+    ReferenceAttention(Query, Key, Value, OutputReference, BatchSize, NumHeads, KvNumHeads, QLength, KvLength,
+                       kv_lengths, HeadSize, scale, IsCausal);
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = BatchSize;
+    args.num_heads = NumHeads;
+    args.kv_num_heads = KvNumHeads;
+    args.q_sequence_length = QLength;
+    args.kv_sequence_length = KvLength;
+    args.kv_sequence_lengths = VariableKvLengths ? kv_lengths.data() : nullptr;
+    args.qk_head_size = HeadSize;
+    args.v_head_size = HeadSize;
+    args.q_block_size = (std::min)(BlockSize, QLength);
+    args.kv_block_size = (std::min)(BlockSize, KvLength);
+    args.scale = scale;
+    args.is_causal = IsCausal;
+    args.thread_count = threadpool_ != nullptr ? 4 : 1;
+    args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
+                                   static_cast<size_t>(args.q_block_size) * args.kv_block_size +
+                                   static_cast<size_t>(args.q_block_size) * HeadSize) *
+                                  sizeof(float);
+    args.buffer = BufferScratch.GetBuffer(args.buffer_size_per_thread / sizeof(float) * args.thread_count);
+    args.query = Query;
+    args.key = Key;
+    args.value = Value;
+    args.output = Output;
+
+    MlasFlashAttention(&args, threadpool_);
+
+    constexpr float AbsoluteTolerance = 1e-5f;
+    constexpr float RelativeTolerance = 1e-4f;
+    for (size_t i = 0; i < query_size; i++) {
+      float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[i]) * RelativeTolerance)
+          << "B:" << BatchSize << " N:" << NumHeads << " N_kv:" << KvNumHeads << " S:" << QLength
+          << " T:" << KvLength << " H:" << HeadSize << " causal:" << IsCausal << " block:" << BlockSize
+          << " @" << i << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "FlashAttention_Threaded" : "FlashAttention_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasFlashAttentionTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (bool is_causal : {false, true}) {
+      for (int block_size : {1, 5, 64}) {
+        Test(1, 2, 2, 17, 17, 16, is_causal, false, block_size);
+        Test(2, 8, 2, 13, 29, 32, is_causal, false, block_size);
+        Test(3, 4, 1, 1, 40, 8, is_causal, false, block_size);
+        Test(3, 4, 2, 23, 23, 16, is_causal, true, block_size);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
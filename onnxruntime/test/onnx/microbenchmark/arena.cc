@@ -0,0 +1,49 @@
+#include "core/framework/bfc_arena.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+using namespace onnxruntime;
+
+// Shared by all the threads of a run.  Created by thread 0 before the loop, the
+// benchmark library synchronizes the threads at the start of the loop.  The
+// arena of the previous run is released then too, when its threads are done.
+static std::unique_ptr<BFCArena> g_arena;
+
+// Small allocations from several threads at once, with up to 8 live buffers
+// per thread, as done by the kernels of a model running with intra-op
+// parallelism.  Arg 0 is the front cache limit in bytes (0 = no front cache).
+static void BM_BFCArenaSmallAllocFree(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    g_arena = std::make_unique<BFCArena>(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30,
+                                         ArenaExtendStrategy::kNextPowerOfTwo,
+                                         BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+                                         BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+                                         BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+                                         BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+                                         state.range(0));
+  }
+  constexpr size_t kNumLive = 8;
+  std::vector<void*> live(kNumLive, nullptr);
+  size_t i = static_cast<size_t>(state.thread_index());
+  for (auto _ : state) {
+    void*& p = live[i % kNumLive];
+    g_arena->Free(p);
+    p = g_arena->Alloc(64 + (i % 64) * 64);
+    benchmark::DoNotOptimize(p);
+    ++i;
+  }
+  for (void* p : live) {
+    g_arena->Free(p);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_BFCArenaSmallAllocFree)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kNanosecond)
+    ->Arg(0)
+    ->Arg(4096)
+    ->ThreadRange(1, 16);
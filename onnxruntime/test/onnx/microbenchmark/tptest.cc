@@ -4,6 +4,10 @@
 #include <core/session/onnxruntime_c_api.h>
 #include <core/platform/Barrier.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #ifdef _WIN32
 #include <Windows.h>
 #endif
@@ -132,6 +136,58 @@ BENCHMARK(BM_ThreadPoolSimpleParallelFor)
     ->Args({HALF_THREADS_PLUS_1, HALF_THREADS_PLUS_1, 1000})
     ->Args({NUM_THREADS, NUM_THREADS, 1000});
 
+// Scaling of a memory-bound ParallelFor when the pool's threads are
+// grouped into NUMA nodes.  Each thread is pinned to one logical
+// processor, and the processors are split into num_nodes contiguous
+// groups, which matches the usual socket layout.  On machines without
+// NUMA this simulates the topology through the affinity masks; with
+// num_nodes == 1 the pool is not NUMA-aware and serves as the baseline.
+// The buffer is first touched from within the pool so that, on real
+// NUMA hardware, its pages are placed on the node that later reads them.
+static void BM_ThreadPoolNumaParallelFor(benchmark::State& state) {
+  const int num_nodes = static_cast<int>(state.range(0));
+  const std::ptrdiff_t len = state.range(1);
+  constexpr std::ptrdiff_t kFloatsPerIteration = 1024;
+  const int num_processors = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  onnxruntime::ThreadOptions to;
+  for (int i = 0; i < NUM_THREADS; i++) {
+    to.affinities.push_back(onnxruntime::LogicalProcessors{i % num_processors});
+    if (num_nodes > 1) {
+      to.numa_nodes.push_back(i * num_nodes / NUM_THREADS);
+    }
+  }
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, NUM_THREADS, ALLOW_SPINNING);
+  std::unique_ptr<float[]> data(new float[len * kFloatsPerIteration]);
+  const TensorOpCost cost{static_cast<double>(kFloatsPerIteration * sizeof(float)), 0, static_cast<double>(kFloatsPerIteration)};
+  ThreadPool::TryParallelFor(tp.get(), len, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::fill(data.get() + first * kFloatsPerIteration, data.get() + last * kFloatsPerIteration, 1.0f);
+  });
+  std::atomic<float> total{0};
+  for (auto _ : state) {
+    ThreadPool::TryParallelFor(tp.get(), len, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      float sum = 0;
+      for (const float* p = data.get() + first * kFloatsPerIteration; p != data.get() + last * kFloatsPerIteration; ++p) {
+        sum += *p;
+      }
+      total.store(sum, std::memory_order_relaxed);
+    });
+  }
+  benchmark::DoNotOptimize(total.load());
+  state.SetBytesProcessed(state.iterations() * len * kFloatsPerIteration * static_cast<int64_t>(sizeof(float)));
+}
+BENCHMARK(BM_ThreadPoolNumaParallelFor)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 1024})
+    ->Args({2, 1024})
+    ->Args({4, 1024})
+    ->Args({1, 16384})
+    ->Args({2, 16384})
+    ->Args({4, 16384})
+    ->Args({1, 65536})
+    ->Args({2, 65536})
+    ->Args({4, 65536});
+
 static void BM_SimpleForLoop(benchmark::State& state) {
   const size_t len = state.range(0);
   for (auto _ : state) {
@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/activation_recompute.h"
+
+#include "gtest/gtest.h"
+
+#include "test/optimizer/graph_transform_test_builder.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime::test {
+
+namespace {
+
+// Sigmoid(X) is consumed by the first and the last node of a MatMul chain and stays alive across the chain.
+void BuildLongLivedActivation(ModelTestBuilder& builder) {
+  auto* input = builder.MakeInput<float>({64, 64}, -1.0f, 1.0f);
+  auto* weight = builder.MakeInitializer<float>({64, 64}, -0.1f, 0.1f);
+  auto* sigmoid_out = builder.MakeIntermediate();
+  auto* matmul1_out = builder.MakeIntermediate();
+  auto* matmul2_out = builder.MakeIntermediate();
+  auto* matmul3_out = builder.MakeIntermediate();
+  auto* output = builder.MakeOutput();
+
+  builder.AddNode("Sigmoid", {input}, {sigmoid_out});
+  builder.AddNode("MatMul", {sigmoid_out, weight}, {matmul1_out});
+  builder.AddNode("MatMul", {matmul1_out, weight}, {matmul2_out});
+  builder.AddNode("MatMul", {matmul2_out, weight}, {matmul3_out});
+  builder.AddNode("Sub", {matmul3_out, sigmoid_out}, {output});
+}
+
+Status CheckSigmoidIsRecomputed(const Graph& graph) {
+  const auto op_counts = CountOpsInGraph(graph);
+  ORT_RETURN_IF_NOT(OpCount(op_counts, "Sigmoid") == 2, "Expected 2 Sigmoid, got ", OpCount(op_counts, "Sigmoid"));
+
+  int num_recomputed = 0;
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "Sigmoid" && node.Name().find("_recompute") != std::string::npos) {
+      ORT_RETURN_IF_NOT(node.Priority() == static_cast<int>(ExecutionPriority::LOCAL_LOW),
+                        "The recomputed node must have a low priority.");
+      ORT_RETURN_IF_NOT(node.GetOutputEdgesCount() == 1 && node.OutputNodesBegin()->OpType() == "Sub",
+                        "The recomputed value must only feed the last consumer.");
+      ++num_recomputed;
+    }
+  }
+  ORT_RETURN_IF_NOT(num_recomputed == 1, "Expected 1 recomputed node, got ", num_recomputed);
+  return Status::OK();
+}
+
+}  // namespace
+
+TEST(ActivationRecomputeTests, RecomputeValueAliveAcrossPeak) {
+  EXPECT_STATUS_OK(TestGraphTransformer(
+      BuildLongLivedActivation,
+      13,
+      DefaultLoggingManager().DefaultLogger(),
+      std::make_unique<ActivationRecompute>(1, ExecutionOrder::PRIORITY_BASED),
+      TransformerLevel::Level1,
+      1,
+      {},
+      CheckSigmoidIsRecomputed));
+}
+
+TEST(ActivationRecomputeTests, NoRecomputeWithinBudget) {
+  auto check_graph = [](Graph& graph) {
+    ORT_RETURN_IF_NOT(OpCount(CountOpsInGraph(graph), "Sigmoid") == 1, "The graph must not change.");
+    return Status::OK();
+  };
+
+  EXPECT_STATUS_OK(TestGraphTransformer(
+      BuildLongLivedActivation,
+      13,
+      DefaultLoggingManager().DefaultLogger(),
+      std::make_unique<ActivationRecompute>(int64_t{1} << 30, ExecutionOrder::PRIORITY_BASED),
+      TransformerLevel::Level1,
+      1,
+      {},
+      check_graph));
+}
+
+TEST(ActivationRecomputeTests, RecomputeKeepsOutputs) {
+  auto check_session = [](InferenceSessionWrapper& session) {
+    ASSERT_STATUS_OK(CheckSigmoidIsRecomputed(session.GetGraph()));
+  };
+
+  TransformerTester(BuildLongLivedActivation,
+                    check_session,
+                    TransformerLevel::Default,
+                    TransformerLevel::Level1,
+                    13,
+                    0.0,
+                    0.0,
+                    std::make_unique<ActivationRecompute>(1, ExecutionOrder::PRIORITY_BASED),
+                    [](SessionOptions& session_options) {
+                      session_options.execution_order = ExecutionOrder::PRIORITY_BASED;
+                    });
+}
+
+}  // namespace onnxruntime::test
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "graph_transform_test_builder.h"
+
+#include "core/graph/graph.h"
+#include "core/optimizer/elementwise_chain_fusion.h"
+
+namespace onnxruntime {
+namespace test {
+
+#ifndef DISABLE_CONTRIB_OPS
+
+// (x * scale + bias) * sigmoid(x * scale + bias) - y, with broadcast scale and bias.
+TEST(ElementwiseChainFusionTests, FuseChainWithBroadcast) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* x_arg = builder.MakeInput<float>({2, 3, 40}, -3.f, 3.f);
+    auto* y_arg = builder.MakeInput<float>({2, 3, 40}, -3.f, 3.f);
+    auto* scale_arg = builder.MakeInitializer<float>({40}, -2.f, 2.f);
+    auto* bias_arg = builder.MakeInitializer<float>({3, 1}, -1.f, 1.f);
+    auto* mul_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* sigmoid_out = builder.MakeIntermediate();
+    auto* swish_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Mul", {x_arg, scale_arg}, {mul_out});
+    builder.AddNode("Add", {mul_out, bias_arg}, {add_out});
+    builder.AddNode("Sigmoid", {add_out}, {sigmoid_out});
+    builder.AddNode("Mul", {add_out, sigmoid_out}, {swish_out});
+    builder.AddNode("Sub", {swish_out, y_arg}, {output_arg});
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["Sigmoid"], 0);
+    EXPECT_EQ(op_to_count["Sub"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level3, 13,
+                    1e-5, 1e-5, std::make_unique<ElementwiseChainFusion>());
+}
+
+// An intermediate result consumed outside of the chain ends the chain.
+TEST(ElementwiseChainFusionTests, StopAtSharedIntermediate) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* x_arg = builder.MakeInput<float>({4, 16}, -3.f, 3.f);
+    auto* exp_out = builder.MakeIntermediate();
+    auto* neg_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+    auto* relu_output_arg = builder.MakeOutput();
+
+    builder.AddNode("Exp", {x_arg}, {exp_out});
+    builder.AddNode("Neg", {exp_out}, {neg_out});
+    builder.AddNode("Tanh", {neg_out}, {output_arg});
+    builder.AddNode("Relu", {exp_out}, {relu_output_arg});
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Exp"], 1);
+    EXPECT_EQ(op_to_count["Relu"], 1);
+    EXPECT_EQ(op_to_count["Neg"], 0);
+    EXPECT_EQ(op_to_count["Tanh"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level3, 13,
+                    1e-5, 1e-5, std::make_unique<ElementwiseChainFusion>());
+}
+
+#endif  // DISABLE_CONTRIB_OPS
+
+}  // namespace test
+}  // namespace onnxruntime
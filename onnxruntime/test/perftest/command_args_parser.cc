@@ -18,6 +18,8 @@
 #include <unistd.h>
 #endif
 
+#include <core/common/parse_string.h>
+#include <core/common/string_utils.h>
 #include <core/graph/constants.h>
 #include <core/platform/path_lib.h>
 #include <core/optimizer/graph_transformer_level.h>
@@ -37,6 +39,12 @@ namespace perftest {
       "\t-A: Disable memory arena\n"
       "\t-I: Generate tensor input binding (Free dimensions are treated as 1.)\n"
       "\t-c [parallel runs]: Specifies the (max) number of runs to invoke simultaneously. Default:1.\n"
+      "\t\tA comma separated list, e.g. 1,2,4,8, runs the test once per value.\n"
+      "\t-W [warmup_times]: Specifies the number of runs before the measured ones. Default:1.\n"
+      "\t-R [requests_per_second]: Runs an open loop test where the requests arrive at this fixed rate whether the previous\n"
+      "\t\tones completed or not, with at most 'parallel runs' requests running at once. The latency includes the time\n"
+      "\t\ta request waits before running. Default:0, a closed loop test starting a request when another one completes.\n"
+      "\t-j [json_file]: Writes the results of all the runs, including the latency percentiles, to a JSON file.\n"
       "\t-e [cpu|cuda|dnnl|tensorrt|openvino|dml|acl|nnapi|coreml|qnn|snpe|rocm|migraphx|xnnpack|vitisai]: Specifies the provider 'cpu','cuda','dnnl','tensorrt', "
       "'openvino', 'dml', 'acl', 'nnapi', 'coreml', 'qnn', 'snpe', 'rocm', 'migraphx', 'xnnpack' or 'vitisai'. "
       "Default:'cpu'.\n"
@@ -48,6 +56,7 @@ namespace perftest {
       "\t-S: Given random seed, to produce the same input data. This defaults to -1(no initialize).\n"
       "\t-v: Show verbose information.\n"
       "\t-x [intra_op_num_threads]: Sets the number of threads used to parallelize the execution within nodes, A value of 0 means ORT will pick a default. Must >=0.\n"
+      "\t\tA comma separated list, e.g. 1,2,4, creates a session and runs the test once per value.\n"
       "\t-y [inter_op_num_threads]: Sets the number of threads used to parallelize the execution of the graph (across nodes), A value of 0 means ORT will pick a default. Must >=0.\n"
       "\t-f [free_dimension_override]: Specifies a free dimension by name to override to a specific value for performance optimization. "
       "Syntax is [dimension_name:override_value]. override_value must > 0\n"
@@ -171,6 +180,20 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
   return true;
 }
 
+// Parses a value or a comma separated list of values, each value must be at least min_value.
+template <typename T>
+static bool ParseValueList(const std::string& list_string, T min_value, std::vector<T>& values) {
+  values.clear();
+  for (const auto& value_string : utils::SplitString(list_string, ",")) {
+    T value{};
+    if (!TryParseStringWithClassicLocale(value_string, value) || value < min_value) {
+      return false;
+    }
+    values.push_back(value);
+  }
+  return !values.empty();
+}
+
 static bool ParseSessionConfigs(const std::string& configs_string,
                                 std::unordered_map<std::string, std::string>& session_configs) {
   std::istringstream ss(configs_string);
@@ -206,7 +229,7 @@ static bool ParseSessionConfigs(const std::string& configs_string,
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:AMPIDZvhsqznl"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:W:R:j:AMPIDZvhsqznl"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -307,12 +330,17 @@ static bool ParseSessionConfigs(const std::string& configs_string,
       case 'v':
         test_config.run_config.f_verbose = true;
         break;
-      case 'x':
-        test_config.run_config.intra_op_num_threads = static_cast<int>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
-        if (test_config.run_config.intra_op_num_threads < 0) {
+      case 'x': {
+        std::vector<int> values;
+        if (!ParseValueList(ToUTF8String(optarg), 0, values)) {
           return false;
         }
+        test_config.run_config.intra_op_num_threads = values[0];
+        if (values.size() > 1) {
+          test_config.run_config.intra_op_num_threads_sweep = std::move(values);
+        }
         break;
+      }
       case 'y':
         test_config.run_config.inter_op_num_threads = static_cast<int>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
         if (test_config.run_config.inter_op_num_threads < 0) {
@@ -322,13 +350,31 @@ static bool ParseSessionConfigs(const std::string& configs_string,
       case 'P':
         test_config.run_config.execution_mode = ExecutionMode::ORT_PARALLEL;
         break;
-      case 'c':
-        test_config.run_config.concurrent_session_runs =
-            static_cast<size_t>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
-        if (test_config.run_config.concurrent_session_runs <= 0) {
+      case 'c': {
+        std::vector<size_t> values;
+        if (!ParseValueList(ToUTF8String(optarg), size_t{1}, values)) {
+          return false;
+        }
+        test_config.run_config.concurrent_session_runs = values[0];
+        if (values.size() > 1) {
+          test_config.run_config.concurrent_session_runs_sweep = std::move(values);
+        }
+        break;
+      }
+      case 'W':
+        if (!TryParseStringWithClassicLocale(ToUTF8String(optarg), test_config.run_config.warmup_times)) {
+          return false;
+        }
+        break;
+      case 'R':
+        if (!TryParseStringWithClassicLocale(ToUTF8String(optarg), test_config.run_config.request_rate) ||
+            test_config.run_config.request_rate <= 0) {
           return false;
         }
         break;
+      case 'j':
+        test_config.model_info.json_result_file_path = optarg;
+        break;
       case 'o': {
         int tmp = static_cast<int>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
         switch (tmp) {
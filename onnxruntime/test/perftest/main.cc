@@ -3,6 +3,8 @@
 
 // onnxruntime dependencies
 #include <core/session/onnxruntime_c_api.h>
+#include <fstream>
+#include <iostream>
 #include <random>
 #include "command_args_parser.h"
 #include "performance_runner.h"
@@ -42,21 +44,64 @@ int real_main(int argc, char* argv[]) {
       return -1;
   }
   std::random_device rd;
-  perftest::PerformanceRunner perf_runner(env, test_config, rd);
 
-  // Exit if user enabled -n option so that user can measure session creation time
-  if (test_config.run_config.exit_after_session_creation) {
-    perf_runner.LogSessionCreationTime();
-    return 0;
+  // A session is created for every intra op thread count, and the test runs for every concurrency on it.
+  const auto& run_config = test_config.run_config;
+  const std::vector<int> intra_op_num_threads_values =
+      run_config.intra_op_num_threads_sweep.empty() ? std::vector<int>{run_config.intra_op_num_threads}
+                                                    : run_config.intra_op_num_threads_sweep;
+  const std::vector<size_t> concurrent_session_runs_values =
+      run_config.concurrent_session_runs_sweep.empty() ? std::vector<size_t>{run_config.concurrent_session_runs}
+                                                       : run_config.concurrent_session_runs_sweep;
+
+  std::ofstream json_file;
+  if (!test_config.model_info.json_result_file_path.empty()) {
+    json_file.open(test_config.model_info.json_result_file_path, std::ofstream::out | std::ofstream::trunc);
+    if (!json_file.good()) {
+      fprintf(stderr, "failed to open JSON result file '%s'\n",
+              ToUTF8String(test_config.model_info.json_result_file_path).c_str());
+      return -1;
+    }
+    json_file << "[";
   }
 
-  auto status = perf_runner.Run();
-  if (!status.IsOK()) {
-    printf("Run failed:%s\n", status.ErrorMessage().c_str());
-    return -1;
+  bool first_result = true;
+  for (int intra_op_num_threads : intra_op_num_threads_values) {
+    perftest::PerformanceTestConfig sweep_config = test_config;
+    sweep_config.run_config.intra_op_num_threads = intra_op_num_threads;
+    perftest::PerformanceRunner perf_runner(env, sweep_config, rd);
+
+    // Exit if user enabled -n option so that user can measure session creation time
+    if (run_config.exit_after_session_creation) {
+      perf_runner.LogSessionCreationTime();
+      continue;
+    }
+
+    for (size_t concurrent_session_runs : concurrent_session_runs_values) {
+      if (intra_op_num_threads_values.size() > 1 || concurrent_session_runs_values.size() > 1) {
+        std::cout << "\nintra_op_num_threads: " << intra_op_num_threads
+                  << ", concurrent_session_runs: " << concurrent_session_runs << std::endl;
+      }
+
+      auto status = perf_runner.Run(concurrent_session_runs);
+      if (!status.IsOK()) {
+        printf("Run failed:%s\n", status.ErrorMessage().c_str());
+        return -1;
+      }
+
+      perf_runner.SerializeResult();
+
+      if (json_file.is_open()) {
+        json_file << (first_result ? "\n  " : ",\n  ");
+        perf_runner.DumpToJson(json_file);
+        first_result = false;
+      }
+    }
   }
 
-  perf_runner.SerializeResult();
+  if (json_file.is_open()) {
+    json_file << "\n]\n";
+  }
 
   return 0;
 }
@@ -7,7 +7,9 @@
 #endif
 
 #include "performance_runner.h"
+#include <cmath>
 #include <iostream>
+#include <thread>
 
 #include "TestCase.h"
 #include "utils.h"
@@ -82,24 +84,16 @@ void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, boo
 
   if (!time_costs.empty() && f_include_statistics) {
     std::vector<double> sorted_time = time_costs;
-
-    size_t total = sorted_time.size();
-    size_t n50 = static_cast<size_t>(total * 0.5);
-    size_t n90 = static_cast<size_t>(total * 0.9);
-    size_t n95 = static_cast<size_t>(total * 0.95);
-    size_t n99 = static_cast<size_t>(total * 0.99);
-    size_t n999 = static_cast<size_t>(total * 0.999);
-
     std::sort(sorted_time.begin(), sorted_time.end());
 
     auto output_stats = [&](std::ostream& ostream) {
-      ostream << "Min Latency: " << sorted_time[0] << " s\n";
-      ostream << "Max Latency: " << sorted_time[total - 1] << " s\n";
-      ostream << "P50 Latency: " << sorted_time[n50] << " s\n";
-      ostream << "P90 Latency: " << sorted_time[n90] << " s\n";
-      ostream << "P95 Latency: " << sorted_time[n95] << " s\n";
-      ostream << "P99 Latency: " << sorted_time[n99] << " s\n";
-      ostream << "P999 Latency: " << sorted_time[n999] << " s" << std::endl;
+      ostream << "Min Latency: " << sorted_time.front() << " s\n";
+      ostream << "Max Latency: " << sorted_time.back() << " s\n";
+      ostream << "P50 Latency: " << GetLatencyPercentile(sorted_time, 50) << " s\n";
+      ostream << "P90 Latency: " << GetLatencyPercentile(sorted_time, 90) << " s\n";
+      ostream << "P95 Latency: " << GetLatencyPercentile(sorted_time, 95) << " s\n";
+      ostream << "P99 Latency: " << GetLatencyPercentile(sorted_time, 99) << " s\n";
+      ostream << "P999 Latency: " << GetLatencyPercentile(sorted_time, 99.9) << " s" << std::endl;
     };
 
     if (have_file) {
@@ -111,35 +105,61 @@ void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, boo
   }
 }
 
+/*static*/ double PerformanceResult::GetLatencyPercentile(const std::vector<double>& sorted_time_costs,
+                                                        double percentile) {
+  if (sorted_time_costs.empty()) {
+    return 0.0;
+  }
+  const auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted_time_costs.size()));
+  return sorted_time_costs[std::clamp<size_t>(rank, 1, sorted_time_costs.size()) - 1];
+}
+
 void PerformanceRunner::LogSessionCreationTime() {
   std::chrono::duration<double> session_create_duration = session_create_end_ - session_create_start_;
   std::cout << "\nSession creation time cost: " << session_create_duration.count() << " s\n";
 }
 
 Status PerformanceRunner::Run() {
-  if (!Initialize()) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to initialize.");
+  if (!initialized_) {
+    if (!Initialize()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to initialize.");
+    }
+    initialized_ = true;
   }
 
+  // a previous run with another concurrency may have filled the result
+  performance_result_.time_costs.clear();
+  performance_result_.total_time_cost = 0;
+
   // warm up
-  initial_inference_result_.start = std::chrono::high_resolution_clock::now();
-  ORT_RETURN_IF_ERROR(RunOneIteration<true>());
-  initial_inference_result_.end = std::chrono::high_resolution_clock::now();
+  const size_t warmup_times = performance_test_config_.run_config.warmup_times;
+  for (size_t i = 0; i < warmup_times; ++i) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    ORT_RETURN_IF_ERROR(RunOneIteration<true>());
+    if (i == 0) {
+      initial_inference_result_.start = start;
+      initial_inference_result_.end = std::chrono::high_resolution_clock::now();
+    }
+  }
 
   // TODO: start profiling
   // if (!performance_test_config_.run_config.profile_file.empty())
   performance_result_.start = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (performance_test_config_.run_config.request_rate > 0) {
+    ORT_RETURN_IF_ERROR(RunOpenLoop());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end = std::chrono::high_resolution_clock::now();
 
@@ -255,6 +275,128 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::RunOpenLoop() {
+  const auto& run_config = performance_test_config_.run_config;
+
+  // One thread per request allowed to run at once. The requests arriving while all of them are busy wait in the
+  // queue of the threadpool, which is counted in their latency.
+  auto tpool = std::make_unique<DefaultThreadPoolType>(static_cast<int>(run_config.concurrent_session_runs));
+  std::atomic<int> counter{0};
+  OrtMutex m;
+  OrtCondVar cv;
+
+  using Clock = std::chrono::high_resolution_clock;
+  const std::chrono::duration<double> interval(1.0 / run_config.request_rate);
+  const std::chrono::duration<double> duration(static_cast<double>(run_config.duration_in_seconds));
+  const auto start = Clock::now();
+  for (size_t i = 0;; ++i) {
+    const auto offset = interval * static_cast<double>(i);
+    if (run_config.test_mode == TestMode::KFixRepeatedTimesMode ? i >= run_config.repeated_times
+                                                                 : offset >= duration) {
+      break;
+    }
+
+    const auto arrival = start + std::chrono::duration_cast<Clock::duration>(offset);
+    std::this_thread::sleep_until(arrival);
+    counter++;
+    tpool->Schedule([this, arrival, &counter, &m, &cv]() {
+      auto status = RunOneIteration<false>(arrival);
+      if (!status.IsOK())
+        std::cerr << status.ErrorMessage();
+      // Simplified version of Eigen::Barrier
+      std::lock_guard<OrtMutex> lg(m);
+      counter--;
+      cv.notify_all();
+    });
+  }
+
+  // Join
+  std::unique_lock<OrtMutex> lock(m);
+  cv.wait(lock, [&counter]() { return counter == 0; });
+
+  return Status::OK();
+}
+
+// Writes the string as a JSON string literal, the model name may be a path with backslashes or quotes.
+static void WriteJsonString(std::ostream& ostream, const std::string& str) {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  ostream << '"';
+  for (const char c : str) {
+    switch (c) {
+      case '"':
+        ostream << "\\\"";
+        break;
+      case '\\':
+        ostream << "\\\\";
+        break;
+      case '\b':
+        ostream << "\\b";
+        break;
+      case '\f':
+        ostream << "\\f";
+        break;
+      case '\n':
+        ostream << "\\n";
+        break;
+      case '\r':
+        ostream << "\\r";
+        break;
+      case '\t':
+        ostream << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          ostream << "\\u00" << kHexDigits[(c >> 4) & 0xf] << kHexDigits[c & 0xf];
+        } else {
+          ostream << c;
+        }
+    }
+  }
+  ostream << '"';
+}
+
+void PerformanceRunner::DumpToJson(std::ostream& ostream) const {
+  const auto& run_config = performance_test_config_.run_config;
+  std::vector<double> sorted_time = performance_result_.time_costs;
+  std::sort(sorted_time.begin(), sorted_time.end());
+
+  const std::chrono::duration<double> session_create_duration = session_create_end_ - session_create_start_;
+  const std::chrono::duration<double> inference_duration = performance_result_.end - performance_result_.start;
+  const double average_latency =
+      sorted_time.empty() ? 0.0 : performance_result_.total_time_cost / static_cast<double>(sorted_time.size());
+  const double min_latency = sorted_time.empty() ? 0.0 : sorted_time.front();
+  const double max_latency = sorted_time.empty() ? 0.0 : sorted_time.back();
+
+  // latencies are in milliseconds
+  auto ms = [](double seconds) { return seconds * 1000.0; };
+  const auto precision = ostream.precision(9);
+  ostream << "{\"model\": ";
+  WriteJsonString(ostream, performance_result_.model_name);
+  ostream << ", "
+          << "\"mode\": \"" << (run_config.request_rate > 0 ? "open_loop" : "closed_loop") << "\", "
+          << "\"request_rate\": " << run_config.request_rate << ", "
+          << "\"concurrent_session_runs\": " << run_config.concurrent_session_runs << ", "
+          << "\"intra_op_num_threads\": " << run_config.intra_op_num_threads << ", "
+          << "\"inter_op_num_threads\": " << run_config.inter_op_num_threads << ", "
+          << "\"warmup_times\": " << run_config.warmup_times << ", "
+          << "\"session_creation_time_s\": " << session_create_duration.count() << ", "
+          << "\"requests\": " << sorted_time.size() << ", "
+          << "\"total_run_time_s\": " << inference_duration.count() << ", "
+          << "\"throughput\": " << sorted_time.size() / inference_duration.count() << ", "
+          << "\"latency_ms\": {"
+          << "\"avg\": " << ms(average_latency) << ", "
+          << "\"min\": " << ms(min_latency) << ", "
+          << "\"p50\": " << ms(PerformanceResult::GetLatencyPercentile(sorted_time, 50)) << ", "
+          << "\"p90\": " << ms(PerformanceResult::GetLatencyPercentile(sorted_time, 90)) << ", "
+          << "\"p95\": " << ms(PerformanceResult::GetLatencyPercentile(sorted_time, 95)) << ", "
+          << "\"p99\": " << ms(PerformanceResult::GetLatencyPercentile(sorted_time, 99)) << ", "
+          << "\"p999\": " << ms(PerformanceResult::GetLatencyPercentile(sorted_time, 99.9)) << ", "
+          << "\"max\": " << ms(max_latency) << "}, "
+          << "\"avg_cpu_usage\": " << performance_result_.average_CPU_usage << ", "
+          << "\"peak_workingset_size\": " << performance_result_.peak_workingset_size << "}";
+  ostream.precision(precision);
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   const auto& file_path = performance_test_config_.model_info.model_file_path;
 #if !defined(ORT_MINIMAL_BUILD)
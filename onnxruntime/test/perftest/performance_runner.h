@@ -10,6 +10,7 @@
 #include <iostream>
 #include <random>
 #include <chrono>
+#include <optional>
 // onnxruntime dependencies
 #include <core/common/common.h>
 #include <core/common/status.h>
@@ -37,6 +38,10 @@ struct PerformanceResult {
   std::string model_name;
 
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const;
+
+  // Latency in seconds below which the given percentage of the runs completed, using the nearest rank.
+  // sorted_time_costs is time_costs in ascending order.
+  static double GetLatencyPercentile(const std::vector<double>& sorted_time_costs, double percentile);
 };
 
 class PerformanceRunner {
@@ -46,6 +51,12 @@ class PerformanceRunner {
   ~PerformanceRunner();
   Status Run();
 
+  // Runs the test again with another number of concurrent runs, reusing the session.
+  Status Run(size_t concurrent_session_runs) {
+    performance_test_config_.run_config.concurrent_session_runs = concurrent_session_runs;
+    return Run();
+  }
+
   void LogSessionCreationTime();
 
   inline const PerformanceResult& GetResult() const { return performance_result_; }
@@ -54,13 +65,17 @@ class PerformanceRunner {
     performance_result_.DumpToFile(performance_test_config_.model_info.result_file_path,
                                    performance_test_config_.run_config.f_dump_statistics);
   }
+
+  // Writes the configuration and the result of the last run as a JSON object.
+  void DumpToJson(std::ostream& ostream) const;
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PerformanceRunner);
 
  private:
   bool Initialize();
 
+  // In the open loop mode, arrival is the time the request was issued and the latency includes the time it waited.
   template <bool isWarmup>
-  Status RunOneIteration() {
+  Status RunOneIteration(std::optional<std::chrono::high_resolution_clock::time_point> arrival = std::nullopt) {
     std::chrono::duration<double> duration_seconds(std::chrono::seconds(0));
 
     auto status = Status::OK();
@@ -74,6 +89,10 @@ class PerformanceRunner {
     }
     ORT_RETURN_IF_ERROR(status);
 
+    if (arrival.has_value()) {
+      duration_seconds = std::chrono::high_resolution_clock::now() - *arrival;
+    }
+
     if (!isWarmup) {
       std::lock_guard<OrtMutex> guard(results_mutex_);
       performance_result_.time_costs.emplace_back(duration_seconds.count());
@@ -90,6 +109,7 @@ class PerformanceRunner {
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status RunOpenLoop();
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -115,6 +135,7 @@ class PerformanceRunner {
   std::unique_ptr<TestSession> session_;
   onnxruntime::test::HeapBuffer b_;
   std::unique_ptr<ITestCase> test_case_;
+  bool initialized_{false};
 
   OrtMutex results_mutex_;
 };
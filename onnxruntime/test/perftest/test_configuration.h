@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "core/graph/constants.h"
 #include "core/framework/session_options.h"
@@ -29,6 +30,7 @@ struct ModelInfo {
   std::basic_string<ORTCHAR_T> model_file_path;
   std::basic_string<ORTCHAR_T> input_file_path;
   std::basic_string<ORTCHAR_T> result_file_path;
+  std::basic_string<ORTCHAR_T> json_result_file_path;
   bool load_via_path = false;
 };
 
@@ -43,6 +45,12 @@ struct RunConfig {
   size_t repeated_times{1000};
   size_t duration_in_seconds{600};
   size_t concurrent_session_runs{1};
+  size_t warmup_times{1};
+  // Arrival rate of the requests in the open loop mode, 0 runs the closed loop mode.
+  double request_rate{0};
+  // Values of concurrent_session_runs and intra_op_num_threads to sweep, empty to only run the configured one.
+  std::vector<size_t> concurrent_session_runs_sweep;
+  std::vector<int> intra_op_num_threads_sweep;
   bool f_dump_statistics{false};
   int random_seed_for_input_data{-1};
   bool f_verbose{false};
@@ -229,6 +229,45 @@ void TestStagedMultiLoopSections(const std::string& name, int num_threads, int n
   }
 }
 
+// Test loops and scheduling in a pool whose threads are grouped into
+// simulated NUMA nodes.  The nodes are assigned round-robin so that
+// node-local stealing and per-node loop sharding are exercised without
+// real NUMA hardware.
+void TestNumaAwareParallelFor(const std::string&, int num_threads, int num_nodes, int num_tasks) {
+  for (int rep = 0; rep < 5; rep++) {
+    onnxruntime::ThreadOptions thread_options;
+    for (int i = 0; i < num_threads; i++) {
+      thread_options.numa_nodes.push_back(i % num_nodes);
+    }
+    auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, num_threads, true);
+    auto test_data = CreateTestData(num_tasks);
+    ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+    ThreadPool::TryParallelFor(tp.get(), num_tasks, 1000.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; i++) {
+        IncrementElement(*test_data, i);
+      }
+    });
+    ThreadPool::TryBatchParallelFor(
+        tp.get(), num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); }, 0);
+    ValidateTestData(*test_data, 3);
+
+    std::atomic<int> ctr{0};
+    onnxruntime::Barrier b(num_tasks);
+    ThreadPool::Schedule(tp.get(), [&]() {
+      for (int t = 0; t < num_tasks; t++) {
+        ThreadPool::Schedule(tp.get(), [&]() {
+          ctr++;
+          b.Notify();
+        });
+      }
+    });
+    if (num_tasks > 0) {
+      b.Wait();
+    }
+    ASSERT_EQ(ctr, num_tasks);
+  }
+}
+
 }  // namespace
 
 namespace onnxruntime {
@@ -510,6 +549,22 @@ TEST(ThreadPoolTest, TestStagedMultiLoopSections_4Thread_100Loop) {
   TestStagedMultiLoopSections("TestStagedMultiLoopSections_4Thread_100Loop", 4, 100);
 }
 
+TEST(ThreadPoolTest, TestNumaAwareParallelFor_4Thread_2Node_1Task) {
+  TestNumaAwareParallelFor("TestNumaAwareParallelFor_4Thread_2Node_1Task", 4, 2, 1);
+}
+
+TEST(ThreadPoolTest, TestNumaAwareParallelFor_4Thread_2Node_1KTasks) {
+  TestNumaAwareParallelFor("TestNumaAwareParallelFor_4Thread_2Node_1KTasks", 4, 2, 1024);
+}
+
+TEST(ThreadPoolTest, TestNumaAwareParallelFor_8Thread_4Node_1KTasks) {
+  TestNumaAwareParallelFor("TestNumaAwareParallelFor_8Thread_4Node_1KTasks", 8, 4, 1024);
+}
+
+TEST(ThreadPoolTest, TestNumaAwareParallelFor_3Thread_1Node_1KTasks) {
+  TestNumaAwareParallelFor("TestNumaAwareParallelFor_3Thread_1Node_1KTasks", 3, 1, 1024);
+}
+
 #ifdef _WIN32
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
 #pragma warning(push)
@@ -2,13 +2,16 @@
 // Licensed under the MIT License.
 
 #include <future>
+#include <numeric>
 #include <thread>
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
 #include "core/common/logging/logging.h"
 #include "core/framework/session_state.h"
+#include "core/providers/cpu/controlflow/utils.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 #include "test/providers/provider_test_utils.h"
 #include "test/util/include/default_providers.h"
@@ -1042,6 +1045,351 @@ TEST(Loop, IterationCountAsOutput) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// the body passes cond and the loop carried var through, so no value flows between the iterations and they can run
+// concurrently.
+static void RunIndependentIterations(bool disable_concurrent_iterations) {
+  auto create_subgraph = []() {
+    Model model("Independent iterations subgraph", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    std::vector<NodeArg*> inputs;
+    std::vector<NodeArg*> outputs;
+
+    /* Inputs: iter_num, cond_in, loop carried state variables.
+
+         iter_num_in      cond_in      loop_var_0_in
+             |               |           |       |
+           [Cast]       [Identity]  [Identity]   |
+             |               |           |       |
+             |            cond_out  loop_var_0_out
+              \____________________________    |
+                                            [Add]
+                                              |
+                                         loop_out_0
+    */
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_scalar;
+    float_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    // graph inputs
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& loop_var_0_in = graph.GetOrCreateNodeArg("loop_var_0_in", &float_tensor);
+
+    // graph outputs
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    auto& loop_var_0_out = graph.GetOrCreateNodeArg("loop_var_0_out", &float_tensor);
+    auto& loop_out_0 = graph.GetOrCreateNodeArg("loop_out_0", &float_tensor);
+
+    // cond_in -> cond_out
+    {
+      inputs = {&cond_in};
+      outputs = {&cond_out};
+
+      graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", inputs, outputs);
+    }
+
+    // loop_var_0_in -> loop_var_0_out
+    {
+      inputs = {&loop_var_0_in};
+      outputs = {&loop_var_0_out};
+
+      graph.AddNode("loop_var_identity", "Identity", "Forward loop_var_0_in to loop_var_0_out", inputs, outputs);
+    }
+
+    // loop_var_0_in + iter_num_in -> loop_out_0
+    {
+      auto& iter_num_float = graph.GetOrCreateNodeArg("iter_num_float", &float_scalar);
+      inputs = {&iter_num_in};
+      outputs = {&iter_num_float};
+
+      auto& cast = graph.AddNode("iter_num_cast", "Cast", "Cast iter_num_in to float", inputs, outputs);
+      cast.AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+
+      inputs = {&loop_var_0_in, &iter_num_float};
+      outputs = {&loop_out_0};
+
+      graph.AddNode("add", "Add", "Add iter_num to loop_var_0_in", inputs, outputs);
+    }
+
+    graph.SetInputs({&iter_num_in, &cond_in, &loop_var_0_in});
+    graph.SetOutputs({&cond_out, &loop_var_0_out, &loop_out_0});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  constexpr int64_t num_iterations = 16;
+
+  OpTester test("Loop", 11);
+  auto body = create_subgraph();
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {num_iterations});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("loop_var_0_orig", {2}, {1.f, -1.f});
+
+  std::vector<float> loop_out_0;
+  for (int64_t i = 0; i < num_iterations; ++i) {
+    loop_out_0.push_back(1.f + static_cast<float>(i));
+    loop_out_0.push_back(-1.f + static_cast<float>(i));
+  }
+
+  test.AddOutput<float>("loop_var_0_final", {2}, {1.f, -1.f});
+  test.AddOutput<float>("loop_out_0_final", {num_iterations, 2}, loop_out_0);
+
+  SessionOptions so;
+  if (disable_concurrent_iterations) {
+    ORT_THROW_IF_ERROR(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDisableConcurrentSubgraphIterations,
+                                                        "1"));
+  }
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(Loop, IndependentIterations) {
+  RunIndependentIterations(false);
+}
+
+TEST(Loop, IndependentIterationsConcurrencyDisabled) {
+  RunIndependentIterations(true);
+}
+
+// the body outputs iter_num directly, so the subgraph feed is returned instead of the slice of the Loop output
+static void RunIndependentIterationsIterNumOutput(bool disable_concurrent_iterations) {
+  auto create_subgraph = []() {
+    Model model("Independent iterations iter_num output subgraph", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& loop_var_0_in = graph.GetOrCreateNodeArg("loop_var_0_in", &float_tensor);
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    auto& loop_var_0_out = graph.GetOrCreateNodeArg("loop_var_0_out", &float_tensor);
+
+    std::vector<NodeArg*> inputs = {&cond_in};
+    std::vector<NodeArg*> outputs = {&cond_out};
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", inputs, outputs);
+
+    inputs = {&loop_var_0_in};
+    outputs = {&loop_var_0_out};
+    graph.AddNode("loop_var_identity", "Identity", "Forward loop_var_0_in to loop_var_0_out", inputs, outputs);
+
+    graph.SetInputs({&iter_num_in, &cond_in, &loop_var_0_in});
+    graph.SetOutputs({&cond_out, &loop_var_0_out, &iter_num_in});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  constexpr int64_t num_iterations = 16;
+
+  OpTester test("Loop", 11);
+  auto body = create_subgraph();
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {num_iterations});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("loop_var_0_orig", {2}, {1.f, -1.f});
+
+  std::vector<int64_t> iter_nums(num_iterations);
+  std::iota(iter_nums.begin(), iter_nums.end(), int64_t{0});
+
+  test.AddOutput<float>("loop_var_0_final", {2}, {1.f, -1.f});
+  test.AddOutput<int64_t>("iter_num_final", {num_iterations, 1}, iter_nums);
+
+  SessionOptions so;
+  if (disable_concurrent_iterations) {
+    ORT_THROW_IF_ERROR(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDisableConcurrentSubgraphIterations,
+                                                        "1"));
+  }
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(Loop, IndependentIterationsIterNumOutput) {
+  RunIndependentIterationsIterNumOutput(false);
+}
+
+TEST(Loop, IndependentIterationsIterNumOutputConcurrencyDisabled) {
+  RunIndependentIterationsIterNumOutput(true);
+}
+
+// iterations of a body with random ops, whatever their domain, or with custom ops run sequentially
+TEST(Loop, IndependentIterationsOpDomains) {
+  auto can_execute_concurrently = [](const std::string& op_type, const std::string& domain) {
+    Model model("Op domain subgraph", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    std::vector<NodeArg*> inputs = {&graph.GetOrCreateNodeArg("x", &float_tensor)};
+    std::vector<NodeArg*> outputs = {&graph.GetOrCreateNodeArg("y", &float_tensor)};
+    auto& node = graph.AddNode("node", op_type, "Node of the body", inputs, outputs, nullptr, domain);
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+
+    return controlflow::detail::CanExecuteSubgraphConcurrently(graph);
+  };
+
+  EXPECT_TRUE(can_execute_concurrently("Relu", kOnnxDomain));
+  EXPECT_FALSE(can_execute_concurrently("RandomNormalLike", kOnnxDomain));
+  EXPECT_TRUE(can_execute_concurrently("Gelu", kMSDomain));
+  EXPECT_FALSE(can_execute_concurrently("Sampling", kMSDomain));
+  EXPECT_FALSE(can_execute_concurrently("BiasDropout", kMSDomain));
+  EXPECT_TRUE(can_execute_concurrently("ReorderInput", kMSNchwcDomain));
+  EXPECT_FALSE(can_execute_concurrently("CustomOp", "custom.domain"));
+}
+
+// the loop carried vars are updated in every iteration, so their buffers are handed back to the subgraph for the
+// outputs of later iterations. loop_var_1 grows in every iteration so its buffers can't be re-used.
+TEST(Loop, LoopCarriedVarBufferReuse) {
+  auto create_subgraph = []() {
+    Model model("Loop carried var buffer reuse subgraph", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    std::vector<NodeArg*> inputs;
+    std::vector<NodeArg*> outputs;
+
+    /* Inputs: iter_num, cond_in, loop carried state variables.
+
+         cond_in       loop_var_0_in              loop_var_1_in
+            |            |        |                     |
+       [Identity]     [Add]       |____________________[Concat]
+            |            |                              |
+        cond_out   loop_var_0_out                  loop_var_1_out
+                         |
+                     [Identity]
+                         |
+                     loop_out_0
+    */
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    TypeProto float_unknown_dim;
+    float_unknown_dim.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_unknown_dim.mutable_tensor_type()->mutable_shape()->add_dim();
+
+    // graph inputs
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& loop_var_0_in = graph.GetOrCreateNodeArg("loop_var_0_in", &float_tensor);
+    auto& loop_var_1_in = graph.GetOrCreateNodeArg("loop_var_1_in", &float_unknown_dim);
+
+    // graph outputs
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    auto& loop_var_0_out = graph.GetOrCreateNodeArg("loop_var_0_out", &float_tensor);
+    auto& loop_var_1_out = graph.GetOrCreateNodeArg("loop_var_1_out", &float_unknown_dim);
+    auto& loop_out_0 = graph.GetOrCreateNodeArg("loop_out_0", &float_tensor);
+
+    // cond_in -> cond_out
+    {
+      inputs = {&cond_in};
+      outputs = {&cond_out};
+
+      graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", inputs, outputs);
+    }
+
+    // loop_var_0_in + loop_var_0_in -> loop_var_0_out -> loop_out_0
+    {
+      inputs = {&loop_var_0_in, &loop_var_0_in};
+      outputs = {&loop_var_0_out};
+
+      graph.AddNode("add", "Add", "Double loop_var_0_in", inputs, outputs);
+
+      inputs = {&loop_var_0_out};
+      outputs = {&loop_out_0};
+
+      graph.AddNode("loop_out_identity", "Identity", "Forward loop_var_0_out to loop_out_0", inputs, outputs);
+    }
+
+    // concat(loop_var_1_in, loop_var_0_in) -> loop_var_1_out
+    {
+      inputs = {&loop_var_1_in, &loop_var_0_in};
+      outputs = {&loop_var_1_out};
+
+      auto& concat = graph.AddNode("concat", "Concat", "Append loop_var_0_in to loop_var_1_in", inputs, outputs);
+      concat.AddAttribute("axis", int64_t{0});
+    }
+
+    graph.SetInputs({&iter_num_in, &cond_in, &loop_var_0_in, &loop_var_1_in});
+    graph.SetOutputs({&cond_out, &loop_var_0_out, &loop_var_1_out, &loop_out_0});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  constexpr int64_t num_iterations = 8;
+
+  OpTester test("Loop", 11);
+  auto body = create_subgraph();
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {num_iterations});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("loop_var_0_orig", {2}, {1.f, -1.f});
+  test.AddInput<float>("loop_var_1_orig", {1}, {0.f});
+
+  std::vector<float> loop_var_1{0.f};
+  std::vector<float> loop_out_0;
+  float value = 1.f;
+  for (int64_t i = 0; i < num_iterations; ++i) {
+    loop_var_1.push_back(value);
+    loop_var_1.push_back(-value);
+    value *= 2.f;
+    loop_out_0.push_back(value);
+    loop_out_0.push_back(-value);
+  }
+
+  test.AddOutput<float>("loop_var_0_final", {2}, {value, -value});
+  test.AddOutput<float>("loop_var_1_final", {1 + 2 * num_iterations}, loop_var_1);
+  test.AddOutput<float>("loop_out_0_final", {num_iterations, 2}, loop_out_0);
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM)
 // test that when part of the subgraph run on CUDA/ROCm it executes successfully
 TEST(Loop, MixedExecutionProviders) {
@@ -5,6 +5,7 @@
 #include "gmock/gmock.h"
 #include "core/framework/session_state.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/providers/common.h"
 #include "core/providers/cpu/controlflow/scan_utils.h"
 #include "test/providers/provider_test_utils.h"
@@ -1101,6 +1102,79 @@ void MixedTypeInputs(bool is_v8) {
 
 TEST_8_AND_9(MixedTypeInputs);
 
+// the body passes the loop state variable through, so no value flows between the iterations and they can run
+// concurrently.
+static void IndependentIterations(bool disable_concurrent_iterations) {
+  // state_in => state_out
+  // state_in + scan_in => scan_out
+  Model model("ScanBody", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& state_in = graph.GetOrCreateNodeArg("state_in", &float_tensor);
+  auto& scan_in = graph.GetOrCreateNodeArg("scan_in", &float_tensor);
+
+  auto& state_out = graph.GetOrCreateNodeArg("state_out", &float_tensor);
+  auto& scan_out = graph.GetOrCreateNodeArg("scan_out", &float_tensor);
+
+  graph.AddNode("node1", "Identity", "Copy state_in to state_out", {&state_in}, {&state_out});
+  graph.AddNode("node2", "Add", "Add state_in to scan_in", {&state_in, &scan_in}, {&scan_out});
+
+  graph.SetInputs({&state_in, &scan_in});
+  graph.SetOutputs({&state_out, &scan_out});
+
+  auto status = graph.Resolve();
+  EXPECT_EQ(status, Status::OK());
+
+  auto& scan_body = graph.ToGraphProto();
+
+  constexpr int64_t sequence_len = 8, input_size = 2;
+  std::vector<float> scan_input;
+  std::vector<float> scan_output;
+  for (int64_t i = 0; i < sequence_len; ++i) {
+    for (int64_t j = 0; j < input_size; ++j) {
+      scan_input.push_back(static_cast<float>(i * input_size + j));
+    }
+  }
+
+  // the output is reversed so the iterations write to the slices in the opposite order
+  for (int64_t i = sequence_len - 1; i >= 0; --i) {
+    scan_output.push_back(static_cast<float>(i * input_size) + 10.f);
+    scan_output.push_back(static_cast<float>(i * input_size + 1) - 10.f);
+  }
+
+  ScanOpTester test{9};
+
+  test.AddAttribute("body", scan_body);
+  test.AddAttribute<int64_t>("num_scan_inputs", 1);
+  test.AddAttribute<std::vector<int64_t>>("scan_output_directions", {1});
+
+  test.AddInput<float>("initial_state", {input_size}, {10.f, -10.f});
+  test.AddInput<float>("scan_input", {sequence_len, input_size}, scan_input);
+
+  test.AddOutput<float>("final_state", {input_size}, {10.f, -10.f});
+  test.AddOutput<float>("scan_output", {sequence_len, input_size}, scan_output);
+
+  SessionOptions so;
+  if (disable_concurrent_iterations) {
+    ORT_THROW_IF_ERROR(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDisableConcurrentSubgraphIterations,
+                                                        "1"));
+  }
+
+  test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", RunOptions().excluded_provider_types);
+}
+
+TEST(Scan9, IndependentIterations) {
+  IndependentIterations(false);
+}
+
+TEST(Scan9, IndependentIterationsConcurrencyDisabled) {
+  IndependentIterations(true);
+}
+
 // create a subgraph that will have unknown dimensions in both the loop state variable and output
 // after shape inferencing.
 void UnknownDimInSubgraphOutput(bool is_v8, bool mixed_execution_providers = false) {
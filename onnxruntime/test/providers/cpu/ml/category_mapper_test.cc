@@ -43,5 +43,28 @@ TEST(CategoryMapper, IntToString) {
 
   RunTest(dims, input, output);
 }
+
+TEST(CategoryMapper, StringToIntRepeatedCategories) {
+  std::vector<int64_t> dims{1, 5};
+
+  std::vector<std::string> input{"One", "Two", "", "Three", "Four"};
+  // a repeated category maps to its last value
+  std::vector<int64_t> output{4, 2, 0, 99, 99};
+
+  OpTester test("CategoryMapper", 1, onnxruntime::kMLDomain);
+
+  const std::vector<std::string> categories{"One", "Two", "One", ""};
+  const std::vector<int64_t> indexes{1, 2, 4, 0};
+
+  test.AddAttribute("cats_strings", categories);
+  test.AddAttribute("cats_int64s", indexes);
+  test.AddAttribute("default_string", "default");
+  test.AddAttribute<int64_t>("default_int64", 99);
+
+  test.AddInput<std::string>("X", dims, input);
+  test.AddOutput<int64_t>("Y", dims, output);
+
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -64,6 +64,64 @@ TEST(LabelEncoder, StringToIntOpset2) {
   test.Run();
 }
 
+TEST(LabelEncoder, StringToIntRepeatedClasses) {
+  std::vector<int64_t> dims{1, 4};
+
+  std::vector<std::string> input{"Beer", "Wine", "", "Water"};
+  // a repeated class maps to its last index
+  std::vector<int64_t> output{2, 1, 3, 99};
+
+  OpTester test("LabelEncoder", 1, onnxruntime::kMLDomain);
+
+  const std::vector<std::string> labels{"Beer", "Wine", "Beer", ""};
+  test.AddAttribute("classes_strings", labels);
+  test.AddAttribute("default_string", "Water");
+  test.AddAttribute<int64_t>("default_int64", 99);
+
+  test.AddInput<std::string>("X", dims, input);
+  test.AddOutput<int64_t>("Y", dims, output);
+
+  test.Run();
+}
+
+TEST(LabelEncoder, StringToIntManyKeysOpset2) {
+  constexpr int64_t num_keys = 1000;
+  std::vector<std::string> keys;
+  std::vector<int64_t> values;
+  for (int64_t i = 0; i < num_keys; ++i) {
+    keys.push_back("key" + std::to_string(i));
+    values.push_back(i * 3);
+  }
+  // a repeated key maps to the value of its first occurrence
+  keys.push_back("key7");
+  values.push_back(-7);
+  keys.push_back("");
+  values.push_back(-1);
+
+  std::vector<std::string> input;
+  std::vector<int64_t> output;
+  for (int64_t i = 0; i < 2 * num_keys; ++i) {
+    input.push_back("key" + std::to_string(i));
+    output.push_back(i < num_keys ? i * 3 : 5566);
+  }
+  input.push_back("");
+  output.push_back(-1);
+  input.push_back("key");
+  output.push_back(5566);
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+
+  test.AddAttribute("keys_strings", keys);
+  test.AddAttribute("values_int64s", values);
+  test.AddAttribute("default_int64", (std::int64_t)5566);
+
+  const std::vector<int64_t> dims{static_cast<int64_t>(input.size())};
+  test.AddInput<std::string>("X", dims, input);
+  test.AddOutput<std::int64_t>("Y", dims, output);
+
+  test.Run();
+}
+
 TEST(LabelEncoder, IntToStringOpset2) {
   std::vector<std::int64_t> dims{1, 5};
 
@@ -3,6 +3,8 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/asserts.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 namespace test {
@@ -59,6 +61,85 @@ TEST(MLOpTest, TreeEnsembleClassifier) {
   TreeEnsembleClassifierTest(3);
 }
 
+// The rows of TreeEnsembleClassifierTest repeated to go past parallel_N with fewer trees than threads, so the rows are
+// evaluated by blocks against every tree (section E2). With mixed_modes, the first node is BRANCH_LT, which gives the
+// same results as no input is equal to its threshold, but disables QuickScorer.
+void TreeEnsembleClassifierRowBlocksTest(bool mixed_modes, int row_block, int num_threads) {
+  OpTester test("TreeEnsembleClassifier", 3, onnxruntime::kMLDomain);
+
+  std::vector<int64_t> lefts = {1, -1, 3, -1, -1, 1, -1, 3, 4, -1, -1, -1, 1, 2, -1, 4, -1, -1, -1};
+  std::vector<int64_t> rights = {2, -1, 4, -1, -1, 2, -1, 6, 5, -1, -1, -1, 6, 3, -1, 5, -1, -1, -1};
+  std::vector<int64_t> treeids = {0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2};
+  std::vector<int64_t> nodeids = {0, 1, 2, 3, 4, 0, 1, 2, 3, 4, 5, 6, 0, 1, 2, 3, 4, 5, 6};
+  std::vector<int64_t> featureids = {2, -2, 0, -2, -2, 0, -2, 2, 1, -2, -2, -2, 0, 2, -2, 1, -2, -2, -2};
+  std::vector<float> thresholds = {-172.f, -2.f, 2.5f, -2.f, -2.f, 1.5f, -2.f, -62.5f, 213.09999084f,
+                                   -2.f, -2.f, -2.f, 27.5f, -172.f, -2.f, 8.10000038f, -2.f, -2.f, -2.f};
+  std::vector<std::string> modes = {"BRANCH_LEQ", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF", "BRANCH_LEQ",
+                                    "LEAF", "BRANCH_LEQ", "BRANCH_LEQ", "LEAF", "LEAF", "LEAF",
+                                    "BRANCH_LEQ", "BRANCH_LEQ", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF", "LEAF"};
+  if (mixed_modes) {
+    modes[0] = "BRANCH_LT";
+  }
+  std::vector<int64_t> class_treeids = {0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2};
+  std::vector<int64_t> class_nodeids = {1, 3, 4, 1, 4, 5, 6, 2, 4, 5, 6};
+  std::vector<int64_t> class_classids = {2, 0, 1, 0, 2, 3, 1, 2, 0, 1, 3};
+  std::vector<float> class_weights = {1.f, 4.f, 1.f, 2.f, 1.f, 1.f, 2.f, 1.f, 1.f, 1.f, 3.f};
+  std::vector<int64_t> classes = {0, 1, 2, 3};
+  const std::vector<float> X_rows = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f, 11.3f, -222.f,
+                                     23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f, 11.3f, -222.f, 43.0f, 413.3f,
+                                     -114.f};
+  const std::vector<int64_t> results_rows = {0, 1, 2, 2, 2, 2, 2, 3};
+  const std::vector<float> scores_rows{7, 0, 0, 0, 0, 4, 0, 0, 0, 0, 3, 0, 0, 0, 3, 0,
+                                       0, 0, 3, 0, 0, 0, 2, 1, 0, 0, 3, 0, 0, 1, 0, 4};
+
+  constexpr int n_repeats = 9;
+  std::vector<float> X;
+  std::vector<int64_t> results;
+  std::vector<float> scores;
+  for (int i = 0; i < n_repeats; ++i) {
+    X.insert(X.end(), X_rows.begin(), X_rows.end());
+    results.insert(results.end(), results_rows.begin(), results_rows.end());
+    scores.insert(scores.end(), scores_rows.begin(), scores_rows.end());
+  }
+  const int64_t N = static_cast<int64_t>(results.size());
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("class_treeids", class_treeids);
+  test.AddAttribute("class_nodeids", class_nodeids);
+  test.AddAttribute("class_ids", class_classids);
+  test.AddAttribute("class_weights", class_weights);
+  test.AddAttribute("classlabels_int64s", classes);
+
+  test.AddInput<float>("X", {N, 3}, X);
+  test.AddOutput<int64_t>("Y", {N}, results);
+  test.AddOutput<float>("Z", {N, static_cast<int64_t>(classes.size())}, scores);
+
+  SessionOptions so;
+  if (row_block > 0) {
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsTreeEnsembleRowBlockSize,
+                                                      std::to_string(row_block).c_str()));
+  }
+  so.intra_op_param.thread_pool_size = num_threads;
+  test.Config(so);
+  test.Run();
+}
+
+TEST(MLOpTest, TreeEnsembleClassifierRowBlocks) {
+  for (bool mixed_modes : {true, false}) {
+    TreeEnsembleClassifierRowBlocksTest(mixed_modes, 0, 4);
+    TreeEnsembleClassifierRowBlocksTest(mixed_modes, 1, 4);
+    TreeEnsembleClassifierRowBlocksTest(mixed_modes, 5, 4);
+    // a single thread evaluates the rows in batches (section C2), the row block size is not used.
+    TreeEnsembleClassifierRowBlocksTest(mixed_modes, 5, 1);
+  }
+}
+
 TEST(MLOpTest, TreeEnsembleClassifier_as_tensor) {
   OpTester test("TreeEnsembleClassifier", 3, onnxruntime::kMLDomain);
 
@@ -3,6 +3,8 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/asserts.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 namespace test {
@@ -760,5 +762,120 @@ TEST(MLOpTest, TreeRegressorTrueNodeBeforeNode) {
   test.Run();
 }
 
+// Complete trees of the given depth: trees with up to 64 leaves use QuickScorer, deeper trees walk the nodes.
+// The expected values are computed by walking the trees. The rows are repeated n_repeats times to reach the
+// sections parallelizing by rows, row_block > 0 sets the number of rows evaluated together against a tree and
+// num_threads > 0 the size of the intra op thread pool.
+void GenCompleteTreesAndRunTest(const std::string& mode, int depth, int n_trees, int n_repeats = 1, int row_block = 0,
+                                int num_threads = 0) {
+  OpTester test("TreeEnsembleRegressor", 3, onnxruntime::kMLDomain);
+
+  const int64_t n_features = 3;
+  const int64_t n_internal = (int64_t(1) << depth) - 1;
+  const int64_t n_nodes = 2 * n_internal + 1;
+  std::vector<int64_t> nodes_treeids, nodes_nodeids, nodes_featureids, nodes_truenodeids, nodes_falsenodeids;
+  std::vector<float> nodes_values;
+  std::vector<std::string> nodes_modes;
+  std::vector<int64_t> target_treeids, target_nodeids, target_ids;
+  std::vector<float> target_weights;
+  for (int64_t t = 0; t < n_trees; ++t) {
+    for (int64_t n = 0; n < n_nodes; ++n) {
+      nodes_treeids.push_back(t);
+      nodes_nodeids.push_back(n);
+      if (n < n_internal) {
+        nodes_featureids.push_back((n + t) % n_features);
+        // a few thresholds are equal to the inputs to check the strict comparison
+        nodes_values.push_back(static_cast<float>((n * 7 + t * 3) % 11) - 5.f);
+        nodes_modes.push_back(mode);
+        nodes_truenodeids.push_back(2 * n + 1);
+        nodes_falsenodeids.push_back(2 * n + 2);
+      } else {
+        nodes_featureids.push_back(0);
+        nodes_values.push_back(0.f);
+        nodes_modes.push_back("LEAF");
+        nodes_truenodeids.push_back(0);
+        nodes_falsenodeids.push_back(0);
+        target_treeids.push_back(t);
+        target_nodeids.push_back(n);
+        target_ids.push_back(0);
+        target_weights.push_back(static_cast<float>((n - n_internal) * (t + 1)));
+      }
+    }
+  }
+
+  std::vector<float> X = {0.f, 1.f, -2.f,
+                          -5.f, 5.f, 3.f,
+                          std::numeric_limits<float>::quiet_NaN(), -1.f, 4.f,
+                          2.5f, -4.f, std::numeric_limits<float>::quiet_NaN()};
+  _multiply_update_array(X, n_repeats);
+  const int64_t n_rows = static_cast<int64_t>(X.size()) / n_features;
+  std::vector<float> Y;
+  for (int64_t i = 0; i < n_rows; ++i) {
+    float sum = 0.f;
+    for (int64_t t = 0; t < n_trees; ++t) {
+      int64_t n = 0;
+      while (n < n_internal) {
+        size_t k = static_cast<size_t>(t * n_nodes + n);
+        float val = X[static_cast<size_t>(i * n_features + nodes_featureids[k])];
+        bool cond = mode == "BRANCH_LT" ? val < nodes_values[k] : val <= nodes_values[k];
+        n = cond ? nodes_truenodeids[k] : nodes_falsenodeids[k];
+      }
+      sum += static_cast<float>((n - n_internal) * (t + 1));
+    }
+    Y.push_back(sum);
+  }
+
+  test.AddAttribute("nodes_truenodeids", nodes_truenodeids);
+  test.AddAttribute("nodes_falsenodeids", nodes_falsenodeids);
+  test.AddAttribute("nodes_treeids", nodes_treeids);
+  test.AddAttribute("nodes_nodeids", nodes_nodeids);
+  test.AddAttribute("nodes_featureids", nodes_featureids);
+  test.AddAttribute("nodes_values", nodes_values);
+  test.AddAttribute("nodes_modes", nodes_modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_ids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  test.AddInput<float>("X", {n_rows, n_features}, X);
+  test.AddOutput<float>("Y", {n_rows, 1}, Y);
+  if (row_block > 0 || num_threads > 0) {
+    SessionOptions so;
+    if (row_block > 0) {
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsTreeEnsembleRowBlockSize,
+                                                        std::to_string(row_block).c_str()));
+    }
+    so.intra_op_param.thread_pool_size = num_threads;
+    test.Config(so);
+  }
+  test.Run();
+}
+
+TEST(MLOpTest, TreeRegressorCompleteTreesLeq) {
+  GenCompleteTreesAndRunTest("BRANCH_LEQ", 3, 5);
+  GenCompleteTreesAndRunTest("BRANCH_LEQ", 6, 3);
+  GenCompleteTreesAndRunTest("BRANCH_LEQ", 7, 2);
+}
+
+TEST(MLOpTest, TreeRegressorCompleteTreesLt) {
+  GenCompleteTreesAndRunTest("BRANCH_LT", 3, 5);
+  GenCompleteTreesAndRunTest("BRANCH_LT", 6, 3);
+  GenCompleteTreesAndRunTest("BRANCH_LT", 7, 2);
+}
+
+TEST(MLOpTest, TreeRegressorCompleteTreesRowBlocks) {
+  // 128 leaves per tree and fewer trees than threads: the rows are evaluated by blocks against every tree
+  // (section E).
+  GenCompleteTreesAndRunTest("BRANCH_LEQ", 7, 1, 60, 0, 4);
+  GenCompleteTreesAndRunTest("BRANCH_LEQ", 7, 1, 60, 1, 4);
+  GenCompleteTreesAndRunTest("BRANCH_LEQ", 7, 1, 60, 7, 4);
+  GenCompleteTreesAndRunTest("BRANCH_LEQ", 7, 2, 60, 16, 4);
+  // QuickScorer evaluates all the trees for a row at once, the blocks only group the rows given to a thread.
+  GenCompleteTreesAndRunTest("BRANCH_LT", 6, 1, 60, 16, 4);
+  // a single thread evaluates the rows in batches (section C), the row block size is not used.
+  GenCompleteTreesAndRunTest("BRANCH_LEQ", 7, 1, 60, 7, 1);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
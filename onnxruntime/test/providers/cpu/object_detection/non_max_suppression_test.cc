@@ -1,6 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -383,5 +387,82 @@ TEST(NonMaxSuppressionOpTest, WithIOUThresholdOpset11) {
   test.Run();
 }
 
+// Enough batches, classes and boxes for the (batch, class) pairs to be suppressed on several threads.
+TEST(NonMaxSuppressionOpTest, ManyBatchesAndClasses) {
+  constexpr int64_t num_batches = 3;
+  constexpr int64_t num_classes = 8;
+  constexpr int64_t num_boxes = 200;
+  constexpr int64_t max_output_boxes_per_class = 20;
+  constexpr float iou_threshold = 0.4f;
+  constexpr float score_threshold = 0.1f;
+
+  // Overlapping boxes of a 20 x 10 grid, [y1, x1, y2, x2]
+  std::vector<float> boxes(num_batches * num_boxes * 4);
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    for (int64_t box = 0; box < num_boxes; ++box) {
+      float* coords = boxes.data() + (batch * num_boxes + box) * 4;
+      const float y = static_cast<float>(box / 20) * 0.5f + static_cast<float>(batch) * 0.1f;
+      const float x = static_cast<float>(box % 20) * 0.5f;
+      coords[0] = y;
+      coords[1] = x;
+      coords[2] = y + 1.0f + static_cast<float>(box % 3) * 0.25f;
+      coords[3] = x + 1.0f + static_cast<float>(box % 5) * 0.25f;
+    }
+  }
+
+  // Scores with ties, which are broken by the lower box index.
+  std::vector<float> scores(num_batches * num_classes * num_boxes);
+  for (size_t i = 0; i < scores.size(); ++i) {
+    scores[i] = static_cast<float>((i * 7919) % 97) / 97.0f;
+  }
+
+  auto iou = [](const float* a, const float* b) {
+    const float y_min = std::max(a[0], b[0]), x_min = std::max(a[1], b[1]);
+    const float y_max = std::min(a[2], b[2]), x_max = std::min(a[3], b[3]);
+    if (y_max <= y_min || x_max <= x_min) {
+      return 0.0f;
+    }
+    const float intersection = (y_max - y_min) * (x_max - x_min);
+    return intersection / ((a[2] - a[0]) * (a[3] - a[1]) + (b[2] - b[0]) * (b[3] - b[1]) - intersection);
+  };
+
+  // Greedy selection in descending score order.
+  std::vector<int64_t> expected;
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    for (int64_t cls = 0; cls < num_classes; ++cls) {
+      const float* class_scores = scores.data() + (batch * num_classes + cls) * num_boxes;
+      std::vector<int64_t> order(num_boxes);
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(),
+                       [&](int64_t a, int64_t b) { return class_scores[a] > class_scores[b]; });
+      std::vector<int64_t> selected;
+      for (int64_t box : order) {
+        if (static_cast<int64_t>(selected.size()) == max_output_boxes_per_class) {
+          break;
+        }
+        if (class_scores[box] <= score_threshold) {
+          continue;
+        }
+        const float* coords = boxes.data() + (batch * num_boxes + box) * 4;
+        if (std::none_of(selected.begin(), selected.end(), [&](int64_t other) {
+              return iou(coords, boxes.data() + (batch * num_boxes + other) * 4) > iou_threshold;
+            })) {
+          selected.push_back(box);
+          expected.insert(expected.end(), {batch, cls, box});
+        }
+      }
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {num_batches, num_boxes, 4}, boxes);
+  test.AddInput<float>("scores", {num_batches, num_classes, num_boxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {max_output_boxes_per_class});
+  test.AddInput<float>("iou_threshold", {}, {iou_threshold});
+  test.AddInput<float>("score_threshold", {}, {score_threshold});
+  test.AddOutput<int64_t>("selected_indices", {static_cast<int64_t>(expected.size() / 3), 3}, expected);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+#include <complex>
 #include <functional>
 #include <vector>
 
@@ -17,6 +19,7 @@ namespace test {
 
 static constexpr int kMinOpsetVersion = 17;
 static constexpr int kOpsetVersion20 = 20;
+static constexpr double kPi = 3.14159265358979323846;
 
 static void TestNaiveDFTFloat(bool onesided, int since_version) {
   OpTester test("DFT", since_version);
@@ -206,6 +209,140 @@ TEST(SignalOpsTest, DFT20_invertible_complex) {
   TestDFTInvertible(true, kOpsetVersion20);
 }
 
+// Naive DFT of the interleaved (real, imaginary) signals of a {batch, length, 2} tensor.
+static vector<float> NaiveDFT(const vector<float>& input, int64_t batch, int64_t length, int64_t output_length,
+                              bool inverse) {
+  const double sign = inverse ? 1.0 : -1.0;
+  vector<float> output(static_cast<size_t>(batch * output_length * 2));
+  for (int64_t b = 0; b < batch; b++) {
+    for (int64_t k = 0; k < output_length; k++) {
+      std::complex<double> sum = 0;
+      for (int64_t n = 0; n < length; n++) {
+        const size_t idx = static_cast<size_t>((b * length + n) * 2);
+        sum += std::complex<double>(input[idx], input[idx + 1]) *
+               std::polar(1.0, sign * 2.0 * kPi * static_cast<double>(n * k % length) / static_cast<double>(length));
+      }
+      if (inverse) {
+        sum /= static_cast<double>(length);
+      }
+      output[static_cast<size_t>((b * output_length + k) * 2)] = static_cast<float>(sum.real());
+      output[static_cast<size_t>((b * output_length + k) * 2 + 1)] = static_cast<float>(sum.imag());
+    }
+  }
+  return output;
+}
+
+// Lengths with the prime factors 2, 3 and 5 run the mixed radix FFT.
+static void TestMixedRadixDFTFloat(int64_t length, bool complex, bool onesided, bool inverse) {
+  RandomValueGenerator random(GetTestRandomSeed());
+  constexpr int64_t batch = 3;
+  vector<int64_t> input_shape{batch, length, complex ? 2 : 1};
+  vector<float> input = random.Uniform<float>(input_shape, -1.f, 1.f);
+  vector<float> complex_input(static_cast<size_t>(batch * length * 2), 0.f);
+  for (size_t i = 0; i < static_cast<size_t>(batch * length); i++) {
+    complex_input[i * 2] = complex ? input[i * 2] : input[i];
+    complex_input[i * 2 + 1] = complex ? input[i * 2 + 1] : 0.f;
+  }
+
+  const int64_t output_length = onesided ? (length >> 1) + 1 : length;
+  OpTester test("DFT", kOpsetVersion20);
+  test.AddInput<float>("input", input_shape, input);
+  test.AddInput<int64_t>("dft_length", {}, {length});
+  test.AddInput<int64_t>("axis", {}, {1});
+  test.AddAttribute<int64_t>("onesided", static_cast<int64_t>(onesided));
+  test.AddAttribute<int64_t>("inverse", static_cast<int64_t>(inverse));
+  test.AddOutput<float>("output", {batch, output_length, 2},
+                        NaiveDFT(complex_input, batch, length, output_length, inverse));
+  test.SetOutputAbsErr("output", 0.001f);
+  test.Run();
+}
+
+TEST(SignalOpsTest, DFT20_Float_mixed_radix) {
+  for (int64_t length : {6, 15, 60, 400, 480}) {
+    TestMixedRadixDFTFloat(length, false, false, false);
+    TestMixedRadixDFTFloat(length, false, true, false);
+    TestMixedRadixDFTFloat(length, true, false, false);
+    TestMixedRadixDFTFloat(length, true, false, true);
+  }
+}
+
+TEST(SignalOpsTest, STFTFloat_mixed_radix) {
+  constexpr int64_t signal_length = 1600;
+  constexpr int64_t frame_length = 400;
+  constexpr int64_t frame_step = 160;
+  constexpr int64_t n_frames = (signal_length - frame_length) / frame_step + 1;
+  constexpr int64_t output_length = frame_length / 2 + 1;
+
+  RandomValueGenerator random(GetTestRandomSeed());
+  vector<float> signal = random.Uniform<float>({1, signal_length, 1}, -1.f, 1.f);
+  vector<float> window(frame_length);
+  for (int64_t n = 0; n < frame_length; n++) {
+    window[n] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * kPi * n / frame_length));
+  }
+
+  vector<float> frames(static_cast<size_t>(n_frames * frame_length * 2), 0.f);
+  for (int64_t i = 0; i < n_frames; i++) {
+    for (int64_t n = 0; n < frame_length; n++) {
+      frames[static_cast<size_t>((i * frame_length + n) * 2)] = signal[i * frame_step + n] * window[n];
+    }
+  }
+
+  OpTester test("STFT", kMinOpsetVersion);
+  test.AddInput<float>("signal", {1, signal_length, 1}, signal);
+  test.AddInput<int64_t>("frame_step", {}, {frame_step});
+  test.AddInput<float>("window", {frame_length}, window);
+  test.AddInput<int64_t>("frame_length", {}, {frame_length});
+  test.AddOutput<float>("output", {1, n_frames, output_length, 2},
+                        NaiveDFT(frames, n_frames, frame_length, output_length, false));
+  test.SetOutputAbsErr("output", 0.001f);
+  test.Run();
+}
+
+// Complex signals are framed in samples of two components and windowed by a real window.
+static void TestComplexSTFTFloat(int64_t frame_length, int64_t frame_step) {
+  constexpr int64_t batch = 2;
+  constexpr int64_t signal_length = 40;
+  const int64_t n_frames = (signal_length - frame_length) / frame_step + 1;
+
+  RandomValueGenerator random(GetTestRandomSeed());
+  vector<float> signal = random.Uniform<float>({batch, signal_length, 2}, -1.f, 1.f);
+  vector<float> window(static_cast<size_t>(frame_length));
+  for (int64_t n = 0; n < frame_length; n++) {
+    window[n] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * kPi * n / frame_length));
+  }
+
+  vector<float> frames(static_cast<size_t>(batch * n_frames * frame_length * 2));
+  for (int64_t b = 0; b < batch; b++) {
+    for (int64_t i = 0; i < n_frames; i++) {
+      for (int64_t n = 0; n < frame_length; n++) {
+        const size_t src = static_cast<size_t>((b * signal_length + i * frame_step + n) * 2);
+        const size_t dst = static_cast<size_t>(((b * n_frames + i) * frame_length + n) * 2);
+        frames[dst] = signal[src] * window[n];
+        frames[dst + 1] = signal[src + 1] * window[n];
+      }
+    }
+  }
+
+  OpTester test("STFT", kMinOpsetVersion);
+  test.AddAttribute<int64_t>("onesided", 0);
+  test.AddInput<float>("signal", {batch, signal_length, 2}, signal);
+  test.AddInput<int64_t>("frame_step", {}, {frame_step});
+  test.AddInput<float>("window", {frame_length}, window);
+  test.AddInput<int64_t>("frame_length", {}, {frame_length});
+  test.AddOutput<float>("output", {batch, n_frames, frame_length, 2},
+                        NaiveDFT(frames, batch * n_frames, frame_length, frame_length, false));
+  test.SetOutputAbsErr("output", 0.001f);
+  test.Run();
+}
+
+TEST(SignalOpsTest, STFTFloat_complex) {
+  // 8 and 10 run the mixed radix FFT, 7 and 11 fall back to the Bluestein DFT.
+  TestComplexSTFTFloat(8, 4);
+  TestComplexSTFTFloat(10, 6);
+  TestComplexSTFTFloat(7, 3);
+  TestComplexSTFTFloat(11, 5);
+}
+
 TEST(SignalOpsTest, STFTFloat) {
   OpTester test("STFT", kMinOpsetVersion);
 
@@ -876,6 +876,418 @@ def gqa_past_func(
         return output, present_k, present_v
 
 
+def create_group_query_attention_graph_paged(
+    batch_size,
+    sequence_length,
+    num_heads,
+    kv_num_heads,
+    head_size,
+    num_blocks,
+    block_size,
+    max_blocks_per_sequence,
+    local_window_size=-1,
+    rotary=False,
+    rotary_interleaved=False,
+    packed=False,
+):
+    nodes = [
+        helper.make_node(
+            "GroupQueryAttention",
+            [
+                "query",
+                "key" if not packed else "",
+                "value" if not packed else "",
+                "past_key",
+                "past_value",
+                "seqlens_k",
+                "total_sequence_length",
+                "cos_cache" if rotary else "",
+                "sin_cache" if rotary else "",
+                "block_table",
+            ],
+            ["output", "present_key", "present_value"],
+            "GroupQueryAttention_0",
+            num_heads=num_heads,
+            kv_num_heads=kv_num_heads,
+            local_window_size=local_window_size,
+            do_rotary=rotary,
+            rotary_interleaved=rotary_interleaved,
+            domain="com.microsoft",
+        ),
+    ]
+
+    cache_shape = [num_blocks, kv_num_heads, block_size, head_size]
+    query_hidden_size = (num_heads + 2 * kv_num_heads) * head_size if packed else num_heads * head_size
+    graph_input = [
+        helper.make_tensor_value_info("query", TensorProto.FLOAT, [batch_size, sequence_length, query_hidden_size]),
+        helper.make_tensor_value_info("past_key", TensorProto.FLOAT, cache_shape),
+        helper.make_tensor_value_info("past_value", TensorProto.FLOAT, cache_shape),
+        helper.make_tensor_value_info("seqlens_k", TensorProto.INT32, [batch_size]),
+        helper.make_tensor_value_info("total_sequence_length", TensorProto.INT32, [1]),
+        helper.make_tensor_value_info("block_table", TensorProto.INT32, [batch_size, max_blocks_per_sequence]),
+    ]
+    if not packed:
+        graph_input += [
+            helper.make_tensor_value_info(
+                "key", TensorProto.FLOAT, [batch_size, sequence_length, kv_num_heads * head_size]
+            ),
+            helper.make_tensor_value_info(
+                "value", TensorProto.FLOAT, [batch_size, sequence_length, kv_num_heads * head_size]
+            ),
+        ]
+    if rotary:
+        graph_input += [
+            helper.make_tensor_value_info("cos_cache", TensorProto.FLOAT, ["max_position", head_size // 2]),
+            helper.make_tensor_value_info("sin_cache", TensorProto.FLOAT, ["max_position", head_size // 2]),
+        ]
+    graph_output = [
+        helper.make_tensor_value_info(
+            "output", TensorProto.FLOAT, [batch_size, sequence_length, num_heads * head_size]
+        ),
+        helper.make_tensor_value_info("present_key", TensorProto.FLOAT, cache_shape),
+        helper.make_tensor_value_info("present_value", TensorProto.FLOAT, cache_shape),
+    ]
+
+    graph = helper.make_graph(nodes, "GroupQueryAttention_Graph", graph_input, graph_output)
+    model = helper.make_model(graph)
+    return model.SerializeToString()
+
+
+def rotate_numpy(x, cos, sin, positions, interleaved):
+    # x: (S, N, H), cos and sin: (max_position, H / 2), positions: (S)
+    cos_x = cos[positions][:, None, :]
+    sin_x = sin[positions][:, None, :]
+    if interleaved:
+        x1 = x[..., 0::2]
+        x2 = x[..., 1::2]
+    else:
+        half = x.shape[-1] // 2
+        x1 = x[..., :half]
+        x2 = x[..., half:]
+    real = cos_x * x1 - sin_x * x2
+    imag = sin_x * x1 + cos_x * x2
+    out = numpy.empty_like(x)
+    if interleaved:
+        out[..., 0::2] = real
+        out[..., 1::2] = imag
+    else:
+        out = numpy.concatenate([real, imag], axis=-1)
+    return out
+
+
+def run_gqa_paged(
+    batch_size,
+    sequence_length,
+    num_heads,
+    kv_num_heads,
+    head_size,
+    block_size,
+    seqlens,
+    max_blocks_per_sequence,
+    rng,
+    local_window_size=-1,
+    rotary=False,
+    rotary_interleaved=False,
+    packed=False,
+):
+    # Each sequence gets its blocks from a shared pool in a shuffled order.
+    num_blocks = batch_size * max_blocks_per_sequence + 2
+    blocks = rng.permutation(num_blocks)[: batch_size * max_blocks_per_sequence]
+    block_table = blocks.reshape(batch_size, max_blocks_per_sequence).astype(numpy.int32)
+
+    q = rng.standard_normal((batch_size, sequence_length, num_heads, head_size)).astype(numpy.float32)
+    k = rng.standard_normal((batch_size, sequence_length, kv_num_heads, head_size)).astype(numpy.float32)
+    v = rng.standard_normal((batch_size, sequence_length, kv_num_heads, head_size)).astype(numpy.float32)
+    past_k = rng.standard_normal((num_blocks, kv_num_heads, block_size, head_size)).astype(numpy.float32)
+    past_v = rng.standard_normal((num_blocks, kv_num_heads, block_size, head_size)).astype(numpy.float32)
+    max_position = max_blocks_per_sequence * block_size
+    angle = rng.random((max_position, head_size // 2)) * 2 * math.pi
+    cos = numpy.cos(angle).astype(numpy.float32)
+    sin = numpy.sin(angle).astype(numpy.float32)
+
+    onnx_model_str = create_group_query_attention_graph_paged(
+        batch_size,
+        sequence_length,
+        num_heads,
+        kv_num_heads,
+        head_size,
+        num_blocks,
+        block_size,
+        max_blocks_per_sequence,
+        local_window_size=local_window_size,
+        rotary=rotary,
+        rotary_interleaved=rotary_interleaved,
+        packed=packed,
+    )
+    ort_session = InferenceSession(onnx_model_str, SessionOptions(), providers=["CPUExecutionProvider"])
+    ort_inputs = {
+        "past_key": past_k,
+        "past_value": past_v,
+        "seqlens_k": seqlens.astype(numpy.int32),
+        "total_sequence_length": numpy.array([int(seqlens.max()) + 1], dtype=numpy.int32),
+        "block_table": block_table,
+    }
+    if packed:
+        ort_inputs["query"] = numpy.concatenate(
+            [
+                q.reshape(batch_size, sequence_length, -1),
+                k.reshape(batch_size, sequence_length, -1),
+                v.reshape(batch_size, sequence_length, -1),
+            ],
+            axis=-1,
+        )
+    else:
+        ort_inputs["query"] = q.reshape(batch_size, sequence_length, -1)
+        ort_inputs["key"] = k.reshape(batch_size, sequence_length, -1)
+        ort_inputs["value"] = v.reshape(batch_size, sequence_length, -1)
+    if rotary:
+        ort_inputs["cos_cache"] = cos
+        ort_inputs["sin_cache"] = sin
+    out, present_k, present_v = ort_session.run(None, ort_inputs)
+
+    return q, k, v, past_k, past_v, cos, sin, block_table, out, present_k, present_v
+
+
+def parity_check_gqa_paged(
+    batch_size,
+    num_heads,
+    kv_num_heads,
+    head_size,
+    block_size,
+    sequence_length=1,
+    local_window_size=-1,
+    rotary=False,
+    rotary_interleaved=False,
+    packed=False,
+    rtol=1e-3,
+    atol=1e-3,
+):
+    # sequence_length 1 is token generation, where seqlens_k is the past length of each sequence. Otherwise it is
+    # a prompt padded to sequence_length, where seqlens_k + 1 is the number of tokens of each sequence.
+    rng = numpy.random.default_rng(batch_size * 1000 + block_size * 10 + sequence_length)
+    is_prompt = sequence_length > 1
+    if is_prompt:
+        seqlens = rng.integers(0, sequence_length, size=batch_size)
+        max_blocks_per_sequence = (sequence_length + block_size - 1) // block_size
+    else:
+        seqlens = rng.integers(1, 4 * block_size, size=batch_size)
+        max_blocks_per_sequence = int(seqlens.max()) // block_size + 1
+
+    q, k, v, past_k, past_v, cos, sin, block_table, out, present_k, present_v = run_gqa_paged(
+        batch_size,
+        sequence_length,
+        num_heads,
+        kv_num_heads,
+        head_size,
+        block_size,
+        seqlens,
+        max_blocks_per_sequence,
+        rng,
+        local_window_size=local_window_size,
+        rotary=rotary,
+        rotary_interleaved=rotary_interleaved,
+        packed=packed,
+    )
+    out = out.reshape(q.shape)
+
+    # Reference: gather the past of each sequence from its blocks, append the new tokens and attend causally.
+    # Only the outputs of the tokens of the sequences are compared, not those of the padding of a prompt.
+    group = num_heads // kv_num_heads
+    all_close = True
+    expected_k = past_k.copy()
+    expected_v = past_v.copy()
+    for b in range(batch_size):
+        past_seqlen = 0 if is_prompt else int(seqlens[b])
+        new_seqlen = int(seqlens[b]) + 1 if is_prompt else 1
+        total_seqlen = past_seqlen + new_seqlen
+        positions = numpy.arange(past_seqlen, total_seqlen)
+
+        q_b = q[b, :new_seqlen]
+        k_b = k[b, :new_seqlen]
+        if rotary:
+            q_b = rotate_numpy(q_b, cos, sin, positions, rotary_interleaved)
+            k_b = rotate_numpy(k_b, cos, sin, positions, rotary_interleaved)
+
+        past_tokens = numpy.arange(past_seqlen)
+        past_blocks = block_table[b, past_tokens // block_size]
+        keys = numpy.concatenate([past_k[past_blocks, :, past_tokens % block_size, :], k_b], axis=0)
+        values = numpy.concatenate([past_v[past_blocks, :, past_tokens % block_size, :], v[b, :new_seqlen]], axis=0)
+
+        out_ref = numpy.zeros((new_seqlen, num_heads, head_size), dtype=numpy.float32)
+        for s in range(new_seqlen):
+            position = past_seqlen + s
+            first = 0 if local_window_size < 0 else max(0, position - local_window_size)
+            for n in range(num_heads):
+                scores = keys[first : position + 1, n // group, :] @ q_b[s, n] / math.sqrt(head_size)
+                probs = numpy.exp(scores - scores.max())
+                probs /= probs.sum()
+                out_ref[s, n] = probs @ values[first : position + 1, n // group, :]
+        all_close = all_close and numpy.allclose(out[b, :new_seqlen], out_ref, rtol=rtol, atol=atol, equal_nan=True)
+
+        # The new tokens are written to their slots of the cache and the other slots are unchanged.
+        new_blocks = block_table[b, positions // block_size]
+        expected_k[new_blocks, :, positions % block_size, :] = k_b
+        expected_v[new_blocks, :, positions % block_size, :] = v[b, :new_seqlen]
+
+    all_close = (
+        all_close
+        and numpy.allclose(present_k, expected_k, rtol=rtol, atol=atol)
+        and numpy.array_equal(present_v, expected_v)
+    )
+    correct = GREEN + "True" + RESET if all_close else RED + "False" + RESET
+    print(
+        "KV-buffer",
+        " paged ",
+        " B:",
+        batch_size,
+        " S:",
+        sequence_length,
+        " N:",
+        num_heads,
+        " kvN:",
+        kv_num_heads,
+        " h:",
+        head_size,
+        " block_size:",
+        block_size,
+        " local_window_size:",
+        local_window_size,
+        " rotary:",
+        rotary,
+        " rotary_interleaved:",
+        rotary_interleaved,
+        " packed:",
+        packed,
+        correct,
+    )
+    return all_close
+
+
+def create_group_query_attention_graph_int8_kv_cache(
+    batch_size, num_heads, kv_num_heads, head_size, past_seqlen, cache_type=TensorProto.INT8
+):
+    nodes = [
+        helper.make_node(
+            "GroupQueryAttention",
+            [
+                "query",
+                "key",
+                "value",
+                "past_key",
+                "past_value",
+                "seqlens_k",
+                "total_sequence_length",
+                "",
+                "",
+                "",
+                "k_scale",
+                "v_scale",
+            ],
+            ["output", "present_key", "present_value"],
+            "GroupQueryAttention_0",
+            num_heads=num_heads,
+            kv_num_heads=kv_num_heads,
+            domain="com.microsoft",
+        ),
+    ]
+
+    graph_input = [
+        helper.make_tensor_value_info("query", TensorProto.FLOAT, [batch_size, 1, num_heads * head_size]),
+        helper.make_tensor_value_info("key", TensorProto.FLOAT, [batch_size, 1, kv_num_heads * head_size]),
+        helper.make_tensor_value_info("value", TensorProto.FLOAT, [batch_size, 1, kv_num_heads * head_size]),
+        helper.make_tensor_value_info("past_key", cache_type, [batch_size, kv_num_heads, past_seqlen, head_size]),
+        helper.make_tensor_value_info("past_value", cache_type, [batch_size, kv_num_heads, past_seqlen, head_size]),
+        helper.make_tensor_value_info("seqlens_k", TensorProto.INT32, [batch_size]),
+        helper.make_tensor_value_info("total_sequence_length", TensorProto.INT32, [1]),
+        helper.make_tensor_value_info("k_scale", TensorProto.FLOAT, [kv_num_heads]),
+        helper.make_tensor_value_info("v_scale", TensorProto.FLOAT, [kv_num_heads]),
+    ]
+    present_shape = [batch_size, kv_num_heads, past_seqlen + 1, head_size]
+    graph_output = [
+        helper.make_tensor_value_info("output", TensorProto.FLOAT, [batch_size, 1, num_heads * head_size]),
+        helper.make_tensor_value_info("present_key", cache_type, present_shape),
+        helper.make_tensor_value_info("present_value", cache_type, present_shape),
+    ]
+
+    graph = helper.make_graph(nodes, "GroupQueryAttention_Graph", graph_input, graph_output)
+    model = helper.make_model(graph)
+    return model.SerializeToString()
+
+
+def parity_check_gqa_int8_kv_cache(batch_size, num_heads, kv_num_heads, head_size, past_seqlen, rtol=1e-3, atol=1e-3):
+    rng = numpy.random.default_rng(batch_size * 1000 + past_seqlen)
+    k_scale = rng.uniform(0.01, 0.05, size=kv_num_heads).astype(numpy.float32)
+    v_scale = rng.uniform(0.01, 0.05, size=kv_num_heads).astype(numpy.float32)
+
+    q = rng.standard_normal((batch_size, 1, num_heads, head_size)).astype(numpy.float32)
+    k = rng.standard_normal((batch_size, 1, kv_num_heads, head_size)).astype(numpy.float32)
+    v = rng.standard_normal((batch_size, 1, kv_num_heads, head_size)).astype(numpy.float32)
+    past_shape = (batch_size, kv_num_heads, past_seqlen, head_size)
+    past_k = rng.integers(-128, 128, size=past_shape).astype(numpy.int8)
+    past_v = rng.integers(-128, 128, size=past_shape).astype(numpy.int8)
+
+    # The new token is quantized with the scale of its kv head (round to nearest even, zero point 0).
+    def quantize(x, scale):
+        return numpy.clip(numpy.rint(x / scale[:, None]), -128, 127).astype(numpy.int8)
+
+    expected_k = numpy.concatenate([past_k, quantize(k[:, 0], k_scale)[:, :, None, :]], axis=2)
+    expected_v = numpy.concatenate([past_v, quantize(v[:, 0], v_scale)[:, :, None, :]], axis=2)
+
+    # Reference: attention over the dequantized cache.
+    keys = expected_k.astype(numpy.float32) * k_scale[None, :, None, None]
+    values = expected_v.astype(numpy.float32) * v_scale[None, :, None, None]
+    group = num_heads // kv_num_heads
+    out_ref = numpy.zeros((batch_size, 1, num_heads, head_size), dtype=numpy.float32)
+    for b in range(batch_size):
+        for n in range(num_heads):
+            scores = keys[b, n // group] @ q[b, 0, n] / math.sqrt(head_size)
+            probs = numpy.exp(scores - scores.max())
+            probs /= probs.sum()
+            out_ref[b, 0, n] = probs @ values[b, n // group]
+
+    onnx_model_str = create_group_query_attention_graph_int8_kv_cache(
+        batch_size, num_heads, kv_num_heads, head_size, past_seqlen
+    )
+    ort_session = InferenceSession(onnx_model_str, SessionOptions(), providers=["CPUExecutionProvider"])
+    ort_inputs = {
+        "query": q.reshape(batch_size, 1, -1),
+        "key": k.reshape(batch_size, 1, -1),
+        "value": v.reshape(batch_size, 1, -1),
+        "past_key": past_k,
+        "past_value": past_v,
+        "seqlens_k": numpy.full(batch_size, past_seqlen, dtype=numpy.int32),
+        "total_sequence_length": numpy.array([past_seqlen + 1], dtype=numpy.int32),
+        "k_scale": k_scale,
+        "v_scale": v_scale,
+    }
+    out, present_k, present_v = ort_session.run(None, ort_inputs)
+
+    all_close = (
+        numpy.allclose(out.reshape(out_ref.shape), out_ref, rtol=rtol, atol=atol, equal_nan=True)
+        and numpy.array_equal(present_k, expected_k)
+        and numpy.array_equal(present_v, expected_v)
+    )
+    correct = GREEN + "True" + RESET if all_close else RED + "False" + RESET
+    print(
+        "No buff",
+        " int8 kv cache ",
+        " B:",
+        batch_size,
+        " N:",
+        num_heads,
+        " kvN:",
+        kv_num_heads,
+        " h:",
+        head_size,
+        " past_seqlen:",
+        past_seqlen,
+        " Mean Error:",
+        numpy.mean(numpy.abs(out.reshape(out_ref.shape) - out_ref)),
+        correct,
+    )
+    return all_close
+
+
 def construct_causal_mask(seqlen_q, seqlen_k, query_padding_mask=None, key_padding_mask=None, device=None):
     row_idx = rearrange(torch.arange(seqlen_q, device=device, dtype=torch.long), "s -> s 1")
     col_idx = torch.arange(seqlen_k, device=device, dtype=torch.long)
@@ -1864,6 +2276,67 @@ class TestGQA(unittest.TestCase):
                                     )
                                     self.assertTrue(all_close)
 
+    def test_gqa_paged_kv_cache(self):
+        print("-------- TEST GQA PAGED KV CACHE (TOKEN GEN) ---------")
+        for b in [1, 3]:
+            for n, n2 in [(8, 2), (4, 4)]:
+                for h in [16, 64]:
+                    for block_size in [1, 16]:
+                        all_close = parity_check_gqa_paged(b, n, n2, h, block_size)
+                        self.assertTrue(all_close)
+
+    def test_gqa_paged_kv_cache_prompt(self):
+        print("-------- TEST GQA PAGED KV CACHE (PROMPT) ---------")
+        # the prompts are padded to the sequence length, and seqlens_k gives their lengths
+        for b in [1, 3]:
+            for s in [2, 17, 40]:
+                for block_size in [1, 16]:
+                    all_close = parity_check_gqa_paged(b, 8, 2, 16, block_size, sequence_length=s)
+                    self.assertTrue(all_close)
+
+    def test_gqa_paged_kv_cache_options(self):
+        print("-------- TEST GQA PAGED KV CACHE (PACKED, ROTARY, LOCAL) ---------")
+        for s in [1, 17]:
+            for local in [-1, 5]:
+                for rotary, rotary_interleaved in [(False, False), (True, False), (True, True)]:
+                    for packed in [False, True]:
+                        all_close = parity_check_gqa_paged(
+                            3,
+                            8,
+                            2,
+                            16,
+                            4,
+                            sequence_length=s,
+                            local_window_size=local,
+                            rotary=rotary,
+                            rotary_interleaved=rotary_interleaved,
+                            packed=packed,
+                        )
+                        self.assertTrue(all_close)
+
+    def test_gqa_paged_kv_cache_too_few_blocks(self):
+        # A prompt padded past the blocks of a sequence is rejected, even when its tokens fit in the blocks.
+        rng = numpy.random.default_rng(0)
+        with self.assertRaises(Exception):
+            run_gqa_paged(1, 8, 2, 2, 16, 4, numpy.array([1]), 1, rng)
+
+    def test_gqa_int8_kv_cache(self):
+        print("-------- TEST GQA INT8 KV CACHE (TOKEN GEN) ---------")
+        for b in [1, 3]:
+            for n, n2 in [(8, 2), (4, 4)]:
+                for h in [16, 64]:
+                    for past_seqlen in [1, 37]:
+                        all_close = parity_check_gqa_int8_kv_cache(b, n, n2, h, past_seqlen)
+                        self.assertTrue(all_close)
+
+    def test_gqa_kv_cache_type_mismatch(self):
+        # The cache is of the type of query or int8, there is no kernel for a float16 cache with a float query.
+        onnx_model_str = create_group_query_attention_graph_int8_kv_cache(
+            1, 4, 2, 16, 4, cache_type=TensorProto.FLOAT16
+        )
+        with self.assertRaises(Exception):
+            InferenceSession(onnx_model_str, SessionOptions(), providers=["CPUExecutionProvider"])
+
 
 if __name__ == "__main__":
     unittest.main()